@@ -161,6 +161,7 @@ DEFINE_SAFE_EQUALITY(DebugMessage)
 DEFINE_SAFE_EQUALITY(EnvironmentModification)
 DEFINE_SAFE_EQUALITY(EventUsage)
 DEFINE_SAFE_EQUALITY(PathEntry)
+DEFINE_SAFE_EQUALITY(PixelDebugSummary)
 DEFINE_SAFE_EQUALITY(PixelModification)
 DEFINE_SAFE_EQUALITY(ResourceDescription)
 DEFINE_SAFE_EQUALITY(ResourceId)
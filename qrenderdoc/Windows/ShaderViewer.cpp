@@ -1842,40 +1842,37 @@ void ShaderViewer::runTo(QVector<size_t> runToInstruction, bool forward, ShaderE
   if(!m_Trace || m_States.empty())
     return;
 
+  // find the state to stop at first, then seek straight to it rather than applying every change
+  // along the way
+  size_t target = m_CurrentStateIdx;
   bool firstStep = true;
 
-  // this is effectively infinite as we break out before moving to next/previous state if that would
-  // be first/last
-  while((forward && !IsLastState()) || (!forward && !IsFirstState()))
+  while((forward && target + 1 < m_States.size()) || (!forward && target > 0))
   {
+    const ShaderDebugState &state = m_States[target];
+
     // break immediately even on the very first step if it's the one we want to go to
-    if(runToInstruction.contains(GetCurrentState().nextInstruction))
+    if(runToInstruction.contains(state.nextInstruction))
       break;
 
     // after the first step, break on condition
-    if(!firstStep && (GetCurrentState().flags & condition))
+    if(!firstStep && (state.flags & condition))
       break;
 
     // or breakpoint
-    if(!firstStep && m_Breakpoints.contains((int)GetCurrentState().nextInstruction))
+    if(!firstStep && m_Breakpoints.contains((int)state.nextInstruction))
       break;
 
     firstStep = false;
 
     if(forward)
-    {
-      if(IsLastState())
-        break;
-      applyForwardsChange();
-    }
+      target++;
     else
-    {
-      if(IsFirstState())
-        break;
-      applyBackwardsChange();
-    }
+      target--;
   }
 
+  seekToState(target);
+
   updateDebugState();
 }
 
@@ -1884,26 +1881,20 @@ void ShaderViewer::runToResourceAccess(bool forward, VarType type, const Bindpoi
   if(!m_Trace || m_States.empty())
     return;
 
-  // this is effectively infinite as we break out before moving to next/previous state if that would
-  // be first/last
-  while((forward && !IsLastState()) || (!forward && !IsFirstState()))
+  size_t target = m_CurrentStateIdx;
+
+  while((forward && target + 1 < m_States.size()) || (!forward && target > 0))
   {
     if(forward)
-    {
-      if(IsLastState())
-        break;
-      applyForwardsChange();
-    }
+      target++;
     else
-    {
-      if(IsFirstState())
-        break;
-      applyBackwardsChange();
-    }
+      target--;
+
+    const ShaderDebugState &state = m_States[target];
 
-    // Break if the current state references the specific resource requested
+    // Break if the state references the specific resource requested
     bool foundResource = false;
-    for(const ShaderVariableChange &c : GetCurrentState().changes)
+    for(const ShaderVariableChange &c : state.changes)
     {
       if(c.after.type == type && c.after.GetBinding() == resource)
       {
@@ -1916,13 +1907,46 @@ void ShaderViewer::runToResourceAccess(bool forward, VarType type, const Bindpoi
       break;
 
     // or breakpoint
-    if(m_Breakpoints.contains((int)GetCurrentState().nextInstruction))
+    if(m_Breakpoints.contains((int)state.nextInstruction))
       break;
   }
 
+  seekToState(target);
+
   updateDebugState();
 }
 
+void ShaderViewer::seekToState(size_t idx)
+{
+  if(m_States.empty())
+    return;
+
+  idx = qMin(idx, m_States.size() - 1);
+
+  size_t curDist = idx > m_CurrentStateIdx ? idx - m_CurrentStateIdx : m_CurrentStateIdx - idx;
+
+  // for long seeks, fetch the variables from the replay's snapshots instead of applying every
+  // change in between.
+  if(curDist > MAX_LOCAL_SEEK)
+  {
+    rdcarray<ShaderVariable> vars;
+
+    m_Ctx.Replay().BlockInvoke([this, idx, &vars](IReplayController *r) {
+      vars = r->GetDebugVariablesAt(m_Trace->debugger, (uint32_t)idx);
+    });
+
+    m_Variables = vars;
+    m_CurrentStateIdx = idx;
+
+    recordAccessedResources();
+  }
+
+  while(m_CurrentStateIdx < idx)
+    applyForwardsChange();
+  while(m_CurrentStateIdx > idx)
+    applyBackwardsChange();
+}
+
 void ShaderViewer::applyBackwardsChange()
 {
   if(!IsFirstState())
@@ -1976,7 +2000,6 @@ void ShaderViewer::applyForwardsChange()
     m_CurrentStateIdx++;
 
     rdcarray<ShaderVariable> newVariables;
-    rdcarray<AccessedResourceData> newAccessedResources;
 
     for(const ShaderVariableChange &c : GetCurrentState().changes)
     {
@@ -2009,28 +2032,46 @@ void ShaderViewer::applyForwardsChange()
           *v = c.after;
         else
           newVariables.push_back(c.after);
+      }
+    }
 
-        if(c.after.type == VarType::ReadOnlyResource || c.after.type == VarType::ReadWriteResource)
+    m_Variables.insert(0, newVariables);
+
+    recordAccessedResources();
+  }
+}
+
+void ShaderViewer::recordAccessedResources()
+{
+  // seeks can jump past states without applying them, so resource accesses are recorded for every
+  // state up to the current one that hasn't been recorded yet.
+  while(m_AccessedResourcesStateIdx < m_CurrentStateIdx)
+  {
+    size_t step = ++m_AccessedResourcesStateIdx;
+
+    rdcarray<AccessedResourceData> newAccessedResources;
+
+    for(const ShaderVariableChange &c : m_States[step].changes)
+    {
+      if(c.after.type == VarType::ReadOnlyResource || c.after.type == VarType::ReadWriteResource)
+      {
+        bool found = false;
+        for(size_t i = 0; i < m_AccessedResources.size(); i++)
         {
-          bool found = false;
-          for(size_t i = 0; i < m_AccessedResources.size(); i++)
+          if(c.after.GetBinding() == m_AccessedResources[i].resource.GetBinding())
           {
-            if(c.after.GetBinding() == m_AccessedResources[i].resource.GetBinding())
-            {
-              found = true;
-              if(m_AccessedResources[i].steps.indexOf(m_CurrentStateIdx) < 0)
-                m_AccessedResources[i].steps.push_back(m_CurrentStateIdx);
-              break;
-            }
+            found = true;
+            if(m_AccessedResources[i].steps.indexOf(step) < 0)
+              m_AccessedResources[i].steps.push_back(step);
+            break;
           }
-
-          if(!found)
-            newAccessedResources.push_back({c.after, {m_CurrentStateIdx}});
         }
+
+        if(!found)
+          newAccessedResources.push_back({c.after, {step}});
       }
     }
 
-    m_Variables.insert(0, newVariables);
     m_AccessedResources.insert(0, newAccessedResources);
   }
 }
@@ -3894,25 +3935,13 @@ void ShaderViewer::SetCurrentStep(uint32_t step)
   if(!m_Trace || m_States.empty())
     return;
 
-  while(GetCurrentState().stepIndex != step)
-  {
-    if(GetCurrentState().stepIndex < step)
-    {
-      // move forward if possible
-      if(!IsLastState())
-        applyForwardsChange();
-      else
-        break;
-    }
-    else
-    {
-      // move backward if possible
-      if(!IsFirstState())
-        applyBackwardsChange();
-      else
-        break;
-    }
-  }
+  // states are in step order, so find the first state at or after the step and seek to it from the
+  // nearest keyframe rather than stepping there one state at a time.
+  auto it = std::lower_bound(
+      m_States.begin(), m_States.end(), step,
+      [](const ShaderDebugState &state, uint32_t s) { return state.stepIndex < s; });
+
+  seekToState(size_t(it - m_States.begin()));
 
   updateDebugState();
 }
@@ -272,9 +272,15 @@ private:
   size_t m_CurrentStateIdx = 0;
   rdcarray<ShaderVariable> m_Variables;
 
+  // seeks further than this many states fetch the variables from the replay instead of applying
+  // each change
+  static const size_t MAX_LOCAL_SEEK = 256;
+
   QSemaphore m_BackgroundRunning;
 
   rdcarray<AccessedResourceData> m_AccessedResources;
+  // the last state whose resource accesses have been recorded in m_AccessedResources
+  size_t m_AccessedResourcesStateIdx = 0;
   AccessedResourceView m_AccessedResourceView = AccessedResourceView::SortByResource;
 
   rdcarray<BoundResourceArray> m_ReadOnlyResources;
@@ -340,6 +346,8 @@ private:
 
   void applyBackwardsChange();
   void applyForwardsChange();
+  void seekToState(size_t idx);
+  void recordAccessedResources();
 
   QString stringRep(const ShaderVariable &var, uint32_t row = 0);
   QString samplerRep(Bindpoint bind, uint32_t arrayIndex, ResourceId id);
@@ -204,6 +204,19 @@ Default - enabled
 ``False`` - API debugging is displayed as normal.
 )");
   bool debugOutputMute;
+
+  DOCUMENT(R"(Specify a soft limit in megabytes on the size of the capture file.
+
+If the initial contents of resources would push the capture over this limit, the largest
+resources have their contents dropped, largest first, until the capture fits. Those resources
+are still created on replay but their contents before the first write in the frame are
+undefined, and a warning listing them is added to the capture's debug messages.
+
+``0`` indicates no limit.
+
+Default - 0 (no limit)
+)");
+  uint32_t captureSizeBudgetMB;
 };
 
 DECLARE_REFLECTION_STRUCT(CaptureOptions);
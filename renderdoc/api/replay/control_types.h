@@ -460,6 +460,75 @@ It is an :class:`AlphaMapping` that controls what behaviour to use.
 
 DECLARE_REFLECTION_STRUCT(TextureSave);
 
+DOCUMENT(R"(The results of comparing two textures, as returned from
+:meth:`ReplayController.CompareTextures` and :func:`CompareTextureData`.
+
+Both textures are decoded to floats and compared channel by channel, with each metric returned as
+a :class:`FloatVector` holding the result for the red, green, blue and alpha channels. Channels
+that aren't present in a texture's format compare as 0 for colour and 1 for alpha.
+
+NaNs in either texture don't affect the maximum errors, but do make the sums and so the mean
+errors, PSNR and SSIM for that channel NaN.
+)");
+struct TextureComparison
+{
+  DOCUMENT("");
+  TextureComparison() = default;
+  TextureComparison(const TextureComparison &) = default;
+  TextureComparison &operator=(const TextureComparison &) = default;
+
+  DOCUMENT(R"(``True`` if the textures could be compared. If this is ``False`` the other results are
+empty.
+)");
+  bool valid = false;
+
+  DOCUMENT("The width of the textures that were compared.");
+  uint32_t width = 0;
+
+  DOCUMENT("The height of the textures that were compared.");
+  uint32_t height = 0;
+
+  DOCUMENT("The depth of the textures that were compared.");
+  uint32_t depth = 0;
+
+  DOCUMENT(R"(The number of texels where any channel's absolute error is above the threshold, or
+is NaN.
+)");
+  uint64_t differingTexels = 0;
+
+  DOCUMENT("The largest absolute difference between texels.");
+  FloatVector maxAbsError;
+
+  DOCUMENT("The mean absolute difference between texels.");
+  FloatVector meanAbsError;
+
+  DOCUMENT(R"(The largest relative difference between texels, as the absolute difference divided by
+the larger of the absolute values. Texels where both values are 0 aren't included.
+)");
+  FloatVector maxRelError;
+
+  DOCUMENT("The mean of the squared differences between texels.");
+  FloatVector meanSquaredError;
+
+  DOCUMENT(R"(The peak signal-to-noise ratio in decibels, for a peak value of 1.0. This is
+infinite if the channel is identical in both textures.
+)");
+  FloatVector psnr;
+
+  DOCUMENT(R"(The structural similarity index, averaged over 8x8 texel windows within each slice.
+This uses the standard constants for a dynamic range of 1.0, so it is most meaningful for
+normalised data. 1.0 means the channel is identical in both textures.
+)");
+  FloatVector ssim;
+
+  DOCUMENT(R"(If requested, the absolute difference for each texel as tightly packed RGBA32 float
+data. Otherwise this is empty.
+)");
+  bytebuf diffImage;
+};
+
+DECLARE_REFLECTION_STRUCT(TextureComparison);
+
 // dependent structs for TargetControlMessage
 DOCUMENT("Information about the a new capture created by the target.");
 struct NewCaptureData
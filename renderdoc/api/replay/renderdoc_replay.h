@@ -538,6 +538,40 @@ or hardware-specific ISA formats.
   virtual rdcstr DisassembleShader(ResourceId pipeline, const ShaderReflection *refl,
                                    const char *target) = 0;
 
+  DOCUMENT(R"(Retrieve the number of lines in the disassembly for a given shader, for the given
+disassembly target.
+
+Disassembly is generated once for each combination of shader, pipeline and target and then cached,
+so this can be used together with :meth:`DisassembleShaderLines` to display very large shaders
+progressively without generating the disassembly more than once.
+
+:param ResourceId pipeline: The pipeline state object, if applicable, that this shader is bound to.
+:param ShaderReflection refl: The shader reflection details of the shader to disassemble
+:param str target: The name of the disassembly target to generate for. Must be one of the values
+  returned by :meth:`GetDisassemblyTargets`, or empty to use the default generation.
+:return: The number of lines in the disassembly.
+:rtype: ``int``
+)");
+  virtual uint32_t GetDisassemblyLineCount(ResourceId pipeline, const ShaderReflection *refl,
+                                           const char *target) = 0;
+
+  DOCUMENT(R"(Retrieve a range of lines from the disassembly for a given shader, for the given
+disassembly target. See :meth:`GetDisassemblyLineCount`.
+
+:param ResourceId pipeline: The pipeline state object, if applicable, that this shader is bound to.
+:param ShaderReflection refl: The shader reflection details of the shader to disassemble
+:param str target: The name of the disassembly target to generate for. Must be one of the values
+  returned by :meth:`GetDisassemblyTargets`, or empty to use the default generation.
+:param int firstLine: The first line to return, counting from 0.
+:param int numLines: The number of lines to return. Any lines past the end of the disassembly are
+  ignored.
+:return: The requested lines of disassembly, including each line's trailing newline.
+:rtype: ``str``
+)");
+  virtual rdcstr DisassembleShaderLines(ResourceId pipeline, const ShaderReflection *refl,
+                                        const char *target, uint32_t firstLine,
+                                        uint32_t numLines) = 0;
+
   DOCUMENT(R"(Builds a shader suitable for running on the local replay instance as a custom shader.
 
 See :data:`TextureDisplay.customShaderId`.
@@ -807,6 +841,36 @@ bucket when the pixel values are divided between ``minval`` and ``maxval``.
                                           CompType typeCast, float minval, float maxval,
                                           bool channels[4]) = 0;
 
+  DOCUMENT(R"(Compare one subresource of a texture at one event against a subresource of a texture
+at another event, returning per-channel error metrics and optionally a difference image.
+
+The textures can be in different formats, but must have the same dimensions at the selected mips.
+For 3D textures the whole mip is compared. The comparison is done on the CPU using multiple
+threads. The current event is restored afterwards.
+
+To compare textures in different captures, fetch each with :meth:`GetTextureData` and compare them
+with :func:`CompareTextureData`.
+
+:param int eventA: The event to fetch the first texture at.
+:param ResourceId texA: The first texture to compare.
+:param Subresource subA: The subresource within the first texture to compare.
+:param int eventB: The event to fetch the second texture at.
+:param ResourceId texB: The second texture to compare.
+:param Subresource subB: The subresource within the second texture to compare.
+:param CompType typeCast: If possible interpret both textures with this type instead of their
+  normal type. If set to :data:`CompType.Typeless` then no cast is applied, otherwise where allowed
+  the texture data will be reinterpreted - e.g. from unsigned integers to floats, or to unsigned
+  normalised values.
+:param float threshold: The absolute error above which a texel counts as differing.
+:param bool diffImage: ``True`` if the difference image should be returned.
+:return: The results of the comparison.
+:rtype: TextureComparison
+)");
+  virtual TextureComparison CompareTextures(uint32_t eventA, ResourceId texA,
+                                            const Subresource &subA, uint32_t eventB,
+                                            ResourceId texB, const Subresource &subB,
+                                            CompType typeCast, float threshold, bool diffImage) = 0;
+
   DOCUMENT(R"(Retrieve the history of modifications to the selected pixel on the selected texture.
 
 .. note::
@@ -864,6 +928,32 @@ bucket when the pixel values are divided between ``minval`` and ``maxval``.
   virtual ShaderDebugTrace *DebugPixel(uint32_t x, uint32_t y, uint32_t sample,
                                        uint32_t primitive) = 0;
 
+  DOCUMENT(R"(Debug every pixel in a rectangle and return a summary of each, such as the shader's
+final outputs and where the first NaN was produced.
+
+The shader inputs for the whole rectangle are fetched with a single replay of the draw, then each
+pixel is debugged as with :meth:`DebugPixel` and run to completion on the replay side. Debugging
+many pixels doesn't need a replay or a round-trip for every pixel. Pixels the draw didn't cover are
+returned without being debugged.
+
+The rectangle is clamped to the bound target. At most 4096 pixels can be debugged at once, and
+larger rectangles return an empty list.
+
+:param int x: The x co-ordinate of the top-left of the rectangle.
+:param int y: The y co-ordinate of the top-left of the rectangle.
+:param int width: The width of the rectangle.
+:param int height: The height of the rectangle.
+:param int sample: The multi-sampled sample. Ignored if non-multisampled texture.
+:param int primitive: Debug the pixels from this primitive if there's ambiguity. If set to
+  :data:`NoPreference` then a heuristic is used to pick a fragment that likely passed
+  depth/stencil testing. This should be the primitive ID of the fragment.
+:return: The summary of each pixel, in row-major order.
+:rtype: ``list`` of :class:`PixelDebugSummary`
+)");
+  virtual rdcarray<PixelDebugSummary> DebugPixels(uint32_t x, uint32_t y, uint32_t width,
+                                                  uint32_t height, uint32_t sample,
+                                                  uint32_t primitive) = 0;
+
   DOCUMENT(R"(Retrieve a debugging trace from running a compute thread.
 
 :param groupid: A list containing the 3D workgroup index.
@@ -888,6 +978,41 @@ completed, further calls will return an empty list.
 )");
   virtual rdcarray<ShaderDebugState> ContinueDebug(ShaderDebugger *debugger) = 0;
 
+  DOCUMENT(R"(Continue a shader's debugging until a condition is met, without returning every
+intermediate state. The steps are run next to the replay, so over a remote connection only the
+states at the stop point are sent back.
+
+The first returned state is the one matching the condition. It holds the combined changes of all
+the steps skipped since the last returned state, so it can still be applied forwards or backwards
+as a single step. It may be followed by further states that had already been calculated past the
+stop point. These should be applied as normal.
+
+If the list is empty, the debugging process has completed, further calls will return an empty list.
+
+:param ShaderDebugger debugger: The shader debugger to continue running.
+:param ShaderDebugStopCondition condition: The conditions to stop at.
+:return: The state at the stop point, followed by any subsequent states already calculated.
+:rtype: ``list`` of :class:`ShaderDebugState`
+)");
+  virtual rdcarray<ShaderDebugState> ContinueDebugToCondition(
+      ShaderDebugger *debugger, const ShaderDebugStopCondition &condition) = 0;
+
+  DOCUMENT(R"(Retrieve the value of every variable in scope at a given state of a shader's
+debugging, without applying each change from the start.
+
+The states returned by :meth:`ContinueDebug` and :meth:`ContinueDebugToCondition` are recorded as
+they are returned, along with a snapshot of the variables at regular intervals. The variables at any
+state are found from the nearest earlier snapshot.
+
+:param ShaderDebugger debugger: The shader debugger that returned the states.
+:param int stateIndex: The index of the state, counting all states returned so far for this
+  debugger. The first state returned is index 0.
+:return: The variables after the given state, or an empty list if that state hasn't been returned.
+:rtype: ``list`` of :class:`ShaderVariable`
+)");
+  virtual rdcarray<ShaderVariable> GetDebugVariablesAt(ShaderDebugger *debugger,
+                                                       uint32_t stateIndex) = 0;
+
   DOCUMENT(R"(Free a debugging trace from running a shader invocation debug.
 
 :param ShaderDebugTrace trace: The shader debugging trace to free.
@@ -932,6 +1057,53 @@ texture to something compatible with the target file format.
 )");
   virtual bool SaveTexture(const TextureSave &saveData, const char *path) = 0;
 
+  DOCUMENT(R"(Save each mip and slice of a texture to its own file on disk, with the same
+transformations as :meth:`SaveTexture`.
+
+If :data:`TextureSave.mip` or the slice index in :data:`TextureSave.slice` is ``-1`` then every mip
+or slice is saved, otherwise only that one. The mip and slice are added to the filename before the
+extension, so ``tex.png`` is saved as ``tex_mip0_slice0.png``, ``tex_mip0_slice1.png`` and so on.
+
+Slices are never combined into a grid or cruciform, and for multisampled textures the sample
+selected in :data:`TextureSave.sample` is saved without mapping samples to slices.
+
+Subresources are converted and encoded on worker threads while later subresources are fetched, so
+this is faster than calling :meth:`SaveTexture` for each one.
+
+:param TextureSave saveData: The configuration settings of which texture to save, and how
+:param str path: The path to save to on disk, which the mip and slice are added to.
+:return: ``True`` if every subresource was saved successfully, ``False`` otherwise.
+:rtype: ``bool``
+)");
+  virtual bool SaveTextureSubresources(const TextureSave &saveData, const char *path) = 0;
+
+  DOCUMENT(R"(Save many textures to disk at the current event in one call.
+
+Each texture is saved with the transformations in its :class:`TextureSave`. ``DDS`` files hold
+every selected mip and slice, for any other file type each selected mip and slice is saved to its
+own file as with :meth:`SaveTextureSubresources`.
+
+Filenames come from the pattern, with these placeholders replaced:
+
+* ``{name}`` - the resource's name, with any characters that aren't safe in a filename replaced.
+* ``{id}`` - the resource's ID as a number.
+* ``{mip}`` - the mip, or ``all`` for a ``DDS`` file holding every mip.
+* ``{slice}`` - the slice, or ``all`` for a ``DDS`` file holding every slice.
+* ``{ext}`` - the lowercase extension for the file type, e.g. ``png``.
+
+e.g. ``out/{name}_{id}/mip{mip}_slice{slice}.{ext}``. Any directories are created as needed. The
+pattern should contain enough placeholders to give every file a unique name.
+
+Texture data is read back here, while earlier textures are converted and encoded on worker
+threads. Failures are logged and don't stop the remaining textures from being saved.
+
+:param List[TextureSave] textures: The textures to save and how to save each one.
+:param str pathPattern: The pattern for the path to save each file to on disk.
+:return: ``True`` if every texture was saved successfully, ``False`` otherwise.
+:rtype: ``bool``
+)");
+  virtual bool ExportResources(const rdcarray<TextureSave> &textures, const char *pathPattern) = 0;
+
   DOCUMENT(R"(Retrieve the generated data from one of the geometry processing shader stages.
 
 :param int instance: The index of the instance to retrieve data for, or 0 for non-instanced draws.
@@ -961,6 +1133,35 @@ texture to something compatible with the target file format.
 )");
   virtual bytebuf GetTextureData(ResourceId tex, const Subresource &sub) = 0;
 
+  DOCUMENT(R"(Retrieve the contents of a region within one subresource of a texture as a ``bytes``.
+
+Only the region is read back from the GPU and, when replaying remotely, transferred to this
+machine. This makes it much cheaper than :meth:`GetTextureData` for inspecting a few texels of a
+large texture.
+
+The data is tightly packed in the same layout as :meth:`GetTextureData`, with rows of ``width``
+texels. The region is clamped to the subresource. For block-compressed textures the region is
+expanded to whole 4x4 blocks, and other block-compressed formats such as ASTC aren't supported.
+
+.. note::
+  X and Y co-ordinates are always considered to be top-left, even on GL, for consistency between
+  APIs and preventing the need for API-specific code in most cases.
+
+:param ResourceId tex: The id of the texture to retrieve data from.
+:param Subresource sub: The subresource within this texture to use.
+:param int x: The x co-ordinate of the left of the region.
+:param int y: The y co-ordinate of the top of the region.
+:param int z: The first slice of the region for 3D textures. Ignored for other textures.
+:param int width: The width of the region.
+:param int height: The height of the region.
+:param int depth: The number of slices in the region for 3D textures. Ignored for other textures.
+:return: The requested texture contents.
+:rtype: ``bytes``
+)");
+  virtual bytebuf GetTextureRegionData(ResourceId tex, const Subresource &sub, uint32_t x,
+                                       uint32_t y, uint32_t z, uint32_t width, uint32_t height,
+                                       uint32_t depth) = 0;
+
   static const uint32_t NoPreference = ~0U;
 
 protected:
@@ -1703,6 +1904,30 @@ case of strip topologies.
 extern "C" RENDERDOC_API uint32_t RENDERDOC_CC RENDERDOC_VertexOffset(Topology topology,
                                                                       uint32_t primitive);
 
+DOCUMENT(R"(Compare two textures' data, returning per-channel error metrics and optionally a
+difference image. This can be used to compare textures from different captures, fetched with
+:meth:`ReplayController.GetTextureData`.
+
+The data must be tightly packed, and the textures can be in different formats. Block compressed
+formats are supported where they can be decoded on the CPU. The comparison uses multiple threads.
+
+:param ResourceFormat formatA: The format of the first texture's data.
+:param bytes dataA: The first texture's data.
+:param ResourceFormat formatB: The format of the second texture's data.
+:param bytes dataB: The second texture's data.
+:param int width: The width of both textures.
+:param int height: The height of both textures.
+:param int depth: The depth of both textures.
+:param float threshold: The absolute error above which a texel counts as differing.
+:param bool diffImage: ``True`` if the difference image should be returned.
+:return: The results of the comparison.
+:rtype: TextureComparison
+)");
+extern "C" RENDERDOC_API TextureComparison RENDERDOC_CC RENDERDOC_CompareTextureData(
+    const ResourceFormat &formatA, const bytebuf &dataA, const ResourceFormat &formatB,
+    const bytebuf &dataB, uint32_t width, uint32_t height, uint32_t depth, float threshold,
+    bool diffImage);
+
 //////////////////////////////////////////////////////////////////////////
 // Create a capture file handle.
 //////////////////////////////////////////////////////////////////////////
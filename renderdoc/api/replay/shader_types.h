@@ -700,6 +700,42 @@ The oldest/outer function is first in the list, the newest/inner function is las
 
 DECLARE_REFLECTION_STRUCT(ShaderDebugState);
 
+DOCUMENT(R"(Describes when to stop running a shader debug with
+:meth:`ReplayController.ContinueDebugToCondition`. Debugging stops at the first state that matches
+any of the conditions.
+)");
+struct ShaderDebugStopCondition
+{
+  DOCUMENT("");
+  ShaderDebugStopCondition() = default;
+  ShaderDebugStopCondition(const ShaderDebugStopCondition &) = default;
+  ShaderDebugStopCondition &operator=(const ShaderDebugStopCondition &) = default;
+
+  DOCUMENT(R"(A ``list`` of instruction indices to stop at, before they are executed.
+
+To stop at a source line, include every instruction that maps to that line in
+:data:`ShaderDebugTrace.lineInfo`.
+)");
+  rdcarray<uint32_t> instructions;
+
+  DOCUMENT(R"(A set of :class:`ShaderEvents` flags. Stop at any state where one of these events
+happened.
+)");
+  ShaderEvents events = ShaderEvents::NoEvent;
+
+  DOCUMENT(R"(A ``list`` of ``str`` with debug variable names. Stop at any state that changes one of
+these variables.
+)");
+  rdcarray<rdcstr> watchVariables;
+
+  DOCUMENT(R"(The maximum number of steps to run before stopping even if no condition is met, or
+``0`` to run until the shader finishes.
+)");
+  uint32_t maxSteps = 0;
+};
+
+DECLARE_REFLECTION_STRUCT(ShaderDebugStopCondition);
+
 DOCUMENT("An opaque structure that has internal state for shader debugging");
 struct ShaderDebugger
 {
@@ -789,6 +825,88 @@ corresponds to
 
 DECLARE_REFLECTION_STRUCT(ShaderDebugTrace);
 
+DOCUMENT(R"(A summary of debugging a single pixel, as returned from
+:meth:`ReplayController.DebugPixels`.
+
+The pixel's shader is run to completion on the replay side, so only the results are returned
+rather than every :class:`ShaderDebugState`. To step through a pixel of interest, use
+:meth:`ReplayController.DebugPixel`.
+
+.. data:: NoResult
+
+  Value for a step or instruction index that means there is no result, e.g. no NaN was produced.
+)");
+struct PixelDebugSummary
+{
+  DOCUMENT("");
+  PixelDebugSummary() = default;
+  PixelDebugSummary(const PixelDebugSummary &) = default;
+  PixelDebugSummary &operator=(const PixelDebugSummary &) = default;
+
+  bool operator==(const PixelDebugSummary &o) const
+  {
+    return x == o.x && y == o.y && debugged == o.debugged && numSteps == o.numSteps &&
+           firstNaNStep == o.firstNaNStep && firstNaNInstruction == o.firstNaNInstruction &&
+           firstNaNVariable == o.firstNaNVariable && outputs == o.outputs;
+  }
+  bool operator<(const PixelDebugSummary &o) const
+  {
+    if(!(y == o.y))
+      return y < o.y;
+    if(!(x == o.x))
+      return x < o.x;
+    if(!(debugged == o.debugged))
+      return debugged < o.debugged;
+    if(!(numSteps == o.numSteps))
+      return numSteps < o.numSteps;
+    if(!(firstNaNStep == o.firstNaNStep))
+      return firstNaNStep < o.firstNaNStep;
+    if(!(firstNaNInstruction == o.firstNaNInstruction))
+      return firstNaNInstruction < o.firstNaNInstruction;
+    if(!(firstNaNVariable == o.firstNaNVariable))
+      return firstNaNVariable < o.firstNaNVariable;
+    if(!(outputs == o.outputs))
+      return outputs < o.outputs;
+    return false;
+  }
+
+  DOCUMENT("The x co-ordinate of the pixel that was debugged.");
+  uint32_t x = 0;
+
+  DOCUMENT("The y co-ordinate of the pixel that was debugged.");
+  uint32_t y = 0;
+
+  DOCUMENT("The number of steps the shader took to complete.");
+  uint32_t numSteps = 0;
+
+  DOCUMENT(R"(The :data:`ShaderDebugState.stepIndex` of the first step that wrote a NaN to any
+variable, or :data:`NoResult` if no NaN was written.
+)");
+  uint32_t firstNaNStep = NoResult;
+
+  DOCUMENT(R"(The index of the instruction that wrote the first NaN, or :data:`NoResult` if no NaN
+was written.
+)");
+  uint32_t firstNaNInstruction = NoResult;
+
+  DOCUMENT(R"(``True`` if a fragment was found at this pixel and its shader was debugged. If this is
+``False`` the other results are empty.
+)");
+  bool debugged = false;
+
+  DOCUMENT("The name of the debug variable that the first NaN was written to.");
+  rdcstr firstNaNVariable;
+
+  DOCUMENT(R"(The final values of the debug variables that the shader's outputs are mapped to, as a
+list of :class:`ShaderVariable`.
+)");
+  rdcarray<ShaderVariable> outputs;
+
+  static const uint32_t NoResult = ~0U;
+};
+
+DECLARE_REFLECTION_STRUCT(PixelDebugSummary);
+
 DOCUMENT(R"(The information describing an input or output signature element describing the interface
 between shader stages.
 
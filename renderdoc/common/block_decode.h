@@ -0,0 +1,55 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include "api/replay/data_types.h"
+
+namespace Threading
+{
+class JobQueue;
+};
+
+// CPU decoding of block-compressed textures. Supports BC1-7, ETC2 and EAC - ASTC and PVRTC are not
+// supported and still need to be decoded on a GPU.
+bool IsBlockDecodeSupported(const ResourceFormat &fmt);
+
+// the natural format to decode fmt into without losing information. Formats that only ever hold
+// 8-bit colour decode to RGBA8, keeping the sRGB-ness of the source. Anything else decodes to
+// RGBA32 float.
+ResourceFormat GetBlockDecodeFormat(const ResourceFormat &fmt);
+
+// decodes one subresource of tightly packed blocks (width x height x depth texels) into out, as
+// tightly packed texels of outFormat which must be a regular format. Missing channels are filled
+// with 0 for colour and 1 for alpha.
+//
+// 8-bit sources written to an 8-bit RGBA outFormat are copied as-is, so sRGB data stays sRGB
+// encoded regardless of outFormat's component type. In all other cases the texels are decoded to
+// linear floats first and then encoded to outFormat.
+//
+// Rows of blocks are decoded in parallel on jobs if it's not NULL. Returns false if the format
+// isn't supported or there isn't enough data.
+bool DecodeBlockCompressed(const ResourceFormat &fmt, const byte *data, size_t dataSize,
+                           uint32_t width, uint32_t height, uint32_t depth,
+                           const ResourceFormat &outFormat, byte *out, Threading::JobQueue *jobs);
@@ -25,6 +25,7 @@
 #include "dds_readwrite.h"
 #include <stdint.h>
 #include "common/common.h"
+#include "common/job_queue.h"
 #include "os/os_specific.h"
 #include "serialise/streamio.h"
 
@@ -677,7 +678,7 @@ DXGI_FORMAT ResourceFormat2DXGIFormat(ResourceFormat format)
   return DXGI_FORMAT_UNKNOWN;
 }
 
-bool write_dds_to_file(FILE *f, const dds_data &data)
+bool write_dds_to_file(FILE *f, const dds_data &data, Threading::JobQueue *jobs)
 {
   if(!f)
     return false;
@@ -900,55 +901,194 @@ bool write_dds_to_file(FILE *f, const dds_data &data)
     header.ddspf.dwFourCC = MAKE_FOURCC('D', 'X', '1', '0');
   }
 
-  {
-    FileIO::fwrite(&magic, sizeof(magic), 1, f);
-    FileIO::fwrite(&header, sizeof(header), 1, f);
-    if(dx10Header)
-      FileIO::fwrite(&headerDXT10, sizeof(headerDXT10), 1, f);
+  const uint64_t headerSize =
+      sizeof(magic) + sizeof(header) + (dx10Header ? sizeof(headerDXT10) : 0);
 
-    int i = 0;
-    for(uint32_t slice = 0; slice < RDCMAX(1U, data.slices); slice++)
+  // each subdata is one depth slice of one mip, and is stored tightly packed after the last. Work
+  // out where they all go so they can be written independently.
+  rdcarray<uint64_t> offsets;
+  rdcarray<uint64_t> sizes;
+  uint64_t fileSize = headerSize;
+
+  for(uint32_t slice = 0; slice < RDCMAX(1U, data.slices); slice++)
+  {
+    for(uint32_t mip = 0; mip < RDCMAX(1U, data.mips); mip++)
     {
-      for(uint32_t mip = 0; mip < RDCMAX(1U, data.mips); mip++)
+      uint32_t numdepths = RDCMAX(1U, data.depth >> mip);
+      for(uint32_t d = 0; d < numdepths; d++)
       {
-        uint32_t numdepths = RDCMAX(1U, data.depth >> mip);
-        for(uint32_t d = 0; d < numdepths; d++)
+        uint32_t rowlen = RDCMAX(1U, data.width >> mip);
+        uint32_t numRows = RDCMAX(1U, data.height >> mip);
+        uint32_t pitch = RDCMAX(1U, rowlen * bytesPerPixel);
+
+        // pitch/rows are in blocks, not pixels, for block formats.
+        if(blockFormat)
         {
-          byte *bytedata = data.subdata[i];
+          numRows = RDCMAX(1U, (numRows + 3) / 4);
 
-          uint32_t rowlen = RDCMAX(1U, data.width >> mip);
-          uint32_t numRows = RDCMAX(1U, data.height >> mip);
-          uint32_t pitch = RDCMAX(1U, rowlen * bytesPerPixel);
+          uint32_t blockSize = (data.format.type == ResourceFormatType::BC1 ||
+                                data.format.type == ResourceFormatType::BC4)
+                                   ? 8
+                                   : 16;
 
-          // pitch/rows are in blocks, not pixels, for block formats.
-          if(blockFormat)
-          {
-            numRows = RDCMAX(1U, numRows / 4);
+          pitch = RDCMAX(blockSize, (((rowlen + 3) / 4)) * blockSize);
+        }
 
-            uint32_t blockSize = (data.format.type == ResourceFormatType::BC1 ||
-                                  data.format.type == ResourceFormatType::BC4)
-                                     ? 8
-                                     : 16;
+        offsets.push_back(fileSize);
+        sizes.push_back(uint64_t(numRows) * pitch);
+        fileSize += sizes.back();
+      }
+    }
+  }
 
-            pitch = RDCMAX(blockSize, (((rowlen + 3) / 4)) * blockSize);
-          }
+  // if we can map the file, copy every subresource straight into it in parallel
+  byte *mapped = FileIO::fmap_write(f, fileSize);
 
-          for(uint32_t row = 0; row < numRows; row++)
-          {
-            FileIO::fwrite(bytedata, 1, pitch, f);
+  if(mapped)
+  {
+    byte *dst = mapped;
+    memcpy(dst, &magic, sizeof(magic));
+    dst += sizeof(magic);
+    memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    if(dx10Header)
+      memcpy(dst, &headerDXT10, sizeof(headerDXT10));
 
-            bytedata += pitch;
-          }
+    Threading::ParallelFor(jobs, sizes.size(), 1, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++)
+        memcpy(mapped + offsets[i], data.subdata[i], (size_t)sizes[i]);
+    });
 
-          i++;
-        }
+    bool success = FileIO::fmap_flush(mapped, fileSize);
+    FileIO::funmap(mapped, fileSize);
+
+    if(!success)
+      RDCERR("Couldn't write DDS file: %s", FileIO::ErrorString().c_str());
+
+    return success;
+  }
+
+  // otherwise, e.g. if the file is only open for writing, write it out in order
+  bool success = FileIO::fwrite(&magic, sizeof(magic), 1, f) == 1;
+  success &= FileIO::fwrite(&header, sizeof(header), 1, f) == 1;
+  if(dx10Header)
+    success &= FileIO::fwrite(&headerDXT10, sizeof(headerDXT10), 1, f) == 1;
+
+  for(size_t i = 0; success && i < sizes.size(); i++)
+    success &= FileIO::fwrite(data.subdata[i], 1, (size_t)sizes[i], f) == (size_t)sizes[i];
+
+  // buffered writes might only fail when they're flushed
+  success = success && FileIO::fflush(f);
+
+  if(!success)
+    RDCERR("Couldn't write DDS file: %s", FileIO::ErrorString().c_str());
+
+  return success;
+}
+
+// the size of each texel - or each block, for block formats - as stored in a DDS file. Returns
+// false for formats that can't be stored.
+static bool GetDDSTexelSize(const ResourceFormat &format, uint32_t *bytesPerPixel,
+                            uint32_t *subsamplePacking, bool *blockFormat)
+{
+  uint32_t bpp = 1;
+  uint32_t packing = 1;
+  bool block = false;
+
+  switch(format.type)
+  {
+    case ResourceFormatType::S8:
+    case ResourceFormatType::A8: bpp = 1; break;
+    case ResourceFormatType::R10G10B10A2:
+    case ResourceFormatType::R9G9B9E5:
+    case ResourceFormatType::R11G11B10:
+    case ResourceFormatType::D24S8: bpp = 4; break;
+    case ResourceFormatType::R5G6B5:
+    case ResourceFormatType::R5G5B5A1:
+    case ResourceFormatType::R4G4B4A4: bpp = 2; break;
+    case ResourceFormatType::D32S8: bpp = 8; break;
+    case ResourceFormatType::YUV8:
+      if(format.YUVPlaneCount() == 1 && format.YUVSubsampling() == 422)
+      {
+        packing = 2;
+        bpp = 2;
+        break;
       }
+      return false;
+    case ResourceFormatType::YUV10:
+    case ResourceFormatType::YUV12:
+    case ResourceFormatType::YUV16:
+    case ResourceFormatType::D16S8:
+    case ResourceFormatType::R4G4: return false;
+    default: bpp = format.compCount * format.compByteWidth;
+  }
+
+  if(format.Special())
+  {
+    switch(format.type)
+    {
+      case ResourceFormatType::BC1:
+      case ResourceFormatType::BC2:
+      case ResourceFormatType::BC3:
+      case ResourceFormatType::BC4:
+      case ResourceFormatType::BC5:
+      case ResourceFormatType::BC6:
+      case ResourceFormatType::BC7: block = true; break;
+      case ResourceFormatType::ETC2:
+      case ResourceFormatType::EAC:
+      case ResourceFormatType::ASTC: return false;
+      default: break;
     }
   }
 
+  if(bytesPerPixel)
+    *bytesPerPixel = bpp;
+  if(subsamplePacking)
+    *subsamplePacking = packing;
+  if(blockFormat)
+    *blockFormat = block;
+
   return true;
 }
 
+struct DDSSubresourceLayout
+{
+  uint32_t bytesPerPixel;
+  uint32_t rowlen;
+  // rows and pitch are in blocks, not pixels, for block formats.
+  uint32_t numRows;
+  uint32_t numDepths;
+  uint32_t pitch;
+};
+
+static DDSSubresourceLayout GetDDSSubresourceLayout(const dds_data &data, uint32_t mip)
+{
+  uint32_t subsamplePacking = 1;
+  bool blockFormat = false;
+
+  DDSSubresourceLayout ret;
+  GetDDSTexelSize(data.format, &ret.bytesPerPixel, &subsamplePacking, &blockFormat);
+
+  ret.rowlen = AlignUp(RDCMAX(1U, data.width >> mip), subsamplePacking);
+  ret.numRows = RDCMAX(1U, data.height >> mip);
+  ret.numDepths = RDCMAX(1U, data.depth >> mip);
+  ret.pitch = RDCMAX(1U, ret.rowlen * ret.bytesPerPixel);
+
+  if(blockFormat)
+  {
+    ret.numRows = RDCMAX(1U, (ret.numRows + 3) / 4);
+
+    uint32_t blockSize =
+        (data.format.type == ResourceFormatType::BC1 || data.format.type == ResourceFormatType::BC4)
+            ? 8
+            : 16;
+
+    ret.pitch = RDCMAX(blockSize, (((ret.rowlen + 3) / 4)) * blockSize);
+  }
+
+  return ret;
+}
+
 bool is_dds_file(byte *headerBuffer, size_t size)
 {
   if(size < 4)
@@ -958,13 +1098,13 @@ bool is_dds_file(byte *headerBuffer, size_t size)
   return memcmp(headerBuffer, &dds_fourcc, 4) == 0;
 }
 
-dds_data load_dds_from_file(StreamReader *reader)
+// fileSize is passed separately so that the header can be parsed from a reader over just the start
+// of a mapped file.
+static dds_data ParseDDSHeader(StreamReader *reader, uint64_t fileSize)
 {
   dds_data ret = {};
   dds_data error = {};
 
-  uint64_t fileSize = reader->GetSize();
-
   uint32_t magic = 0;
   reader->Read(magic);
 
@@ -1134,133 +1274,306 @@ dds_data load_dds_from_file(StreamReader *reader)
     }
   }
 
-  uint32_t bytesPerPixel = 1;
-  uint32_t subsamplePacking = 1;
-  switch(ret.format.type)
+  if(!GetDDSTexelSize(ret.format, NULL, NULL, NULL))
   {
-    case ResourceFormatType::S8:
-    case ResourceFormatType::A8: bytesPerPixel = 1; break;
-    case ResourceFormatType::R10G10B10A2:
-    case ResourceFormatType::R9G9B9E5:
-    case ResourceFormatType::R11G11B10:
-    case ResourceFormatType::D24S8: bytesPerPixel = 4; break;
-    case ResourceFormatType::R5G6B5:
-    case ResourceFormatType::R5G5B5A1:
-    case ResourceFormatType::R4G4B4A4: bytesPerPixel = 2; break;
-    case ResourceFormatType::D32S8: bytesPerPixel = 8; break;
-    case ResourceFormatType::YUV8:
-      if(ret.format.YUVPlaneCount() == 1 && ret.format.YUVSubsampling() == 422)
+    RDCERR("Unsupported file format %s", ret.format.Name().c_str());
+    return error;
+  }
+
+  ret.bgrSwap = bgrSwap;
+
+  if(uint64_t(ret.slices) > fileSize || uint64_t(ret.mips) > fileSize ||
+     uint64_t(ret.slices) * ret.mips > fileSize)
+  {
+    RDCERR("Invalid slice count %u or mip count %u", ret.slices, ret.mips);
+    return error;
+  }
+
+  ret.subsizes = new uint32_t[ret.slices * ret.mips];
+
+  for(uint32_t i = 0; i < ret.slices * ret.mips; i++)
+  {
+    DDSSubresourceLayout layout = GetDDSSubresourceLayout(ret, i % ret.mips);
+    ret.subsizes[i] = layout.numDepths * layout.numRows * layout.pitch;
+  }
+
+  return ret;
+}
+
+dds_data load_dds_header(StreamReader *reader)
+{
+  return ParseDDSHeader(reader, reader->GetSize());
+}
+
+static void SwapDDSRows(const DDSSubresourceLayout &layout, byte *rows, uint32_t numRows)
+{
+  for(uint32_t row = 0; row < numRows; row++)
+  {
+    byte *rgba = rows;
+
+    if(layout.bytesPerPixel >= 3)
+    {
+      for(uint32_t p = 0; p < layout.rowlen; p++)
       {
-        subsamplePacking = 2;
-        bytesPerPixel = 2;
-        break;
+        std::swap(rgba[0], rgba[2]);
+        rgba += layout.bytesPerPixel;
       }
-      DELIBERATE_FALLTHROUGH();
-    case ResourceFormatType::YUV10:
-    case ResourceFormatType::YUV12:
-    case ResourceFormatType::YUV16:
-    case ResourceFormatType::D16S8:
-    case ResourceFormatType::R4G4:
-      RDCERR("Unsupported file format %u", ret.format.type);
-      return error;
-    default: bytesPerPixel = ret.format.compCount * ret.format.compByteWidth;
+    }
+    else
+    {
+      for(uint32_t p = 0; p < layout.rowlen; p++)
+      {
+        std::swap(rgba[0], rgba[1]);
+        rgba += layout.bytesPerPixel;
+      }
+    }
+
+    rows += layout.pitch;
   }
+}
 
-  bool blockFormat = false;
+bool read_dds_subresource(StreamReader *reader, const dds_data &data, uint32_t subresource,
+                          byte *dst)
+{
+  DDSSubresourceLayout layout = GetDDSSubresourceLayout(data, subresource % data.mips);
 
-  if(ret.format.Special())
+  for(uint32_t d = 0; d < layout.numDepths; d++)
   {
-    switch(ret.format.type)
+    for(uint32_t row = 0; row < layout.numRows; row++)
     {
-      case ResourceFormatType::BC1:
-      case ResourceFormatType::BC2:
-      case ResourceFormatType::BC3:
-      case ResourceFormatType::BC4:
-      case ResourceFormatType::BC5:
-      case ResourceFormatType::BC6:
-      case ResourceFormatType::BC7: blockFormat = true; break;
-      case ResourceFormatType::ETC2:
-      case ResourceFormatType::EAC:
-      case ResourceFormatType::ASTC:
-        RDCERR("Unsupported file format, %u", ret.format.type);
-        return error;
-      default: break;
+      reader->Read(dst, layout.pitch);
+
+      if(data.bgrSwap)
+        SwapDDSRows(layout, dst, 1);
+
+      dst += layout.pitch;
     }
   }
 
-  if(uint64_t(ret.slices) > fileSize || uint64_t(ret.mips) > fileSize ||
-     uint64_t(ret.slices) * ret.mips > fileSize)
+  return !reader->IsErrored();
+}
+
+dds_data map_dds_file(FILE *f)
+{
+  dds_data error = {};
+
+  uint64_t fileSize = 0;
+  byte *mapping = FileIO::fmap(f, fileSize);
+
+  if(mapping == NULL)
   {
-    RDCERR("Invalid slice count %u or mip count %u", ret.slices, ret.mips);
-    return ret;
+    RDCERR("Couldn't map DDS file: %s", FileIO::ErrorString().c_str());
+    return error;
   }
 
-  ret.subsizes = new uint32_t[ret.slices * ret.mips];
+  // only hand the headers to the reader, it would otherwise take a copy of the whole file
+  const uint64_t maxHeaderSize = sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10);
+
+  StreamReader reader(mapping, RDCMIN(fileSize, maxHeaderSize));
+  dds_data ret = ParseDDSHeader(&reader, fileSize);
+
+  if(ret.subsizes == NULL || reader.IsErrored())
+  {
+    delete[] ret.subsizes;
+    FileIO::funmap(mapping, fileSize);
+    return error;
+  }
+
+  const uint32_t numSubs = ret.slices * ret.mips;
+
+  ret.subdata = new byte *[numSubs];
+  ret.mapping = mapping;
+  ret.mappingSize = fileSize;
+
+  // subresources are stored tightly packed one after the other, so each is a view straight into the
+  // mapping
+  uint64_t offset = reader.GetOffset();
+  for(uint32_t i = 0; i < numSubs; i++)
+  {
+    if(offset + ret.subsizes[i] > fileSize)
+    {
+      RDCERR("DDS file is truncated, couldn't read subresource %u", i);
+      unmap_dds_file(ret);
+      return error;
+    }
+
+    ret.subdata[i] = mapping + offset;
+    offset += ret.subsizes[i];
+
+    // the mapping is copy-on-write, so swapping only copies the pages of this file that we touch
+    if(ret.bgrSwap)
+    {
+      DDSSubresourceLayout layout = GetDDSSubresourceLayout(ret, i % ret.mips);
+      SwapDDSRows(layout, ret.subdata[i], layout.numDepths * layout.numRows);
+    }
+  }
+
+  return ret;
+}
+
+void unmap_dds_file(dds_data &data)
+{
+  FileIO::funmap(data.mapping, data.mappingSize);
+
+  delete[] data.subdata;
+  delete[] data.subsizes;
+
+  data.subdata = NULL;
+  data.subsizes = NULL;
+  data.mapping = NULL;
+  data.mappingSize = 0;
+}
+
+dds_data load_dds_from_file(StreamReader *reader)
+{
+  dds_data ret = load_dds_header(reader);
+
+  if(ret.subsizes == NULL)
+    return ret;
+
   ret.subdata = new byte *[ret.slices * ret.mips];
 
-  int i = 0;
-  for(uint32_t slice = 0; slice < ret.slices; slice++)
+  for(uint32_t i = 0; i < ret.slices * ret.mips; i++)
   {
-    for(uint32_t mip = 0; mip < ret.mips; mip++)
+    ret.subdata[i] = new byte[ret.subsizes[i]];
+    read_dds_subresource(reader, ret, i, ret.subdata[i]);
+  }
+
+  return ret;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Check DDS files round-trip", "[dds]")
+{
+  rdcstr filename = FileIO::GetTempFolderFilename() + "/scratch.dds";
+  rdcstr sequentialFilename = FileIO::GetTempFolderFilename() + "/scratch_sequential.dds";
+
+  Threading::JobQueue jobs;
+
+  for(DXGI_FORMAT fmt : {DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_BC1_UNORM})
+  {
+    INFO("Format: " << (uint32_t)fmt);
+
+    dds_data data = {};
+    data.width = 37;
+    data.height = 21;
+    data.depth = 1;
+    data.mips = 4;
+    data.slices = 3;
+    data.format = DXGIFormat2ResourceFormat(fmt);
+
+    rdcarray<bytebuf> contents;
+    rdcarray<byte *> subdata;
+    rdcarray<uint32_t> subsizes;
+
+    // the header is written from the format, so use the loader's layout for the sizes
+    for(uint32_t i = 0; i < data.slices * data.mips; i++)
     {
-      uint32_t rowlen = RDCMAX(1U, ret.width >> mip);
-      rowlen = AlignUp(rowlen, subsamplePacking);
-      uint32_t numRows = RDCMAX(1U, ret.height >> mip);
-      uint32_t numdepths = RDCMAX(1U, ret.depth >> mip);
-      uint32_t pitch = RDCMAX(1U, rowlen * bytesPerPixel);
-
-      // pitch/rows are in blocks, not pixels, for block formats.
-      if(blockFormat)
-      {
-        numRows = RDCMAX(1U, (numRows + 3) / 4);
+      DDSSubresourceLayout layout = GetDDSSubresourceLayout(data, i % data.mips);
+
+      bytebuf sub;
+      sub.resize(layout.numDepths * layout.numRows * layout.pitch);
+      for(size_t b = 0; b < sub.size(); b++)
+        sub[b] = byte(b * 7 + i * 13);
 
-        uint32_t blockSize = (ret.format.type == ResourceFormatType::BC1 ||
-                              ret.format.type == ResourceFormatType::BC4)
-                                 ? 8
-                                 : 16;
+      contents.push_back(sub);
+      subsizes.push_back((uint32_t)sub.size());
+    }
 
-        pitch = RDCMAX(blockSize, (((rowlen + 3) / 4)) * blockSize);
+    for(bytebuf &sub : contents)
+      subdata.push_back(sub.data());
+
+    data.subdata = subdata.data();
+    data.subsizes = subsizes.data();
+
+    // the file is mapped and written in parallel when it can be read back
+    FILE *f = FileIO::fopen(filename.c_str(), "w+b");
+    REQUIRE(f);
+    CHECK(write_dds_to_file(f, data, &jobs));
+    FileIO::fclose(f);
+
+    // and written in order when it can't, which must give the same file
+    f = FileIO::fopen(sequentialFilename.c_str(), "wb");
+    REQUIRE(f);
+    CHECK(write_dds_to_file(f, data, NULL));
+    FileIO::fclose(f);
+
+    {
+      bytebuf mappedFile, sequentialFile;
+      REQUIRE(FileIO::ReadAll(filename, mappedFile));
+      REQUIRE(FileIO::ReadAll(sequentialFilename, sequentialFile));
+      CHECK(mappedFile == sequentialFile);
+    }
+
+    // read the whole file in one go
+    {
+      StreamReader reader(FileIO::fopen(filename.c_str(), "rb"));
+      dds_data read = load_dds_from_file(&reader);
+
+      REQUIRE(read.subdata);
+      CHECK(read.width == data.width);
+      CHECK(read.height == data.height);
+      CHECK(read.mips == data.mips);
+      CHECK(read.slices == data.slices);
+      CHECK((read.format == data.format));
+
+      for(uint32_t i = 0; i < read.slices * read.mips; i++)
+      {
+        REQUIRE(read.subsizes[i] == contents[i].size());
+        CHECK(memcmp(read.subdata[i], contents[i].data(), contents[i].size()) == 0);
+        delete[] read.subdata[i];
       }
 
-      ret.subsizes[i] = numdepths * numRows * pitch;
+      delete[] read.subdata;
+      delete[] read.subsizes;
+    }
 
-      byte *bytedata = ret.subdata[i] = new byte[ret.subsizes[i]];
+    // and one subresource at a time
+    {
+      StreamReader reader(FileIO::fopen(filename.c_str(), "rb"));
+      dds_data read = load_dds_header(&reader);
 
-      for(uint32_t d = 0; d < numdepths; d++)
+      REQUIRE(read.subsizes);
+      CHECK(read.subdata == NULL);
+
+      bytebuf sub;
+      for(uint32_t i = 0; i < read.slices * read.mips; i++)
       {
-        for(uint32_t row = 0; row < numRows; row++)
-        {
-          reader->Read(bytedata, pitch);
+        REQUIRE(read.subsizes[i] == contents[i].size());
+        sub.resize(read.subsizes[i]);
+        CHECK(read_dds_subresource(&reader, read, i, sub.data()));
+        CHECK(sub == contents[i]);
+      }
 
-          if(bgrSwap)
-          {
-            byte *rgba = bytedata;
-
-            if(bytesPerPixel >= 3)
-            {
-              for(uint32_t p = 0; p < rowlen; p++)
-              {
-                std::swap(rgba[0], rgba[2]);
-                rgba += bytesPerPixel;
-              }
-            }
-            else
-            {
-              for(uint32_t p = 0; p < rowlen; p++)
-              {
-                std::swap(rgba[0], rgba[1]);
-                rgba += bytesPerPixel;
-              }
-            }
-          }
+      delete[] read.subsizes;
+    }
 
-          bytedata += pitch;
-        }
+    // and mapped, without copying
+    {
+      f = FileIO::fopen(filename.c_str(), "rb");
+      REQUIRE(f);
+      dds_data read = map_dds_file(f);
+      FileIO::fclose(f);
+
+      REQUIRE(read.subdata);
+      CHECK(read.mapping);
+
+      for(uint32_t i = 0; i < read.slices * read.mips; i++)
+      {
+        REQUIRE(read.subsizes[i] == contents[i].size());
+        CHECK(memcmp(read.subdata[i], contents[i].data(), contents[i].size()) == 0);
       }
 
-      i++;
+      unmap_dds_file(read);
+      CHECK(read.subdata == NULL);
     }
   }
 
-  return ret;
+  FileIO::Delete(filename.c_str());
+  FileIO::Delete(sequentialFilename.c_str());
 }
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -28,6 +28,11 @@
 #include "api/replay/data_types.h"
 #include "serialise/streamio.h"
 
+namespace Threading
+{
+class JobQueue;
+};
+
 struct dds_data
 {
   uint32_t width;
@@ -41,10 +46,36 @@ struct dds_data
 
   ResourceFormat format;
 
+  // set when reading UYVY data, which is loaded as YUY2 by swapping each pair of bytes
+  bool bgrSwap;
+
   byte **subdata;
   uint32_t *subsizes;
+
+  // set by map_dds_file, when subdata points into a mapping of the file instead of allocations
+  byte *mapping;
+  uint64_t mappingSize;
 };
 
 extern bool is_dds_file(byte *headerBuffer, size_t size);
 extern dds_data load_dds_from_file(StreamReader *reader);
-extern bool write_dds_to_file(FILE *f, const dds_data &data);
+
+// reads only the header, filling out everything except subdata. subsizes is NULL if the file can't
+// be loaded. Subresources can then be read one at a time in the order they're stored - every mip of
+// slice 0, then every mip of slice 1, and so on - without holding the whole file in memory.
+extern dds_data load_dds_header(StreamReader *reader);
+extern bool read_dds_subresource(StreamReader *reader, const dds_data &data, uint32_t subresource,
+                                 byte *dst);
+
+// maps the whole file and points subdata straight into the mapping, so no subresource is read or
+// copied until it's used. subdata is NULL if the file can't be loaded. The file can be closed
+// straight away, and the subresources stay valid until unmap_dds_file is called. Files that might
+// be truncated while they're mapped, like the image viewer's watched file, should be read with
+// load_dds_header and read_dds_subresource instead.
+extern dds_data map_dds_file(FILE *f);
+extern void unmap_dds_file(dds_data &data);
+
+// subdata holds each mip of each slice, with every depth slice of a 3D mip given separately. If
+// the file is open for reading as well as writing it's mapped and the subresources are copied in
+// parallel on jobs, otherwise they're written in order.
+extern bool write_dds_to_file(FILE *f, const dds_data &data, Threading::JobQueue *jobs);
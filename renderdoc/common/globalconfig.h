@@ -132,6 +132,13 @@
 #define RDOC_SIZET_SEP_TYPE OPTION_OFF
 #endif
 
+// can SSE2 intrinsics be used without a runtime check? They're baseline on x64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RDOC_SSE2 OPTION_ON
+#else
+#define RDOC_SSE2 OPTION_OFF
+#endif
+
 #if defined(RENDERDOC_WINDOWING_XLIB)
 #define RDOC_XLIB OPTION_ON
 #else
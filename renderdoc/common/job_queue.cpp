@@ -0,0 +1,250 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "job_queue.h"
+
+namespace Threading
+{
+JobQueue::JobQueue(uint32_t maxWorkers)
+{
+  m_MaxWorkers = maxWorkers ? maxWorkers : GetNumberOfCores();
+}
+
+JobQueue::~JobQueue()
+{
+  WaitAll();
+
+  Atomic::Inc32(&m_Shutdown);
+
+  for(Worker *worker : m_Workers)
+  {
+    JoinThread(worker->thread);
+    CloseThread(worker->thread);
+    delete worker;
+  }
+}
+
+JobHandle JobQueue::Submit(std::function<void()> func)
+{
+  SCOPED_LOCK(m_Lock);
+
+  JobHandle job = ++m_LastJob;
+  m_PendingJobs[job] = func;
+
+  if(m_ActiveWorkers < m_MaxWorkers)
+  {
+    // clean up any workers that ran out of work and exited, before starting a new one
+    for(size_t i = 0; i < m_Workers.size();)
+    {
+      if(Atomic::CmpExch32(&m_Workers[i]->finished, 1, 1) == 1)
+      {
+        JoinThread(m_Workers[i]->thread);
+        CloseThread(m_Workers[i]->thread);
+        delete m_Workers[i];
+        m_Workers.erase(i);
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    Worker *worker = new Worker;
+    m_ActiveWorkers++;
+    worker->thread = CreateThread([this, worker]() { WorkerEntry(worker); });
+    m_Workers.push_back(worker);
+  }
+
+  return job;
+}
+
+void JobQueue::Wait(JobHandle job)
+{
+  if(job == 0)
+    return;
+
+  std::function<void()> func;
+
+  {
+    SCOPED_LOCK(m_Lock);
+
+    auto it = m_PendingJobs.find(job);
+
+    // if the job isn't pending or running it has already completed
+    if(it == m_PendingJobs.end())
+    {
+      while(m_RunningJobs.find(job) != m_RunningJobs.end())
+        m_JobDone.Wait(m_Lock);
+
+      return;
+    }
+
+    // if nothing has started this job yet, run it ourselves rather than waiting for a worker
+    func.swap(it->second);
+    m_PendingJobs.erase(it);
+    m_RunningJobs.insert(job);
+  }
+
+  RunJob(job, func);
+}
+
+void JobQueue::WaitAll()
+{
+  for(;;)
+  {
+    std::function<void()> func;
+    JobHandle job = 0;
+
+    {
+      SCOPED_LOCK(m_Lock);
+
+      job = TakeJob(func);
+
+      if(job == 0)
+      {
+        // nothing left to run ourselves, wait for the workers. A running job can submit more, so
+        // check again each time one completes.
+        if(m_RunningJobs.empty())
+          return;
+
+        m_JobDone.Wait(m_Lock);
+        continue;
+      }
+    }
+
+    RunJob(job, func);
+  }
+}
+
+JobHandle JobQueue::TakeJob(std::function<void()> &func)
+{
+  // must be called with m_Lock held
+  if(m_PendingJobs.empty())
+    return 0;
+
+  auto it = m_PendingJobs.begin();
+  JobHandle job = it->first;
+  func.swap(it->second);
+  m_PendingJobs.erase(it);
+  m_RunningJobs.insert(job);
+
+  return job;
+}
+
+void JobQueue::RunJob(JobHandle job, std::function<void()> &func)
+{
+  func();
+  // release anything captured as soon as we can
+  func = std::function<void()>();
+
+  {
+    SCOPED_LOCK(m_Lock);
+    m_RunningJobs.erase(job);
+  }
+
+  m_JobDone.WakeAll();
+}
+
+void JobQueue::WorkerEntry(Worker *worker)
+{
+  SetCurrentThreadName("JobQueue worker");
+
+  uint32_t idleCount = 0;
+
+  for(;;)
+  {
+    std::function<void()> func;
+    JobHandle job = 0;
+
+    {
+      SCOPED_LOCK(m_Lock);
+      job = TakeJob(func);
+    }
+
+    if(job)
+    {
+      idleCount = 0;
+      RunJob(job, func);
+      continue;
+    }
+
+    // linger for a moment in case more work is about to be submitted, so that a steady trickle
+    // of jobs doesn't start and stop a thread for each one.
+    if(idleCount < 5 && Atomic::CmpExch32(&m_Shutdown, 0, 0) == 0)
+    {
+      idleCount++;
+      Sleep(1);
+      continue;
+    }
+
+    {
+      SCOPED_LOCK(m_Lock);
+
+      // check again under the lock, Submit() only starts a new worker if we've stopped being
+      // active so anything added before this point is ours to run.
+      if(!m_PendingJobs.empty())
+        continue;
+
+      m_ActiveWorkers--;
+    }
+
+    break;
+  }
+
+  // this must be the last thing we do, after this the thread can be joined and the worker freed
+  Atomic::Inc32(&worker->finished);
+}
+
+void ParallelFor(JobQueue *queue, size_t count, size_t minBatch,
+                 std::function<void(size_t begin, size_t end)> func)
+{
+  if(count == 0)
+    return;
+
+  minBatch = RDCMAX(minBatch, (size_t)1);
+
+  // a few batches per core so that uneven batches still balance out
+  size_t numBatches = RDCMIN(count / minBatch, (size_t)GetNumberOfCores() * 4);
+
+  if(queue == NULL || numBatches <= 1)
+  {
+    func(0, count);
+    return;
+  }
+
+  size_t batchSize = (count + numBatches - 1) / numBatches;
+
+  rdcarray<JobHandle> jobs;
+  for(size_t begin = batchSize; begin < count; begin += batchSize)
+  {
+    size_t end = RDCMIN(begin + batchSize, count);
+    jobs.push_back(queue->Submit([&func, begin, end]() { func(begin, end); }));
+  }
+
+  func(0, batchSize);
+
+  for(JobHandle job : jobs)
+    queue->Wait(job);
+}
+};
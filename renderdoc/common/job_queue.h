@@ -0,0 +1,89 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <set>
+#include "common/threading.h"
+
+namespace Threading
+{
+// identifies a job submitted to a JobQueue. Jobs are freed as soon as they complete, so a handle
+// can be waited on any number of times - once its job has completed, waiting returns immediately.
+// 0 is never a valid job.
+typedef uint64_t JobHandle;
+
+// a simple pool of worker threads for running independent jobs in the background. Workers are
+// only alive while there is work to do, so an idle queue costs nothing. Each job can be waited on
+// individually, and if it hasn't been picked up by a worker yet it is run on the waiting thread
+// instead so waiting never blocks on queued work.
+class JobQueue
+{
+public:
+  // if maxWorkers is 0, one worker per core is used
+  JobQueue(uint32_t maxWorkers = 0);
+  ~JobQueue();
+
+  JobQueue(const JobQueue &) = delete;
+  JobQueue &operator=(const JobQueue &) = delete;
+
+  JobHandle Submit(std::function<void()> func);
+
+  // wait for one job to complete
+  void Wait(JobHandle job);
+  // wait for all submitted jobs to complete
+  void WaitAll();
+
+private:
+  struct Worker
+  {
+    ThreadHandle thread = 0;
+    int32_t finished = 0;
+  };
+
+  void WorkerEntry(Worker *worker);
+  JobHandle TakeJob(std::function<void()> &func);
+  void RunJob(JobHandle job, std::function<void()> &func);
+
+  uint32_t m_MaxWorkers;
+  int32_t m_Shutdown = 0;
+
+  CriticalSection m_Lock;
+  // signalled whenever a running job completes
+  ConditionVariable m_JobDone;
+  JobHandle m_LastJob = 0;
+  // jobs that haven't started yet, in submission order
+  std::map<JobHandle, std::function<void()>> m_PendingJobs;
+  std::set<JobHandle> m_RunningJobs;
+  rdcarray<Worker *> m_Workers;
+  uint32_t m_ActiveWorkers = 0;
+};
+
+// splits [0, count) into batches of at least minBatch items and calls func(begin, end) for each,
+// spread over the queue's workers and the calling thread. Returns once every batch has run. If
+// queue is NULL the whole range is run on the calling thread.
+void ParallelFor(JobQueue *queue, size_t count, size_t minBatch,
+                 std::function<void(size_t begin, size_t end)> func);
+};
@@ -0,0 +1,359 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "png_write.h"
+#include "common/common.h"
+#include "common/job_queue.h"
+#include "miniz/miniz.h"
+#include "serialise/streamio.h"
+
+// PNG is a zlib stream of filtered rows. Each row's filter only depends on that row and the one
+// above it, and deflate blocks can be terminated with a sync flush and concatenated. So we split
+// the image into bands of rows, filter and deflate each band independently, then stitch the raw
+// deflate streams together under a single zlib header and a combined adler-32.
+
+static const size_t pngBandSize = 256 * 1024;
+
+// a low level is much faster than the default while still compressing better than stb_image_write
+static const int pngCompressionLevel = 2;
+
+static byte PaethPredictor(int a, int b, int c)
+{
+  int p = a + b - c;
+  int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  if(pa <= pb && pa <= pc)
+    return byte(a);
+  if(pb <= pc)
+    return byte(b);
+  return byte(c);
+}
+
+// filter one row with the given filter type. For the first row in the image prev should point to
+// a row of zeroes.
+static void FilterRow(byte type, const byte *row, const byte *prev, uint32_t bpp, uint32_t rowBytes,
+                      byte *out)
+{
+  // the first pixel has nothing to its left, so handle it separately to keep the main loops simple
+  switch(type)
+  {
+    case 0:
+      memcpy(out, row, rowBytes);
+      return;
+    case 1:
+      memcpy(out, row, bpp);
+      for(uint32_t i = bpp; i < rowBytes; i++)
+        out[i] = byte(row[i] - row[i - bpp]);
+      return;
+    case 2:
+      for(uint32_t i = 0; i < rowBytes; i++)
+        out[i] = byte(row[i] - prev[i]);
+      return;
+    case 3:
+      for(uint32_t i = 0; i < bpp; i++)
+        out[i] = byte(row[i] - (prev[i] >> 1));
+      for(uint32_t i = bpp; i < rowBytes; i++)
+        out[i] = byte(row[i] - ((row[i - bpp] + prev[i]) >> 1));
+      return;
+    case 4:
+      for(uint32_t i = 0; i < bpp; i++)
+        out[i] = byte(row[i] - prev[i]);
+      for(uint32_t i = bpp; i < rowBytes; i++)
+        out[i] = byte(row[i] - PaethPredictor(row[i - bpp], prev[i], prev[i - bpp]));
+      return;
+  }
+}
+
+// combine the adler-32 of two consecutive buffers, given the adler-32 of each and the length of the
+// second. Same as zlib's adler32_combine.
+static uint32_t CombineAdler32(uint32_t adler1, uint32_t adler2, size_t len2)
+{
+  const uint32_t base = 65521;
+
+  uint32_t rem = uint32_t(len2 % base);
+  uint32_t sum1 = adler1 & 0xffff;
+  uint32_t sum2 = uint32_t((uint64_t(rem) * sum1) % base);
+  sum1 += (adler2 & 0xffff) + base - 1;
+  sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + base - rem;
+  if(sum1 >= base)
+    sum1 -= base;
+  if(sum1 >= base)
+    sum1 -= base;
+  if(sum2 >= (base << 1))
+    sum2 -= (base << 1);
+  if(sum2 >= base)
+    sum2 -= base;
+  return sum1 | (sum2 << 16);
+}
+
+struct PNGBand
+{
+  uint32_t firstRow;
+  uint32_t numRows;
+
+  bytebuf deflated;
+  uint32_t adler;
+  size_t filteredSize;
+  bool success;
+};
+
+static mz_bool AppendDeflated(const void *buf, int len, void *user)
+{
+  ((bytebuf *)user)->append((const byte *)buf, len);
+  return MZ_TRUE;
+}
+
+static void CompressBand(const png_data &data, PNGBand &band, bool last)
+{
+  const uint32_t bpp = data.numComps;
+  const uint32_t rowBytes = data.width * bpp;
+
+  // each filtered row is prefixed with its filter type
+  bytebuf filtered;
+  filtered.resize((rowBytes + 1) * band.numRows);
+
+  bytebuf candidate, zeroes;
+  candidate.resize(rowBytes);
+  zeroes.resize(rowBytes);
+
+  for(uint32_t r = 0; r < band.numRows; r++)
+  {
+    uint32_t y = band.firstRow + r;
+    const byte *row = data.pixels + size_t(y) * data.rowPitch;
+    const byte *prev = y > 0 ? row - data.rowPitch : zeroes.data();
+
+    // pick the filter with the smallest sum of absolute differences, the usual heuristic
+    byte best = 0;
+    uint32_t bestSum = ~0U;
+    for(byte type = 0; type < 5; type++)
+    {
+      FilterRow(type, row, prev, bpp, rowBytes, candidate.data());
+
+      uint32_t sum = 0;
+      for(uint32_t i = 0; i < rowBytes; i++)
+        sum += (uint32_t)abs((int8_t)candidate[i]);
+
+      if(sum < bestSum)
+      {
+        bestSum = sum;
+        best = type;
+      }
+    }
+
+    byte *out = filtered.data() + (rowBytes + 1) * r;
+    out[0] = best;
+    FilterRow(best, row, prev, bpp, rowBytes, out + 1);
+  }
+
+  band.filteredSize = filtered.size();
+  band.adler = (uint32_t)mz_adler32(MZ_ADLER32_INIT, filtered.data(), filtered.size());
+
+  tdefl_compressor *comp = tdefl_compressor_alloc();
+  if(!comp)
+  {
+    band.success = false;
+    return;
+  }
+
+  // raw deflate, we write the zlib header and adler-32 ourselves
+  mz_uint flags =
+      tdefl_create_comp_flags_from_zip_params(pngCompressionLevel, -MZ_DEFAULT_WINDOW_BITS,
+                                              MZ_DEFAULT_STRATEGY);
+
+  band.deflated.reserve(filtered.size() / 2);
+
+  tdefl_init(comp, &AppendDeflated, &band.deflated, (int)flags);
+  tdefl_status status = tdefl_compress_buffer(comp, filtered.data(), filtered.size(),
+                                              last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+  tdefl_compressor_free(comp);
+
+  band.success = (status == (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY));
+}
+
+static void WriteBigEndian(byte *dst, uint32_t val)
+{
+  dst[0] = byte(val >> 24);
+  dst[1] = byte(val >> 16);
+  dst[2] = byte(val >> 8);
+  dst[3] = byte(val);
+}
+
+static void WriteChunk(StreamWriter *writer, const char *tag, const byte *prefix, size_t prefixLen,
+                       const bytebuf &payload, const byte *suffix, size_t suffixLen)
+{
+  byte lenAndTag[8];
+  WriteBigEndian(lenAndTag, uint32_t(prefixLen + payload.size() + suffixLen));
+  memcpy(lenAndTag + 4, tag, 4);
+
+  mz_ulong crc = mz_crc32(MZ_CRC32_INIT, lenAndTag + 4, 4);
+  crc = mz_crc32(crc, prefix, prefixLen);
+  crc = mz_crc32(crc, payload.data(), payload.size());
+  crc = mz_crc32(crc, suffix, suffixLen);
+
+  byte crcBytes[4];
+  WriteBigEndian(crcBytes, uint32_t(crc));
+
+  writer->Write(lenAndTag, sizeof(lenAndTag));
+  writer->Write(prefix, prefixLen);
+  writer->Write(payload.data(), payload.size());
+  writer->Write(suffix, suffixLen);
+  writer->Write(crcBytes, sizeof(crcBytes));
+}
+
+bool write_png_to_stream(StreamWriter *writer, const png_data &data, Threading::JobQueue *jobs)
+{
+  if(data.width == 0 || data.height == 0 || data.numComps < 1 || data.numComps > 4)
+  {
+    RDCERR("Invalid PNG parameters: %ux%u with %u components", data.width, data.height,
+           data.numComps);
+    return false;
+  }
+
+  const uint32_t rowBytes = data.width * data.numComps;
+  const uint32_t rowsPerBand = RDCMAX(1U, uint32_t(pngBandSize / (rowBytes + 1)));
+
+  rdcarray<PNGBand> bands;
+  bands.resize((data.height + rowsPerBand - 1) / rowsPerBand);
+
+  for(size_t i = 0; i < bands.size(); i++)
+  {
+    bands[i].firstRow = uint32_t(i) * rowsPerBand;
+    bands[i].numRows = RDCMIN(rowsPerBand, data.height - bands[i].firstRow);
+  }
+
+  Threading::ParallelFor(jobs, bands.size(), 1, [&data, &bands](size_t begin, size_t end) {
+    for(size_t i = begin; i < end; i++)
+      CompressBand(data, bands[i], i + 1 == bands.size());
+  });
+
+  uint32_t adler = MZ_ADLER32_INIT;
+  for(const PNGBand &band : bands)
+  {
+    if(!band.success)
+    {
+      RDCERR("Failed to compress PNG rows %u-%u", band.firstRow, band.firstRow + band.numRows);
+      return false;
+    }
+
+    adler = CombineAdler32(adler, band.adler, band.filteredSize);
+  }
+
+  static const byte signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+  writer->Write(signature, sizeof(signature));
+
+  // colour types for grey, grey+alpha, RGB and RGBA
+  static const byte colourTypes[] = {0, 4, 2, 6};
+
+  byte header[13] = {};
+  WriteBigEndian(header + 0, data.width);
+  WriteBigEndian(header + 4, data.height);
+  header[8] = 8;    // bit depth
+  header[9] = colourTypes[data.numComps - 1];
+  // compression, filter and interlace methods are all 0
+
+  WriteChunk(writer, "IHDR", header, sizeof(header), bytebuf(), NULL, 0);
+
+  // deflate with a 32kb window, 'fast' compression level. (0x785e % 31) == 0 as required
+  static const byte zlibHeader[] = {0x78, 0x5e};
+
+  byte adlerBytes[4];
+  WriteBigEndian(adlerBytes, adler);
+
+  for(size_t i = 0; i < bands.size(); i++)
+  {
+    bool first = (i == 0), last = (i + 1 == bands.size());
+    WriteChunk(writer, "IDAT", first ? zlibHeader : NULL, first ? sizeof(zlibHeader) : 0,
+               bands[i].deflated, last ? adlerBytes : NULL, last ? sizeof(adlerBytes) : 0);
+  }
+
+  WriteChunk(writer, "IEND", NULL, 0, bytebuf(), NULL, 0);
+
+  return !writer->IsErrored();
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+#include "stb/stb_image.h"
+
+TEST_CASE("Check parallel PNG writing round-trips", "[png]")
+{
+  Threading::JobQueue jobs;
+
+  // tall enough to be split into several bands, with a row pitch larger than the row
+  const uint32_t width = 301, height = 1500, pitch = width * 4 + 12;
+
+  bytebuf pixels;
+  pixels.resize(pitch * height);
+
+  uint32_t seed = 0x1234567;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width * 4; x++)
+    {
+      // mix smooth gradients with noise so that every filter type gets picked somewhere
+      seed = seed * 1103515245U + 12345U;
+      byte noise = byte(seed >> 16);
+      pixels[y * pitch + x] = (y / 100) % 2 ? noise : byte(x + y);
+    }
+  }
+
+  for(uint32_t numComps = 1; numComps <= 4; numComps++)
+  {
+    INFO("Components: " << numComps);
+
+    // pack the pixels down to the component count, keeping the padded pitch
+    bytebuf src;
+    src.resize(pitch * height);
+    for(uint32_t y = 0; y < height; y++)
+      for(uint32_t x = 0; x < width; x++)
+        memcpy(&src[y * pitch + x * numComps], &pixels[y * pitch + x * 4], numComps);
+
+    png_data data = {width, height, numComps, src.data(), pitch};
+
+    for(Threading::JobQueue *queue : {(Threading::JobQueue *)NULL, &jobs})
+    {
+      StreamWriter writer(1024);
+      REQUIRE(write_png_to_stream(&writer, data, queue));
+
+      int w = 0, h = 0, comp = 0;
+      byte *decoded = stbi_load_from_memory(writer.GetData(), (int)writer.GetOffset(), &w, &h,
+                                            &comp, 0);
+
+      REQUIRE(decoded);
+      CHECK(w == (int)width);
+      CHECK(h == (int)height);
+      CHECK(comp == (int)numComps);
+
+      bool match = true;
+      for(uint32_t y = 0; y < height; y++)
+        match &= memcmp(decoded + y * width * numComps, &src[y * pitch], width * numComps) == 0;
+
+      CHECK(match);
+
+      stbi_image_free(decoded);
+    }
+  }
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -0,0 +1,473 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "shader_cache.h"
+
+// the reflection cache has its own format rather than using LoadShaderCache/SaveShaderCache, so
+// that entries can be read individually instead of decompressing the whole file up front.
+static const uint32_t ShaderReflectionCacheMagic = MAKE_FOURCC('R', 'D', '$', 'R');
+
+// the global and driver magic numbers, the driver's version, then the offset of the index
+static const uint64_t ReflectionHeaderSize = sizeof(uint32_t) * 3 + sizeof(uint64_t);
+static const uint64_t ReflectionIndexOffsetLocation = sizeof(uint32_t) * 3;
+
+// the index holds the use counter and number of entries, then each entry's hash, offset, size,
+// checksum and last use
+static const uint64_t ReflectionIndexHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+static const uint64_t ReflectionIndexEntrySize = sizeof(uint64_t) * 2 + sizeof(uint64_t) +
+                                                 sizeof(uint32_t) + sizeof(uint64_t) +
+                                                 sizeof(uint64_t);
+
+ShaderReflectionCache::ShaderReflectionCache(const char *filename, uint32_t magicNumber,
+                                             uint32_t versionNumber, uint64_t maxSize)
+    : m_Filename(FileIO::GetAppFolderFilename(filename)),
+      m_Magic(magicNumber),
+      m_Version(versionNumber),
+      m_MaxSize(maxSize)
+{
+  m_File = FileIO::fopen(m_Filename.c_str(), "rb");
+
+  if(m_File && !LoadIndex())
+  {
+    // the file is missing, from a different version or corrupted. Start from scratch, it will be
+    // rewritten entirely if anything is inserted.
+    FileIO::fclose(m_File);
+    m_File = NULL;
+    m_Entries.clear();
+    m_Size = m_UnusedBytes = m_UseCounter = 0;
+  }
+}
+
+ShaderReflectionCache::~ShaderReflectionCache()
+{
+  if(m_Dirty)
+    Save();
+
+  if(m_File)
+    FileIO::fclose(m_File);
+}
+
+bool ShaderReflectionCache::LoadIndex()
+{
+  FileIO::fseek64(m_File, 0, SEEK_END);
+  m_FileSize = FileIO::ftell64(m_File);
+  FileIO::fseek64(m_File, 0, SEEK_SET);
+
+  uint32_t globalMagic = 0, localMagic = 0, version = 0;
+  uint64_t indexOffset = 0;
+
+  {
+    StreamReader header(m_File, RDCMIN(m_FileSize, ReflectionHeaderSize), Ownership::Nothing);
+    header.Read(globalMagic);
+    header.Read(localMagic);
+    header.Read(version);
+    header.Read(indexOffset);
+
+    if(header.IsErrored())
+      return false;
+  }
+
+  if(globalMagic != ShaderReflectionCacheMagic || localMagic != m_Magic || version != m_Version)
+    return false;
+
+  if(indexOffset < ReflectionHeaderSize || indexOffset > m_FileSize ||
+     m_FileSize - indexOffset < ReflectionIndexHeaderSize)
+  {
+    RDCERR("Invalid shader reflection cache index offset %llu", indexOffset);
+    return false;
+  }
+
+  FileIO::fseek64(m_File, indexOffset, SEEK_SET);
+  StreamReader index(m_File, m_FileSize - indexOffset, Ownership::Nothing);
+
+  uint32_t numEntries = 0;
+  index.Read(m_UseCounter);
+  index.Read(numEntries);
+
+  if(m_FileSize - indexOffset - ReflectionIndexHeaderSize <
+     uint64_t(numEntries) * ReflectionIndexEntrySize)
+  {
+    RDCERR("Shader reflection cache index with %u entries is truncated", numEntries);
+    return false;
+  }
+
+  for(uint32_t i = 0; i < numEntries; i++)
+  {
+    ShaderHash hash;
+    Entry entry;
+
+    index.Read(hash.hash[0]);
+    index.Read(hash.hash[1]);
+    index.Read(entry.offset);
+    index.Read(entry.size);
+    index.Read(entry.checksum);
+    index.Read(entry.lastUse);
+
+    // every entry must lie between the header and the index
+    if(entry.offset < ReflectionHeaderSize || entry.offset > indexOffset ||
+       indexOffset - entry.offset < entry.size || m_Entries.find(hash) != m_Entries.end())
+    {
+      RDCERR("Invalid entry %u in shader reflection cache index", i);
+      return false;
+    }
+
+    m_Size += entry.size;
+    m_Entries[hash] = entry;
+  }
+
+  if(index.IsErrored() || m_Size > indexOffset - ReflectionHeaderSize)
+    return false;
+
+  m_IndexOffset = indexOffset;
+  m_UnusedBytes = indexOffset - ReflectionHeaderSize - m_Size;
+
+  // the file may have been written with a higher limit
+  Evict(NULL);
+
+  return true;
+}
+
+bool ShaderReflectionCache::ReadEntry(const Entry &entry, bytebuf &data)
+{
+  data.resize(entry.size);
+
+  FileIO::fseek64(m_File, entry.offset, SEEK_SET);
+
+  return FileIO::fread(data.data(), 1, entry.size, m_File) == entry.size &&
+         XXH64(data.data(), data.size(), 0) == entry.checksum;
+}
+
+bool ShaderReflectionCache::Find(const ShaderHash &hash, bytebuf &data)
+{
+  SCOPED_LOCK(m_Lock);
+
+  auto it = m_Entries.find(hash);
+  if(it == m_Entries.end())
+    return false;
+
+  Entry &entry = it->second;
+
+  if(entry.offset == 0)
+  {
+    data = entry.data;
+  }
+  else if(!ReadEntry(entry, data))
+  {
+    RDCWARN("Couldn't read shader reflection cache entry, discarding it");
+
+    m_Size -= entry.size;
+    m_UnusedBytes += entry.size;
+    m_Entries.erase(it);
+    m_Dirty = true;
+    return false;
+  }
+
+  // the updated use is only saved with a new index, but keeps entries that are still being used
+  // from being evicted by ones that aren't.
+  entry.lastUse = ++m_UseCounter;
+  m_Dirty = true;
+
+  return true;
+}
+
+void ShaderReflectionCache::Insert(const ShaderHash &hash, const bytebuf &data)
+{
+  SCOPED_LOCK(m_Lock);
+
+  Entry &entry = m_Entries[hash];
+
+  // any previous data for this hash in the file is now unused
+  if(entry.offset != 0)
+    m_UnusedBytes += entry.size;
+  m_Size -= entry.size;
+
+  entry.offset = 0;
+  entry.size = (uint32_t)data.size();
+  entry.checksum = XXH64(data.data(), data.size(), 0);
+  entry.lastUse = ++m_UseCounter;
+  entry.data = data;
+
+  m_Size += entry.size;
+  m_Dirty = true;
+
+  Evict(&entry);
+}
+
+void ShaderReflectionCache::Evict(const Entry *keep)
+{
+  while(m_Size > m_MaxSize && !m_Entries.empty())
+  {
+    auto lru = m_Entries.end();
+    for(auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+    {
+      if(&it->second == keep)
+        continue;
+
+      if(lru == m_Entries.end() || it->second.lastUse < lru->second.lastUse)
+        lru = it;
+    }
+
+    if(lru == m_Entries.end())
+      break;
+
+    m_Size -= lru->second.size;
+    if(lru->second.offset != 0)
+      m_UnusedBytes += lru->second.size;
+    m_Entries.erase(lru);
+    m_Dirty = true;
+  }
+}
+
+void ShaderReflectionCache::Save()
+{
+  // the current index becomes unused too once a new one is written
+  const uint64_t unusedBytes = m_UnusedBytes + (m_FileSize - m_IndexOffset);
+
+  // normally new entries and the new index are appended, leaving the existing data where it is.
+  // Once more of the file would be unused than used, write a new file with only the current
+  // entries and move it into place.
+  const bool rewrite = (m_File == NULL || unusedBytes > m_Size);
+
+  rdcstr path = rewrite ? m_Filename + ".tmp" : m_Filename;
+
+  FILE *f = FileIO::fopen(path.c_str(), rewrite ? "wb" : "r+b");
+
+  if(!f)
+  {
+    RDCERR("Error opening shader reflection cache for write");
+    return;
+  }
+
+  const uint64_t start = rewrite ? 0 : m_FileSize;
+  uint64_t indexOffset = 0;
+  bool success = true;
+
+  FileIO::fseek64(f, start, SEEK_SET);
+
+  {
+    StreamWriter writer(f, Ownership::Nothing);
+
+    if(rewrite)
+    {
+      // the index offset is filled in once everything else has been written
+      writer.Write(ShaderReflectionCacheMagic);
+      writer.Write(m_Magic);
+      writer.Write(m_Version);
+      writer.Write(indexOffset);
+    }
+
+    bytebuf data;
+
+    for(auto it = m_Entries.begin(); it != m_Entries.end();)
+    {
+      Entry &entry = it->second;
+
+      // entries that are already in the file stay where they are, unless we're rewriting it
+      if(entry.offset != 0)
+      {
+        if(!rewrite)
+        {
+          ++it;
+          continue;
+        }
+
+        if(!ReadEntry(entry, data))
+        {
+          RDCWARN("Couldn't read shader reflection cache entry, discarding it");
+          m_Size -= entry.size;
+          it = m_Entries.erase(it);
+          continue;
+        }
+      }
+
+      const bytebuf &src = entry.offset != 0 ? data : entry.data;
+
+      entry.offset = start + writer.GetOffset();
+      writer.Write(src.data(), src.size());
+
+      ++it;
+    }
+
+    indexOffset = start + writer.GetOffset();
+
+    writer.Write(m_UseCounter);
+    writer.Write((uint32_t)m_Entries.size());
+
+    for(auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+    {
+      writer.Write(it->first.hash[0]);
+      writer.Write(it->first.hash[1]);
+      writer.Write(it->second.offset);
+      writer.Write(it->second.size);
+      writer.Write(it->second.checksum);
+      writer.Write(it->second.lastUse);
+    }
+
+    success = writer.Finish() && !writer.IsErrored();
+  }
+
+  // only point the header at the new index once everything it refers to is in the file, so if
+  // writing fails part way through the previous index is still intact.
+  if(success)
+  {
+    FileIO::fseek64(f, ReflectionIndexOffsetLocation, SEEK_SET);
+    success = FileIO::fwrite(&indexOffset, sizeof(indexOffset), 1, f) == 1;
+  }
+
+  success = (FileIO::fclose(f) == 0) && success;
+
+  if(rewrite)
+  {
+    // the old file has to be closed before it can be replaced
+    if(m_File)
+      FileIO::fclose(m_File);
+    m_File = NULL;
+
+    if(success)
+      success = FileIO::Move(path.c_str(), m_Filename.c_str(), true);
+
+    if(!success)
+      FileIO::Delete(path.c_str());
+  }
+
+  if(success)
+    RDCDEBUG("Wrote %zu entries totalling %llu bytes to shader reflection cache",
+             m_Entries.size(), m_Size);
+  else
+    RDCERR("Error writing shader reflection cache");
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Check shader reflection cache", "[shadercache]")
+{
+  const char *filename = "unittest_reflection.cache";
+  const uint32_t magic = MAKE_FOURCC('T', 'E', 'S', 'T');
+  const rdcstr path = FileIO::GetAppFolderFilename(filename);
+
+  FileIO::Delete(path.c_str());
+
+  auto makeHash = [](uint32_t i) {
+    ShaderHash hash;
+    hash.Hash(i);
+    return hash;
+  };
+
+  auto makeData = [](uint32_t i) {
+    bytebuf data;
+    data.resize(100 + i);
+    for(size_t b = 0; b < data.size(); b++)
+      data[b] = byte(b * 3 + i);
+    return data;
+  };
+
+  bytebuf data;
+
+  // room for three entries, but not four
+  const uint64_t maxSize = 400;
+
+  {
+    ShaderReflectionCache cache(filename, magic, 1, maxSize);
+    CHECK_FALSE(cache.Find(makeHash(0), data));
+
+    cache.Insert(makeHash(0), makeData(0));
+    cache.Insert(makeHash(1), makeData(1));
+    cache.Insert(makeHash(2), makeData(2));
+
+    // use entry 0 so that 1 is the least recently used when 3 pushes us over the limit
+    REQUIRE(cache.Find(makeHash(0), data));
+    CHECK(data == makeData(0));
+
+    cache.Insert(makeHash(3), makeData(3));
+
+    CHECK_FALSE(cache.Find(makeHash(1), data));
+  }
+
+  const uint64_t firstSize = FileIO::GetFileSize(path);
+  CHECK(firstSize > 0);
+
+  SECTION("Entries are read back from the file")
+  {
+    ShaderReflectionCache cache(filename, magic, 1, maxSize);
+
+    for(uint32_t i : {0, 2, 3})
+    {
+      REQUIRE(cache.Find(makeHash(i), data));
+      CHECK(data == makeData(i));
+    }
+    CHECK_FALSE(cache.Find(makeHash(1), data));
+  };
+
+  SECTION("New entries are appended")
+  {
+    {
+      ShaderReflectionCache cache(filename, magic, 1, maxSize);
+      REQUIRE(cache.Find(makeHash(0), data));
+      cache.Insert(makeHash(4), makeData(4));
+    }
+
+    CHECK(FileIO::GetFileSize(path) > firstSize);
+
+    ShaderReflectionCache cache(filename, magic, 1, maxSize);
+
+    for(uint32_t i : {0, 3, 4})
+    {
+      REQUIRE(cache.Find(makeHash(i), data));
+      CHECK(data == makeData(i));
+    }
+    CHECK_FALSE(cache.Find(makeHash(2), data));
+  };
+
+  SECTION("The file is rewritten once it's mostly unused")
+  {
+    for(uint32_t i = 4; i < 20; i++)
+    {
+      ShaderReflectionCache cache(filename, magic, 1, maxSize);
+      cache.Insert(makeHash(i), makeData(i));
+    }
+
+    // without rewriting the file would hold every entry ever inserted
+    CHECK(FileIO::GetFileSize(path) < maxSize * 3);
+
+    ShaderReflectionCache cache(filename, magic, 1, maxSize);
+
+    for(uint32_t i = 17; i < 20; i++)
+    {
+      REQUIRE(cache.Find(makeHash(i), data));
+      CHECK(data == makeData(i));
+    }
+  };
+
+  SECTION("A different version isn't loaded")
+  {
+    ShaderReflectionCache cache(filename, magic, 2, maxSize);
+    CHECK_FALSE(cache.Find(makeHash(0), data));
+  };
+
+  FileIO::Delete(path.c_str());
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -25,15 +25,18 @@
 #pragma once
 
 #include <map>
+#include "api/replay/version.h"
 #include "common/common.h"
+#include "common/threading.h"
 #include "serialise/streamio.h"
 #include "serialise/zstdio.h"
+#include "zstd/xxhash.h"
 
 static const uint32_t ShaderCacheMagic = MAKE_FOURCC('R', 'D', '$', '$');
 
-template <typename ResultType, typename ShaderCallbacks>
+template <typename KeyType, typename ResultType, typename ShaderCallbacks>
 bool LoadShaderCache(const char *filename, const uint32_t magicNumber, const uint32_t versionNumber,
-                     std::map<uint32_t, ResultType> &resultCache, const ShaderCallbacks &callbacks)
+                     std::map<KeyType, ResultType> &resultCache, const ShaderCallbacks &callbacks)
 {
   rdcstr shadercache = FileIO::GetAppFolderFilename(filename);
 
@@ -62,7 +65,8 @@ bool LoadShaderCache(const char *filename, const uint32_t magicNumber, const uin
 
   for(uint32_t i = 0; i < numentries; i++)
   {
-    uint32_t hash = 0, length = 0;
+    KeyType hash = KeyType();
+    uint32_t length = 0;
     compressedReader.Read(hash);
     compressedReader.Read(length);
 
@@ -85,9 +89,9 @@ bool LoadShaderCache(const char *filename, const uint32_t magicNumber, const uin
   return ret && !compressedReader.IsErrored() && !fileReader.IsErrored();
 }
 
-template <typename ResultType, typename ShaderCallbacks>
+template <typename KeyType, typename ResultType, typename ShaderCallbacks>
 void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versionNumber,
-                     const std::map<uint32_t, ResultType> &cache, const ShaderCallbacks &callbacks)
+                     const std::map<KeyType, ResultType> &cache, const ShaderCallbacks &callbacks)
 {
   rdcstr shadercache = FileIO::GetAppFolderFilename(filename);
 
@@ -111,7 +115,7 @@ void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versio
 
   // hash + length + data for each entry
   for(auto it = cache.begin(); it != cache.end(); ++it)
-    uncompressedSize += sizeof(uint32_t) * 2 + callbacks.GetSize(it->second);
+    uncompressedSize += sizeof(KeyType) + sizeof(uint32_t) + callbacks.GetSize(it->second);
 
   fileWriter.Write(uncompressedSize);
 
@@ -122,7 +126,7 @@ void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versio
 
   for(auto it = cache.begin(); it != cache.end(); ++it)
   {
-    uint32_t hash = it->first;
+    KeyType hash = it->first;
     uint32_t len = callbacks.GetSize(it->second);
     const byte *data = callbacks.GetData(it->second);
 
@@ -138,3 +142,90 @@ void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versio
   RDCDEBUG("Successfully wrote %u entries to cache, compressed from %llu to %llu", numentries,
            uncompressedSize, fileWriter.GetOffset());
 }
+
+// a strong hash identifying a shader blob along with anything else that affects what is derived
+// from it, like the entry point or specialisation. The build is always hashed in first so that
+// results are never reused by a different build that might process shaders differently.
+struct ShaderHash
+{
+  ShaderHash() { Hash(GitVersionHash, sizeof(GitVersionHash)); }
+  void Hash(const void *data, size_t length)
+  {
+    hash[0] = XXH64(data, length, hash[0]);
+    hash[1] = XXH64(data, length, hash[1] ^ 0x9e3779b97f4a7c15ULL);
+  }
+  void Hash(const rdcstr &str) { Hash(str.c_str(), str.size() + 1); }
+  template <typename T>
+  void Hash(const T &val)
+  {
+    RDCCOMPILE_ASSERT(std::is_trivially_copyable<T>::value, "Only plain types can be hashed");
+    Hash(&val, sizeof(val));
+  }
+  bool operator<(const ShaderHash &o) const
+  {
+    if(hash[0] != o.hash[0])
+      return hash[0] < o.hash[0];
+    return hash[1] < o.hash[1];
+  }
+
+  uint64_t hash[2] = {};
+};
+
+// a persistent cache of reflection data for shaders, so that reloading the same shaders - e.g.
+// opening the same capture again - doesn't need to parse them from scratch. The data stored is
+// opaque, each driver serialises whatever it needs.
+//
+// Only the index is read on creation, and each entry's data is read from the file when it's looked
+// up. The total size of the entries is capped by evicting the least recently used. On destruction
+// any new entries are appended to the file along with a new index, and the file is only rewritten
+// from scratch once more than half of it is unused.
+class ShaderReflectionCache
+{
+public:
+  static const uint64_t DefaultMaxSize = 64 * 1024 * 1024;
+
+  ShaderReflectionCache(const char *filename, uint32_t magicNumber, uint32_t versionNumber,
+                        uint64_t maxSize = DefaultMaxSize);
+  ~ShaderReflectionCache();
+
+  bool Find(const ShaderHash &hash, bytebuf &data);
+  void Insert(const ShaderHash &hash, const bytebuf &data);
+
+private:
+  struct Entry
+  {
+    // where the data is in the file, or 0 if it was inserted and hasn't been written yet
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    // hash of the data, to catch entries that have been overwritten or corrupted on disk
+    uint64_t checksum = 0;
+    // value of m_UseCounter when this was last found or inserted, for LRU eviction
+    uint64_t lastUse = 0;
+    // the data for an entry that hasn't been written yet
+    bytebuf data;
+  };
+
+  bool LoadIndex();
+  bool ReadEntry(const Entry &entry, bytebuf &data);
+  void Evict(const Entry *keep);
+  void Save();
+
+  rdcstr m_Filename;
+  uint32_t m_Magic, m_Version;
+  uint64_t m_MaxSize;
+
+  Threading::CriticalSection m_Lock;
+
+  // kept open to read entries as they're looked up, NULL if there's no valid file
+  FILE *m_File = NULL;
+  uint64_t m_FileSize = 0;
+  uint64_t m_IndexOffset = 0;
+  // bytes in the file that no current entry refers to, from evicted or replaced entries
+  uint64_t m_UnusedBytes = 0;
+
+  bool m_Dirty = false;
+  uint64_t m_UseCounter = 0;
+  // total size of all entries, whether in the file or not
+  uint64_t m_Size = 0;
+  std::map<ShaderHash, Entry> m_Entries;
+};
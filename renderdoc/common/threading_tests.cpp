@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include "common/job_queue.h"
 #include "common/threading.h"
 #include "os/os_specific.h"
 
@@ -71,4 +72,121 @@ TEST_CASE("Test spin lock", "[threading]")
   CHECK(finalValue == value);
 }
 
+TEST_CASE("Test job queue", "[threading]")
+{
+  SECTION("All jobs run exactly once")
+  {
+    rdcarray<int32_t> counts;
+    counts.resize(1000);
+
+    {
+      Threading::JobQueue queue(4);
+
+      for(int32_t &c : counts)
+        queue.Submit([&c]() { Atomic::Inc32(&c); });
+
+      queue.WaitAll();
+
+      for(int32_t c : counts)
+        CHECK(c == 1);
+    }
+  };
+
+  SECTION("Waiting on a job runs it if it hasn't started")
+  {
+    Threading::JobQueue queue(1);
+
+    int32_t blocker = 0;
+    uint64_t waitedThread = 0;
+
+    // occupy the only worker until we've waited on the second job
+    queue.Submit([&blocker]() {
+      while(Atomic::CmpExch32(&blocker, 1, 1) == 0)
+        Threading::Sleep(0);
+    });
+
+    Threading::JobHandle job =
+        queue.Submit([&waitedThread]() { waitedThread = Threading::GetCurrentID(); });
+
+    queue.Wait(job);
+
+    CHECK(waitedThread == Threading::GetCurrentID());
+
+    Atomic::Inc32(&blocker);
+  };
+
+  SECTION("Jobs can wait on other jobs")
+  {
+    Threading::JobQueue queue(2);
+
+    int32_t values[64] = {};
+    Threading::JobHandle jobs[64] = {};
+
+    for(int32_t i = 0; i < 64; i++)
+    {
+      Threading::JobHandle prev = i > 0 ? jobs[i - 1] : 0;
+      jobs[i] = queue.Submit([&queue, &values, prev, i]() {
+        queue.Wait(prev);
+        values[i] = (i > 0 ? values[i - 1] : 0) + 1;
+      });
+    }
+
+    queue.Wait(jobs[63]);
+
+    CHECK(values[63] == 64);
+  };
+
+  SECTION("Completed jobs can still be waited on")
+  {
+    Threading::JobQueue queue(2);
+
+    int32_t count = 0;
+
+    Threading::JobHandle job = queue.Submit([&count]() { Atomic::Inc32(&count); });
+
+    queue.WaitAll();
+
+    // the job has been freed by now, waiting on it again must return without running it again
+    queue.Wait(job);
+    queue.Wait(job);
+
+    CHECK(count == 1);
+  };
+}
+
+TEST_CASE("Test parallel for", "[threading]")
+{
+  Threading::JobQueue queue(4);
+
+  for(size_t count : {(size_t)0, (size_t)1, (size_t)7, (size_t)1000, (size_t)12345})
+  {
+    for(size_t minBatch : {(size_t)0, (size_t)1, (size_t)16, (size_t)5000})
+    {
+      rdcarray<int32_t> counts;
+      counts.resize(count);
+
+      Threading::ParallelFor(&queue, count, minBatch, [&counts](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; i++)
+          Atomic::Inc32(&counts[i]);
+      });
+
+      for(int32_t c : counts)
+        CHECK(c == 1);
+    }
+  }
+
+  // no queue runs everything in one batch on this thread
+  uint64_t thread = 0;
+  size_t batches = 0;
+  Threading::ParallelFor(NULL, 100, 1, [&thread, &batches](size_t begin, size_t end) {
+    thread = Threading::GetCurrentID();
+    batches++;
+    CHECK(begin == 0);
+    CHECK(end == 100);
+  });
+
+  CHECK(batches == 1);
+  CHECK(thread == Threading::GetCurrentID());
+}
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
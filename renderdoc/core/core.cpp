@@ -49,6 +49,15 @@
 RDOC_DEBUG_CONFIG(bool, Capture_Debug_SnapshotDiagnosticLog, false,
                   "Snapshot the diagnostic log at capture time and embed in the capture.");
 
+RDOC_CONFIG(uint32_t, Capture_RollingFrameCount, 0,
+            "If non-zero, every frame is captured and the most recent N are kept in a rolling "
+            "window in memory. Triggering a capture then writes the most recently completed "
+            "frames to disk instead of capturing upcoming ones.");
+
+RDOC_CONFIG(uint32_t, Capture_RollingMemoryLimitMB, 1024,
+            "The maximum memory in MB used to hold frames in the rolling capture window. The "
+            "oldest frames are dropped first, but the most recent frame is always kept.");
+
 void LogReplayOptions(const ReplayOptions &opts)
 {
   RDCLOG("%s API validation during replay", (opts.apiValidation ? "Enabling" : "Not enabling"));
@@ -252,6 +261,8 @@ rdcstr DoStringise(const SystemChunk &el)
     STRINGISE_ENUM_CLASS_NAMED(CaptureBegin, "Internal: Beginning of Capture");
     STRINGISE_ENUM_CLASS_NAMED(CaptureScope, "Internal: Frame Metadata");
     STRINGISE_ENUM_CLASS_NAMED(CaptureEnd, "Internal: End of Capture");
+    STRINGISE_ENUM_CLASS_NAMED(DegradedInitialContents,
+                               "Internal: Initial Contents Dropped for Capture Size");
   }
   END_ENUM_STRINGISE();
 }
@@ -501,6 +512,9 @@ RenderDoc::~RenderDoc()
     }
   }
 
+  for(size_t i = 0; i < m_RollingCaptures.size(); i++)
+    delete m_RollingCaptures[i].rdc;
+
   RDCSTOPLOGGING();
 
   if(m_RemoteThread)
@@ -948,6 +962,10 @@ rdcstr RenderDoc::GetOverlayText(RDCDriver driver, uint32_t frameNumber, int fla
     {
       overlayText += StringFormat::Fmt("%d Captures saved.\n", (uint32_t)m_Captures.size());
 
+      if(Capture_RollingFrameCount() > 0)
+        overlayText += StringFormat::Fmt("Rolling capture of the last %u frames.\n",
+                                         Capture_RollingFrameCount());
+
       uint64_t now = Timing::GetUnixTimestamp();
       for(size_t i = 0; i < m_Captures.size(); i++)
       {
@@ -1016,6 +1034,7 @@ void RenderDoc::QueueCapture(uint32_t frameNumber)
 bool RenderDoc::ShouldTriggerCapture(uint32_t frameNumber)
 {
   bool ret = m_Cap > 0;
+  uint32_t numFrames = m_Cap;
 
   if(m_Cap > 0)
     m_Cap--;
@@ -1040,9 +1059,111 @@ bool RenderDoc::ShouldTriggerCapture(uint32_t frameNumber)
     }
   }
 
+  if(IsRollingCapture())
+  {
+    // in rolling mode every frame is captured, and a trigger keeps the most recently completed
+    // frames instead. A multi-frame trigger keeps that many frames from the window at once.
+    m_Cap = 0;
+
+    if(ret)
+      KeepRollingCaptures(RDCMAX(numFrames, 1U));
+
+    return true;
+  }
+
   return ret;
 }
 
+bool RenderDoc::IsRollingCapture() const
+{
+  return Capture_RollingFrameCount() > 0;
+}
+
+void RenderDoc::AddRollingCapture(RDCFile *rdc, uint32_t frameNumber)
+{
+  SCOPED_LOCK(m_CaptureLock);
+
+  uint64_t size = 0;
+  for(int i = 0; i < rdc->NumSections(); i++)
+    size += rdc->GetSectionProperties(i).uncompressedSize;
+
+  m_RollingCaptures.push_back({rdc, frameNumber, size});
+  m_RollingCapturesSize += size;
+
+  const uint64_t limit = uint64_t(Capture_RollingMemoryLimitMB()) * 1024 * 1024;
+
+  while(m_RollingCaptures.size() > 1 && (m_RollingCaptures.size() > Capture_RollingFrameCount() ||
+                                         m_RollingCapturesSize > limit))
+  {
+    m_RollingCapturesSize -= m_RollingCaptures[0].size;
+    delete m_RollingCaptures[0].rdc;
+    m_RollingCaptures.erase(0);
+  }
+}
+
+void RenderDoc::KeepRollingCaptures(uint32_t numFrames)
+{
+  SCOPED_LOCK(m_CaptureLock);
+
+  if(m_RollingCaptures.empty())
+  {
+    RDCWARN("No completed frames in rolling capture window to keep");
+    return;
+  }
+
+  size_t first = m_RollingCaptures.size() - RDCMIN((size_t)numFrames, m_RollingCaptures.size());
+
+  for(size_t i = first; i < m_RollingCaptures.size(); i++)
+  {
+    RDCFile *rdc = m_RollingCaptures[i].rdc;
+    uint32_t frameNumber = m_RollingCaptures[i].frameNumber;
+
+    m_RollingCapturesSize -= m_RollingCaptures[i].size;
+
+    rdcstr path = StringFormat::Fmt("%s_frame%u.rdc", m_CaptureFileTemplate.c_str(), frameNumber);
+
+    RDCFile output;
+    output.SetData(rdc->GetDriver(), rdc->GetDriverName().c_str(), rdc->GetMachineIdent(),
+                   &rdc->GetThumbnail(), rdc->GetTimestampBase(), rdc->GetTimestampFrequency());
+
+    FileIO::CreateParentDirectory(path);
+
+    output.Create(path.c_str());
+
+    bool success = output.ErrorCode() == ContainerError::NoError;
+
+    for(int s = 0; success && s < rdc->NumSections(); s++)
+    {
+      StreamWriter *writer = output.WriteSection(rdc->GetSectionProperties(s));
+      StreamReader *reader = rdc->ReadSection(s);
+
+      StreamTransfer(writer, reader, NULL);
+
+      writer->Finish();
+
+      success = !writer->IsErrored() && !reader->IsErrored();
+
+      delete reader;
+      delete writer;
+    }
+
+    delete rdc;
+
+    if(!success)
+    {
+      RDCERR("Couldn't write rolling capture of frame %u to '%s'", frameNumber, path.c_str());
+      continue;
+    }
+
+    RDCLOG("Keeping rolling capture of frame %u: %s", frameNumber, path.c_str());
+
+    m_Captures.push_back(
+        CaptureData(path, Timing::GetUnixTimestamp(), output.GetDriver(), frameNumber));
+  }
+
+  m_RollingCaptures.resize(first);
+}
+
 void RenderDoc::ResamplePixels(const FramePixels &in, RDCThumb &out)
 {
   if(in.width == 0 || in.height == 0)
@@ -1212,6 +1333,10 @@ RDCFile *RenderDoc::CreateRDC(RDCDriver driver, uint32_t frameNum, const FramePi
   ret->SetData(driver, ToStr(driver).c_str(), OSUtility::GetMachineIdent(), &outPng, m_TimeBase,
                m_TimeFrequency);
 
+  // rolling captures are kept in memory, and only written to disk in KeepRollingCaptures
+  if(IsRollingCapture())
+    return ret;
+
   FileIO::CreateParentDirectory(m_CurrentLogFile);
 
   ret->Create(m_CurrentLogFile.c_str());
@@ -1715,15 +1840,24 @@ void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
       delete w;
     }
 
-    RDCLOG("Written to disk: %s", m_CurrentLogFile.c_str());
-
-    CaptureData cap(m_CurrentLogFile, Timing::GetUnixTimestamp(), rdc->GetDriver(), frameNumber);
+    if(IsRollingCapture())
     {
-      SCOPED_LOCK(m_CaptureLock);
-      m_Captures.push_back(cap);
+      // ownership passes to the rolling window
+      AddRollingCapture(rdc, frameNumber);
     }
+    else
+    {
+      RDCLOG("Written to disk: %s", m_CurrentLogFile.c_str());
 
-    delete rdc;
+      CaptureData cap(m_CurrentLogFile, Timing::GetUnixTimestamp(), rdc->GetDriver(),
+                      frameNumber);
+      {
+        SCOPED_LOCK(m_CaptureLock);
+        m_Captures.push_back(cap);
+      }
+
+      delete rdc;
+    }
   }
   else
   {
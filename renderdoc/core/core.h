@@ -168,6 +168,7 @@ enum class SystemChunk : uint32_t
   CaptureBegin,
   CaptureScope,
   CaptureEnd,
+  DegradedInitialContents,
 
   FirstDriverChunk = 1000,
 };
@@ -568,6 +569,8 @@ public:
   const rdcarray<RENDERDOC_InputButton> &GetFocusKeys() { return m_FocusKeys; }
   const rdcarray<RENDERDOC_InputButton> &GetCaptureKeys() { return m_CaptureKeys; }
   bool ShouldTriggerCapture(uint32_t frameNumber);
+  bool IsRollingCapture() const;
+  void KeepRollingCaptures(uint32_t numFrames);
 
   enum
   {
@@ -610,6 +613,18 @@ private:
 
   rdcarray<uint32_t> m_QueuedFrameCaptures;
 
+  // completed frames in the rolling window, oldest first, when Capture_RollingFrameCount is set.
+  // These are held in memory and only written to disk when a capture is triggered
+  struct RollingCapture
+  {
+    RDCFile *rdc;
+    uint32_t frameNumber;
+    uint64_t size;
+  };
+  rdcarray<RollingCapture> m_RollingCaptures;
+  uint64_t m_RollingCapturesSize = 0;
+  void AddRollingCapture(RDCFile *rdc, uint32_t frameNumber);
+
   uint32_t m_RemoteIdent;
   Threading::ThreadHandle m_RemoteThread;
 
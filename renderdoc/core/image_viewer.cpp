@@ -22,14 +22,18 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include "common/block_decode.h"
 #include "common/dds_readwrite.h"
+#include "common/job_queue.h"
 #include "core/core.h"
 #include "maths/formatpacking.h"
+#include "maths/half_convert.h"
 #include "replay/replay_driver.h"
 #include "serialise/rdcfile.h"
 #include "stb/stb_image.h"
 #include "strings/string_utils.h"
 #include "tinyexr/tinyexr.h"
+#include "zstd/xxhash.h"
 
 class ImageViewer : public IReplayDriver
 {
@@ -52,6 +56,8 @@ public:
     d.eventId = 1;
     d.name = filename;
 
+    m_Watch = FileIO::filewatch_open(m_Filename);
+
     RefreshFile();
 
     m_Resources.push_back(ResourceDescription());
@@ -66,6 +72,7 @@ public:
 
   virtual ~ImageViewer()
   {
+    FileIO::filewatch_close(m_Watch);
     m_Proxy->Shutdown();
     m_Proxy = NULL;
   }
@@ -189,6 +196,7 @@ public:
       RDCASSERT(idx < m_RealTexData.size(), idx, m_RealTexData.size(), m_TexDetails.mips, sub.slice,
                 sub.mip);
       data = m_RealTexData[idx];
+      CropTextureData(m_TexDetails, sub, params, data);
       return;
     }
 
@@ -283,12 +291,22 @@ public:
   {
     return new ShaderDebugTrace();
   }
+  rdcarray<PixelDebugSummary> DebugPixels(uint32_t eventId, uint32_t x, uint32_t y, uint32_t width,
+                                          uint32_t height, uint32_t sample, uint32_t primitive)
+  {
+    return {};
+  }
   ShaderDebugTrace *DebugThread(uint32_t eventId, const uint32_t groupid[3],
                                 const uint32_t threadid[3])
   {
     return new ShaderDebugTrace();
   }
   rdcarray<ShaderDebugState> ContinueDebug(ShaderDebugger *debugger) { return {}; }
+  rdcarray<ShaderDebugState> ContinueDebugToCondition(ShaderDebugger *debugger,
+                                                      const ShaderDebugStopCondition &condition)
+  {
+    return {};
+  }
   void FreeDebugger(ShaderDebugger *debugger) { delete debugger; }
   void BuildTargetShader(ShaderEncoding sourceEncoding, const bytebuf &source, const rdcstr &entry,
                          const ShaderCompileFlags &compileFlags, ShaderStage type, ResourceId &id,
@@ -323,7 +341,13 @@ public:
     RDCERR("Calling proxy-render functions on an image viewer");
   }
 
-  void FileChanged() { RefreshFile(); }
+  void FileChanged()
+  {
+    // skip even re-reading the file if we know it hasn't been touched
+    if(FileIO::filewatch_changed(m_Watch))
+      RefreshFile();
+  }
+
 private:
   void RefreshFile();
 
@@ -340,127 +364,313 @@ private:
   // if we remapped the texture for display, this contains the real data to return from
   // GetTextureData()
   rdcarray<bytebuf> m_RealTexData;
+
+  FileIO::FileWatchHandle *m_Watch = NULL;
+
+  // hashes of the file and of each DDS subresource's data as last uploaded, so that rewrites only
+  // reload what actually changed.
+  uint64_t m_FileHash = 0;
+  rdcarray<uint64_t> m_SubresourceHashes;
 };
 
-ReplayStatus IMG_CreateReplayDevice(RDCFile *rdc, IReplayDriver **driver)
+// hashes the whole contents of f, leaving it positioned at the start
+static uint64_t HashFileContents(FILE *f)
 {
-  if(!rdc)
-    return ReplayStatus::InternalError;
+  XXH64_state_t *state = XXH64_createState();
+  XXH64_reset(state, 0);
 
-  rdcstr filename;
-  FILE *f = rdc->StealImageFileHandle(filename);
+  bytebuf chunk;
+  chunk.resize(1024 * 1024);
 
-  byte headerBuffer[4];
-  const size_t headerSize = FileIO::fread(headerBuffer, 1, 4, f);
   FileIO::fseek64(f, 0, SEEK_SET);
 
-  if(!f)
-    return ReplayStatus::FileIOFailed;
+  for(;;)
+  {
+    size_t numRead = FileIO::fread(chunk.data(), 1, chunk.size(), f);
+    if(numRead == 0)
+      break;
+    XXH64_update(state, chunk.data(), numRead);
+  }
 
-  // make sure the file is a type we recognise before going further
-  if(is_exr_file(f))
+  FileIO::fseek64(f, 0, SEEK_SET);
+
+  uint64_t ret = XXH64_digest(state);
+  XXH64_freeState(state);
+  return ret;
+}
+
+// how much of an EXR file to read at first when only the header is needed. It's read in growing
+// chunks until the header parses, so this only needs to cover typical headers.
+static const uint64_t exrHeaderReadSize = 64 * 1024;
+
+// parses the EXR version and header from the start of the file, which is all that buffer needs to
+// contain. Errors are only logged if requested, so that callers can retry with more of the file.
+static bool ParseEXRFile(const bytebuf &buffer, bool logErrors, EXRHeader &exrHeader)
+{
+  EXRVersion exrVersion;
+  int ret = ParseEXRVersionFromMemory(&exrVersion, buffer.data(), buffer.size());
+
+  if(ret != 0)
   {
-    const char *err = NULL;
+    if(logErrors)
+      RDCERR("EXR file detected, but couldn't load with ParseEXRVersionFromMemory: %d", ret);
+    return false;
+  }
 
-    FileIO::fseek64(f, 0, SEEK_END);
-    uint64_t size = FileIO::ftell64(f);
-    FileIO::fseek64(f, 0, SEEK_SET);
+  if(exrVersion.multipart || exrVersion.non_image)
+  {
+    if(logErrors)
+      RDCERR("Unsupported EXR file detected - multipart or similar.");
+    return false;
+  }
 
-    bytebuf buffer;
-    buffer.resize((size_t)size);
+  const char *err = NULL;
 
-    FileIO::fread(&buffer[0], 1, buffer.size(), f);
+  ret = ParseEXRHeaderFromMemory(&exrHeader, &exrVersion, buffer.data(), buffer.size(), &err);
 
-    EXRVersion exrVersion;
-    int ret = ParseEXRVersionFromMemory(&exrVersion, buffer.data(), buffer.size());
+  if(ret != 0)
+  {
+    if(logErrors)
+      RDCERR("EXR file detected, but couldn't load with ParseEXRHeaderFromMemory %d: '%s'", ret, err);
+    return false;
+  }
 
-    if(ret != 0)
+  if(exrHeader.tiled && exrHeader.tile_level_mode != TINYEXR_TILE_ONE_LEVEL)
+  {
+    if(logErrors)
+      RDCERR("Unsupported EXR file detected - tiled with mip or rip levels.");
+    return false;
+  }
+
+  return true;
+}
+
+// copies rows of planar EXR channels into interleaved RGBA, with pitches in texels
+template <typename T>
+static void InterleaveEXRChannels(unsigned char *const *planes, const int channels[4], T one,
+                                  size_t srcPitch, size_t width, size_t rowBegin, size_t rowEnd,
+                                  T *dst, size_t dstPitch)
+{
+  for(size_t y = rowBegin; y < rowEnd; y++)
+  {
+    T *rgba = dst + y * dstPitch * 4;
+
+    for(int c = 0; c < 4; c++)
     {
-      RDCERR("EXR file detected, but couldn't load with ParseEXRVersionFromMemory: %d", ret);
-      FileIO::fclose(f);
-      return ReplayStatus::ImageUnsupported;
+      if(channels[c] >= 0)
+      {
+        const T *src = (const T *)planes[channels[c]] + y * srcPitch;
+        for(size_t x = 0; x < width; x++)
+          rgba[x * 4 + c] = src[x];
+      }
+      else
+      {
+        // RGB channels default to 0, alpha defaults to 1
+        const T def = c < 3 ? T(0) : one;
+        for(size_t x = 0; x < width; x++)
+          rgba[x * 4 + c] = def;
+      }
+    }
+  }
+}
+
+// decodes an EXR file to RGBA data allocated with malloc. Images that only have half channels are
+// kept as half rather than expanded to float, and the file contents are freed before the RGBA data
+// is allocated, so that the encoded file, decoded channels and RGBA data are never all in memory.
+static byte *LoadEXRImage(FILE *f, uint64_t fileSize, TextureDescription &texDetails,
+                          size_t &datasize)
+{
+  EXRHeader exrHeader;
+  InitEXRHeader(&exrHeader);
+
+  EXRImage exrImage;
+  InitEXRImage(&exrImage);
+
+  int channels[4] = {-1, -1, -1, -1};
+  bool useHalf = true;
+
+  {
+    bytebuf buffer;
+    buffer.resize((size_t)fileSize);
+
+    FileIO::fseek64(f, 0, SEEK_SET);
+    FileIO::fread(buffer.data(), 1, buffer.size(), f);
+
+    if(!ParseEXRFile(buffer, true, exrHeader))
+    {
+      FreeEXRHeader(&exrHeader);
+      return NULL;
     }
 
-    if(exrVersion.multipart || exrVersion.non_image || exrVersion.tiled)
+    for(int i = 0; i < exrHeader.num_channels; i++)
     {
-      RDCERR("Unsupported EXR file detected - multipart or similar.");
-      FileIO::fclose(f);
-      return ReplayStatus::ImageUnsupported;
+      // integer channels can't be displayed as colour
+      if(exrHeader.channels[i].pixel_type == TINYEXR_PIXELTYPE_UINT)
+        continue;
+
+      switch(exrHeader.channels[i].name[0])
+      {
+        case 'R': channels[0] = i; break;
+        case 'G': channels[1] = i; break;
+        case 'B': channels[2] = i; break;
+        case 'A': channels[3] = i; break;
+      }
     }
 
-    EXRHeader exrHeader;
-    InitEXRHeader(&exrHeader);
+    for(int c = 0; c < 4; c++)
+      if(channels[c] >= 0 && exrHeader.channels[channels[c]].pixel_type != TINYEXR_PIXELTYPE_HALF)
+        useHalf = false;
 
-    ret = ParseEXRHeaderFromMemory(&exrHeader, &exrVersion, buffer.data(), buffer.size(), &err);
+    if(!useHalf)
+    {
+      for(int c = 0; c < 4; c++)
+        if(channels[c] >= 0)
+          exrHeader.requested_pixel_types[channels[c]] = TINYEXR_PIXELTYPE_FLOAT;
+    }
 
+    const char *err = NULL;
+
+    int ret = LoadEXRImageFromMemory(&exrImage, &exrHeader, buffer.data(), buffer.size(), &err);
     if(ret != 0)
     {
-      RDCERR("EXR file detected, but couldn't load with ParseEXRHeaderFromMemory %d: '%s'", ret, err);
-      FileIO::fclose(f);
-      return ReplayStatus::ImageUnsupported;
+      RDCERR("EXR file detected, but couldn't load with LoadEXRImageFromMemory %d: '%s'", ret, err);
+      FreeEXRHeader(&exrHeader);
+      return NULL;
     }
   }
-  else if(stbi_is_hdr_from_file(f))
+
+  texDetails.width = exrImage.width;
+  texDetails.height = exrImage.height;
+  texDetails.format.compByteWidth = useHalf ? 2 : 4;
+  texDetails.format.compCount = 4;
+  texDetails.format.compType = CompType::Float;
+  texDetails.format.type = ResourceFormatType::Regular;
+
+  datasize = size_t(texDetails.width) * texDetails.height * 4 * texDetails.format.compByteWidth;
+  byte *data = (byte *)malloc(datasize);
+
+  const size_t width = texDetails.width;
+  const uint16_t halfOne = ConvertToHalf(1.0f);
+
+  auto interleave = [&](unsigned char *const *planes, size_t srcPitch, size_t rowWidth,
+                        size_t rowBegin, size_t rowEnd, size_t dstOffset) {
+    if(useHalf)
+      InterleaveEXRChannels<uint16_t>(planes, channels, halfOne, srcPitch, rowWidth, rowBegin,
+                                      rowEnd, (uint16_t *)data + dstOffset * 4, width);
+    else
+      InterleaveEXRChannels<float>(planes, channels, 1.0f, srcPitch, rowWidth, rowBegin, rowEnd,
+                                   (float *)data + dstOffset * 4, width);
+  };
+
+  Threading::JobQueue jobs;
+
+  if(exrHeader.tiled)
   {
-    FileIO::fseek64(f, 0, SEEK_SET);
+    // tiles are always allocated at the full tile size, even if they're clipped by the image edge
+    const size_t tileWidth = exrHeader.tile_size_x;
+    const size_t tileHeight = exrHeader.tile_size_y;
 
-    int ignore = 0;
-    float *data = stbi_loadf_from_file(f, &ignore, &ignore, &ignore, 4);
+    Threading::ParallelFor(&jobs, exrImage.num_tiles, 1, [&](size_t begin, size_t end) {
+      for(size_t t = begin; t < end; t++)
+      {
+        const EXRTile &tile = exrImage.tiles[t];
+        const size_t x = tile.offset_x * tileWidth;
+        const size_t y = tile.offset_y * tileHeight;
+        interleave(tile.images, tileWidth, tile.width, 0, tile.height, y * width + x);
+      }
+    });
+  }
+  else
+  {
+    const size_t minRows = RDCMAX((size_t)1U, (64U * 1024U) / RDCMAX((size_t)1U, width));
+
+    Threading::ParallelFor(&jobs, texDetails.height, minRows, [&](size_t begin, size_t end) {
+      interleave(exrImage.images, width, width, begin, end, 0);
+    });
+  }
+
+  FreeEXRImage(&exrImage);
+  FreeEXRHeader(&exrHeader);
+
+  return data;
+}
+
+ReplayStatus IMG_CreateReplayDevice(RDCFile *rdc, IReplayDriver **driver)
+{
+  if(!rdc)
+    return ReplayStatus::InternalError;
+
+  rdcstr filename;
+  FILE *f = rdc->StealImageFileHandle(filename);
+
+  if(!f)
+    return ReplayStatus::FileIOFailed;
+
+  byte headerBuffer[4];
+  const size_t headerSize = FileIO::fread(headerBuffer, 1, 4, f);
+  FileIO::fseek64(f, 0, SEEK_SET);
+
+  // make sure the file is a type we recognise before going further. Only the headers are checked
+  // here, the image itself is decoded once when the viewer loads it.
+  if(is_exr_file(f))
+  {
+    FileIO::fseek64(f, 0, SEEK_END);
+    uint64_t size = FileIO::ftell64(f);
 
-    if(!data)
+    bytebuf buffer;
+    uint64_t readSize = 0;
+    bool parsed = false;
+
+    // the header is at the start of the file, so read only as much as we need to parse it
+    do
+    {
+      readSize = RDCMIN(size, RDCMAX(readSize * 4, exrHeaderReadSize));
+
+      buffer.resize((size_t)readSize);
+      FileIO::fseek64(f, 0, SEEK_SET);
+      FileIO::fread(buffer.data(), 1, buffer.size(), f);
+
+      EXRHeader exrHeader;
+      InitEXRHeader(&exrHeader);
+
+      parsed = ParseEXRFile(buffer, readSize == size, exrHeader);
+
+      FreeEXRHeader(&exrHeader);
+    } while(!parsed && readSize < size);
+
+    if(!parsed)
     {
       FileIO::fclose(f);
-      RDCERR("HDR file recognised, but couldn't load with stbi_loadf_from_file");
       return ReplayStatus::ImageUnsupported;
     }
-
-    free(data);
   }
   else if(is_dds_file(headerBuffer, headerSize))
   {
-    FileIO::fseek64(f, 0, SEEK_SET);
     StreamReader reader(f);
-    dds_data read_data = load_dds_from_file(&reader);
+    dds_data read_data = load_dds_header(&reader);
     f = NULL;
 
-    if(read_data.subdata == NULL)
+    if(read_data.subsizes == NULL)
     {
       RDCERR("DDS file recognised, but couldn't load");
       return ReplayStatus::ImageUnsupported;
     }
 
-    for(uint32_t i = 0; i < read_data.slices * read_data.mips; i++)
-      delete[] read_data.subdata[i];
-
-    delete[] read_data.subdata;
     delete[] read_data.subsizes;
   }
   else
   {
-    FileIO::fseek64(f, 0, SEEK_SET);
-
     int width = 0, height = 0;
     int ignore = 0;
     int ret = stbi_info_from_file(f, &width, &height, &ignore);
 
     // just in case (we shouldn't have come in here if this weren't true), make sure
-    // the format is supported
+    // the format is supported. This covers HDR files too.
     if(ret == 0 || width <= 0 || width >= 65536 || height <= 0 || height >= 65536)
     {
       FileIO::fclose(f);
       return ReplayStatus::ImageUnsupported;
     }
-
-    byte *data = stbi_load_from_file(f, &ignore, &ignore, &ignore, 4);
-
-    if(!data)
-    {
-      FileIO::fclose(f);
-      RDCERR("File recognised, but couldn't load with stbi_load_from_file");
-      return ReplayStatus::ImageUnsupported;
-    }
-
-    free(data);
   }
 
   if(f != NULL)
@@ -547,105 +757,18 @@ void ImageViewer::RefreshFile()
   uint64_t fileSize = FileIO::ftell64(f);
   FileIO::fseek64(f, 0, SEEK_SET);
 
-  if(is_exr_file(f))
+  // tools often rewrite their outputs without changing them, which needs nothing reloaded. This is
+  // far cheaper than decoding the image again.
+  const uint64_t fileHash = HashFileContents(f);
+  if(m_TextureID != ResourceId() && fileHash == m_FileHash)
   {
-    texDetails.format = rgba32_float;
-
-    FileIO::fseek64(f, 0, SEEK_SET);
-
-    bytebuf buffer;
-    buffer.resize((size_t)fileSize);
-
-    FileIO::fread(buffer.data(), 1, buffer.size(), f);
-
-    EXRVersion exrVersion;
-    int ret = ParseEXRVersionFromMemory(&exrVersion, buffer.data(), buffer.size());
-
-    if(ret != 0)
-    {
-      RDCERR("EXR file detected, but couldn't load with ParseEXRVersionFromMemory: %d", ret);
-      FileIO::fclose(f);
-      return;
-    }
-
-    if(exrVersion.multipart || exrVersion.non_image || exrVersion.tiled)
-    {
-      RDCERR("Unsupported EXR file detected - multipart or similar.");
-      FileIO::fclose(f);
-      return;
-    }
-
-    EXRHeader exrHeader;
-    InitEXRHeader(&exrHeader);
-
-    const char *err = NULL;
-
-    ret = ParseEXRHeaderFromMemory(&exrHeader, &exrVersion, buffer.data(), buffer.size(), &err);
-    if(ret != 0)
-    {
-      RDCERR("EXR file detected, but couldn't load with ParseEXRHeaderFromMemory %d: '%s'", ret, err);
-      FileIO::fclose(f);
-      return;
-    }
-
-    for(int i = 0; i < exrHeader.num_channels; i++)
-      exrHeader.requested_pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT;
-
-    EXRImage exrImage;
-    InitEXRImage(&exrImage);
-
-    ret = LoadEXRImageFromMemory(&exrImage, &exrHeader, buffer.data(), buffer.size(), &err);
-    if(ret != 0)
-    {
-      RDCERR("EXR file detected, but couldn't load with LoadEXRImageFromMemory %d: '%s'", ret, err);
-      FileIO::fclose(f);
-      return;
-    }
-
-    texDetails.width = exrImage.width;
-    texDetails.height = exrImage.height;
-
-    datasize = texDetails.width * texDetails.height * 4 * sizeof(float);
-    data = (byte *)malloc(datasize);
-
-    int channels[4] = {-1, -1, -1, -1};
-    for(int i = 0; i < exrImage.num_channels; i++)
-    {
-      switch(exrHeader.channels[i].name[0])
-      {
-        case 'R': channels[0] = i; break;
-        case 'G': channels[1] = i; break;
-        case 'B': channels[2] = i; break;
-        case 'A': channels[3] = i; break;
-      }
-    }
-
-    float *rgba = (float *)data;
-    float **src = (float **)exrImage.images;
-
-    for(uint32_t i = 0; i < texDetails.width * texDetails.height; i++)
-    {
-      for(int c = 0; c < 4; c++)
-      {
-        if(channels[c] >= 0)
-          rgba[i * 4 + c] = src[channels[c]][i];
-        else if(c < 3)    // RGB channels default to 0
-          rgba[i * 4 + c] = 0.0f;
-        else    // alpha defaults to 1
-          rgba[i * 4 + c] = 1.0f;
-      }
-    }
-
-    ret = FreeEXRImage(&exrImage);
+    FileIO::fclose(f);
+    return;
+  }
 
-    // shouldn't get here but let's be safe
-    if(ret != 0)
-    {
-      free(data);
-      RDCERR("EXR file detected, but couldn't load with LoadEXRFromMemory %d: '%s'", ret, err);
-      FileIO::fclose(f);
-      return;
-    }
+  if(is_exr_file(f))
+  {
+    data = LoadEXRImage(f, fileSize, texDetails, datasize);
   }
   else if(stbi_is_hdr_from_file(f))
   {
@@ -696,17 +819,21 @@ void ImageViewer::RefreshFile()
   m_FrameRecord.frameInfo.persistentSize = 0;
   m_FrameRecord.frameInfo.uncompressedFileSize = datasize;
 
-  dds_data read_data = {0};
+  dds_data read_data = {};
+  StreamReader *ddsReader = NULL;
 
   if(dds)
   {
-    FileIO::fseek64(f, 0, SEEK_SET);
-    StreamReader reader(f);
-    read_data = load_dds_from_file(&reader);
+    // only the header is read here. The subresources are read and uploaded one at a time below.
+    // The file isn't mapped since it's watched for changes, and if another program truncated it
+    // while we were reading a mapping we'd crash instead of just getting a short read.
+    ddsReader = new StreamReader(f);
+    read_data = load_dds_header(ddsReader);
     f = NULL;
 
-    if(read_data.subdata == NULL)
+    if(read_data.subsizes == NULL)
     {
+      delete ddsReader;
       return;
     }
 
@@ -748,12 +875,26 @@ void ImageViewer::RefreshFile()
 
   m_FrameRecord.frameInfo.compressedFileSize = m_FrameRecord.frameInfo.uncompressedFileSize;
 
+  // if a DDS format isn't supported for local display, see if we can convert it on the CPU for
+  // proxying. The real data is then kept to return from GetTextureData()
+  bool convert = false, blockDecode = false;
+  if(dds && !m_Proxy->IsTextureSupported(texDetails))
+  {
+    blockDecode = IsBlockDecodeSupported(texDetails.format);
+    if(blockDecode)
+      convert = true;
+    else
+      DecodeFormattedComponents(texDetails.format, NULL, &convert);
+  }
+
   // recreate proxy texture if necessary.
   // we rewrite the texture IDs so that the
   // outside world doesn't need to know about this
   // (we only ever have one texture in the image
   // viewer so we can just set all texture IDs
   // used to that).
+  const ResourceId prevTextureID = m_TextureID;
+
   if(m_TextureID != ResourceId())
   {
     if(m_TexDetails.width != texDetails.width || m_TexDetails.height != texDetails.height ||
@@ -767,78 +908,25 @@ void ImageViewer::RefreshFile()
 
   if(m_TextureID == ResourceId())
   {
-    if(m_Proxy->IsTextureSupported(texDetails))
+    if(convert)
+    {
+      TextureDescription remapped = texDetails;
+      remapped.format = rgba32_float;
+      m_TextureID = m_Proxy->CreateProxyTexture(remapped);
+    }
+    else if(m_Proxy->IsTextureSupported(texDetails))
     {
       m_TextureID = m_Proxy->CreateProxyTexture(texDetails);
     }
+    else if(dds)
+    {
+      RDCLOG("Format %s not supported for local display and can't be converted manually.",
+             texDetails.format.Name().c_str());
+    }
     else
     {
-      if(dds)
-      {
-        // see if we can convert this format on the CPU for proxying
-        bool convertSupported = false;
-        DecodeFormattedComponents(texDetails.format, NULL, &convertSupported);
-
-        if(convertSupported)
-        {
-          uint32_t srcStride = texDetails.format.ElementSize();
-
-          if(texDetails.format.type == ResourceFormatType::D16S8)
-            srcStride = 4;
-          else if(texDetails.format.type == ResourceFormatType::D32S8)
-            srcStride = 8;
-
-          m_RealTexData.resize(texDetails.arraysize * texDetails.mips);
-
-          for(uint32_t i = 0; i < texDetails.arraysize * texDetails.mips; i++)
-          {
-            const uint32_t mip = i % texDetails.mips;
-
-            const uint32_t mipwidth = RDCMAX(1U, texDetails.width >> mip);
-            const uint32_t mipheight = RDCMAX(1U, texDetails.height >> mip);
-            const uint32_t mipdepth = RDCMAX(1U, texDetails.depth >> mip);
-
-            byte *old = read_data.subdata[i];
-            m_RealTexData[i].assign(old, read_data.subsizes[i]);
-
-            read_data.subsizes[i] = sizeof(FloatVector) * mipwidth * mipheight * mipdepth;
-            byte *converted = new byte[read_data.subsizes[i]];
-
-            byte *src = old;
-            FloatVector *dst = (FloatVector *)converted;
-
-            for(uint32_t z = 0; z < mipdepth; z++)
-            {
-              for(uint32_t y = 0; y < mipheight; y++)
-              {
-                for(uint32_t x = 0; x < mipwidth; x++)
-                {
-                  *dst = DecodeFormattedComponents(texDetails.format, src);
-                  dst++;
-                  src += srcStride;
-                }
-              }
-            }
-
-            read_data.subdata[i] = converted;
-            delete[] old;
-          }
-
-          TextureDescription remapped = texDetails;
-          remapped.format = rgba32_float;
-          m_TextureID = m_Proxy->CreateProxyTexture(remapped);
-        }
-        else
-        {
-          RDCLOG("Format %s not supported for local display and can't be converted manually.",
-                 texDetails.format.Name().c_str());
-        }
-      }
-      else
-      {
-        RDCERR("Standard format %s expected to be supported for local display but can't.",
-               texDetails.format.Name().c_str());
-      }
+      RDCERR("Standard format %s expected to be supported for local display but can't.",
+             texDetails.format.Name().c_str());
     }
   }
 
@@ -849,23 +937,87 @@ void ImageViewer::RefreshFile()
   m_TexDetails.resourceId = m_TextureID;
   m_TexDetails.byteSize = fileSize;
 
+  m_FileHash = fileHash;
+
+  m_RealTexData.clear();
+
   if(!dds)
   {
+    m_SubresourceHashes.clear();
+
     m_Proxy->SetProxyTextureData(m_TextureID, Subresource(), data, datasize);
     free(data);
   }
   else
   {
-    for(uint32_t i = 0; i < texDetails.arraysize * texDetails.mips; i++)
+    const uint32_t numSubs = texDetails.arraysize * texDetails.mips;
+
+    // if the proxy texture was kept, only subresources whose data changed need to be converted and
+    // uploaded. The upload interface works on whole subresources so this is as fine as it gets.
+    const bool reuse = (m_TextureID == prevTextureID && m_SubresourceHashes.size() == numSubs);
+    m_SubresourceHashes.resize(numSubs);
+
+    if(convert)
+      m_RealTexData.resize(numSubs);
+
+    uint32_t srcStride = texDetails.format.ElementSize();
+
+    if(texDetails.format.type == ResourceFormatType::D16S8)
+      srcStride = 4;
+    else if(texDetails.format.type == ResourceFormatType::D32S8)
+      srcStride = 8;
+
+    // stream each subresource from the file and upload it before reading the next, so that only
+    // one subresource (and its converted copy) is ever staged rather than the whole file.
+    bytebuf staging, converted;
+
+    Threading::JobQueue jobs;
+
+    for(uint32_t i = 0; i < numSubs; i++)
     {
-      m_Proxy->SetProxyTextureData(m_TextureID, {i % texDetails.mips, i / texDetails.mips},
-                                   read_data.subdata[i], (size_t)read_data.subsizes[i]);
+      bytebuf &src = convert ? m_RealTexData[i] : staging;
+      src.resize(read_data.subsizes[i]);
+
+      if(!read_dds_subresource(ddsReader, read_data, i, src.data()))
+        RDCERR("DDS file is truncated, couldn't read subresource %u", i);
+
+      const uint64_t hash = XXH64(src.data(), src.size(), 0);
+      if(reuse && hash == m_SubresourceHashes[i])
+        continue;
+      m_SubresourceHashes[i] = hash;
+
+      byte *upload = src.data();
+      size_t uploadSize = src.size();
+
+      if(convert)
+      {
+        const uint32_t mip = i % texDetails.mips;
+
+        const uint32_t mipwidth = RDCMAX(1U, texDetails.width >> mip);
+        const uint32_t mipheight = RDCMAX(1U, texDetails.height >> mip);
+        const uint32_t mipdepth = RDCMAX(1U, texDetails.depth >> mip);
+
+        converted.resize(sizeof(FloatVector) * mipwidth * mipheight * mipdepth);
+
+        // texels are tightly packed so we can convert the whole subresource in one go
+        if(blockDecode)
+          DecodeBlockCompressed(texDetails.format, src.data(), src.size(), mipwidth, mipheight,
+                                mipdepth, rgba32_float, converted.data(), &jobs);
+        else
+          DecodeFormattedComponentsSpan(texDetails.format, src.data(), srcStride,
+                                        mipwidth * mipheight * mipdepth,
+                                        (FloatVector *)converted.data());
+
+        upload = converted.data();
+        uploadSize = converted.size();
+      }
 
-      delete[] read_data.subdata[i];
+      m_Proxy->SetProxyTextureData(m_TextureID, {i % texDetails.mips, i / texDetails.mips}, upload,
+                                   uploadSize);
     }
 
-    delete[] read_data.subdata;
     delete[] read_data.subsizes;
+    delete ddsReader;
   }
 
   if(f != NULL)
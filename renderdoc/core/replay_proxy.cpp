@@ -25,6 +25,8 @@
 
 #include "replay_proxy.h"
 #include <list>
+#include "common/block_decode.h"
+#include "common/job_queue.h"
 #include "lz4/lz4.h"
 #include "serialise/lz4io.h"
 
@@ -96,6 +98,8 @@ rdcstr DoStringise(const ReplayProxyPacket &el)
 
     STRINGISE_ENUM_NAMED(eReplayProxy_ContinueDebug, "ContinueDebug");
     STRINGISE_ENUM_NAMED(eReplayProxy_FreeDebugger, "FreeDebugger");
+    STRINGISE_ENUM_NAMED(eReplayProxy_ContinueDebugToCondition, "ContinueDebugToCondition");
+    STRINGISE_ENUM_NAMED(eReplayProxy_DebugPixels, "DebugPixels");
   }
   END_ENUM_STRINGISE();
 }
@@ -1529,6 +1533,45 @@ ShaderDebugTrace *ReplayProxy::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
   PROXY_FUNCTION(DebugPixel, eventId, x, y, sample, primitive);
 }
 
+template <typename ParamSerialiser, typename ReturnSerialiser>
+rdcarray<PixelDebugSummary> ReplayProxy::Proxied_DebugPixels(
+    ParamSerialiser &paramser, ReturnSerialiser &retser, uint32_t eventId, uint32_t x, uint32_t y,
+    uint32_t width, uint32_t height, uint32_t sample, uint32_t primitive)
+{
+  const ReplayProxyPacket expectedPacket = eReplayProxy_DebugPixels;
+  ReplayProxyPacket packet = eReplayProxy_DebugPixels;
+  rdcarray<PixelDebugSummary> ret;
+
+  {
+    BEGIN_PARAMS();
+    SERIALISE_ELEMENT(eventId);
+    SERIALISE_ELEMENT(x);
+    SERIALISE_ELEMENT(y);
+    SERIALISE_ELEMENT(width);
+    SERIALISE_ELEMENT(height);
+    SERIALISE_ELEMENT(sample);
+    SERIALISE_ELEMENT(primitive);
+    END_PARAMS();
+  }
+
+  {
+    REMOTE_EXECUTION();
+    if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
+      ret = m_Remote->DebugPixels(eventId, x, y, width, height, sample, primitive);
+  }
+
+  SERIALISE_RETURN(ret);
+
+  return ret;
+}
+
+rdcarray<PixelDebugSummary> ReplayProxy::DebugPixels(uint32_t eventId, uint32_t x, uint32_t y,
+                                                     uint32_t width, uint32_t height,
+                                                     uint32_t sample, uint32_t primitive)
+{
+  PROXY_FUNCTION(DebugPixels, eventId, x, y, width, height, sample, primitive);
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 ShaderDebugTrace *ReplayProxy::Proxied_DebugThread(ParamSerialiser &paramser,
                                                    ReturnSerialiser &retser, uint32_t eventId,
@@ -1602,6 +1645,41 @@ rdcarray<ShaderDebugState> ReplayProxy::ContinueDebug(ShaderDebugger *debugger)
   PROXY_FUNCTION(ContinueDebug, debugger);
 }
 
+template <typename ParamSerialiser, typename ReturnSerialiser>
+rdcarray<ShaderDebugState> ReplayProxy::Proxied_ContinueDebugToCondition(
+    ParamSerialiser &paramser, ReturnSerialiser &retser, ShaderDebugger *debugger,
+    const ShaderDebugStopCondition &condition)
+{
+  const ReplayProxyPacket expectedPacket = eReplayProxy_ContinueDebugToCondition;
+  ReplayProxyPacket packet = eReplayProxy_ContinueDebugToCondition;
+  rdcarray<ShaderDebugState> ret;
+
+  {
+    BEGIN_PARAMS();
+    uint64_t debugger_ptr = (uint64_t)(uintptr_t)debugger;
+    SERIALISE_ELEMENT(debugger_ptr);
+    SERIALISE_ELEMENT(condition);
+    debugger = (ShaderDebugger *)(uintptr_t)debugger_ptr;
+    END_PARAMS();
+  }
+
+  {
+    REMOTE_EXECUTION();
+    if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
+      ret = m_Remote->ContinueDebugToCondition(debugger, condition);
+  }
+
+  SERIALISE_RETURN(ret);
+
+  return ret;
+}
+
+rdcarray<ShaderDebugState> ReplayProxy::ContinueDebugToCondition(
+    ShaderDebugger *debugger, const ShaderDebugStopCondition &condition)
+{
+  PROXY_FUNCTION(ContinueDebugToCondition, debugger, condition);
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 void ReplayProxy::Proxied_FreeDebugger(ParamSerialiser &paramser, ReturnSerialiser &retser,
                                        ShaderDebugger *debugger)
@@ -2370,7 +2448,27 @@ void ReplayProxy::EnsureTexCached(ResourceId &texid, CompType &typeCast, const S
       TextureDescription tex = GetTexture(texid);
 
       ProxyTextureProperties proxy;
-      RemapProxyTextureIfNeeded(tex, proxy.params);
+
+      // block-compressed formats we can decode ourselves are transferred compressed, which is a
+      // fraction of the size of remapping them remotely.
+      if(!NeedRemapForFetch(tex.format) && !m_Proxy->IsTextureSupported(tex) &&
+         IsBlockDecodeSupported(tex.format))
+      {
+        proxy.blockDecode = true;
+        proxy.blockTex = tex;
+
+        // HDR and signed formats decode to floats, which we store at half precision as the remote
+        // remap would have.
+        proxy.decodedFormat = GetBlockDecodeFormat(tex.format);
+        if(proxy.decodedFormat.compType == CompType::Float)
+          proxy.decodedFormat.compByteWidth = 2;
+
+        tex.format = proxy.decodedFormat;
+      }
+      else
+      {
+        RemapProxyTextureIfNeeded(tex, proxy.params);
+      }
 
       proxy.id = m_Proxy->CreateProxyTexture(tex);
       proxy.msSamp = RDCMAX(1U, tex.msSamp);
@@ -2398,14 +2496,42 @@ void ReplayProxy::EnsureTexCached(ResourceId &texid, CompType &typeCast, const S
 #endif
 
       auto it = m_ProxyTextureData.find(sampleArrayEntry);
-      if(it != m_ProxyTextureData.end())
+      if(it == m_ProxyTextureData.end())
+        continue;
+
+      if(proxy.blockDecode)
+      {
+        ResourceFormat fmt = proxy.blockTex.format;
+
+        // the decoded values depend on the interpretation for float outputs, so apply any cast
+        if(proxy.decodedFormat.compType == CompType::Float &&
+           (typeCast == CompType::UNorm || typeCast == CompType::SNorm))
+          fmt.compType = typeCast;
+
+        uint32_t width = RDCMAX(1U, proxy.blockTex.width >> s.mip);
+        uint32_t height = RDCMAX(1U, proxy.blockTex.height >> s.mip);
+        uint32_t depth = RDCMAX(1U, proxy.blockTex.depth >> s.mip);
+
+        bytebuf decoded;
+        decoded.resize(width * height * depth * proxy.decodedFormat.ElementSize());
+
+        Threading::JobQueue jobs;
+        if(DecodeBlockCompressed(fmt, it->second.data(), it->second.size(), width, height, depth,
+                                 proxy.decodedFormat, decoded.data(), &jobs))
+          m_Proxy->SetProxyTextureData(proxy.id, s, decoded.data(), decoded.size());
+      }
+      else
+      {
         m_Proxy->SetProxyTextureData(proxy.id, s, it->second.data(), it->second.size());
+      }
     }
 
     m_TextureProxyCache.insert(entry);
   }
 
-  if(proxyit->second.params.remap != RemapTexture::NoRemap)
+  // 8-bit decoded data is stored as-is so the cast still applies, but float data has been resolved
+  if(proxyit->second.params.remap != RemapTexture::NoRemap ||
+     (proxyit->second.blockDecode && proxyit->second.decodedFormat.compType == CompType::Float))
     typeCast = BaseRemapType(typeCast);
 
   // change texid to the proxy texture's ID for passing to our proxy renderer
@@ -2832,6 +2958,10 @@ bool ReplayProxy::Tick(int type)
     }
     case eReplayProxy_ContinueDebug: ContinueDebug(NULL); break;
     case eReplayProxy_FreeDebugger: FreeDebugger(NULL); break;
+    case eReplayProxy_ContinueDebugToCondition:
+      ContinueDebugToCondition(NULL, ShaderDebugStopCondition());
+      break;
+    case eReplayProxy_DebugPixels: DebugPixels(0, 0, 0, 0, 0, 0, 0); break;
     case eReplayProxy_RenderOverlay:
       RenderOverlay(ResourceId(), FloatVector(), DebugOverlay::NoOverlay, 0, rdcarray<uint32_t>());
       break;
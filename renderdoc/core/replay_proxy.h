@@ -103,6 +103,8 @@ enum ReplayProxyPacket
 
   eReplayProxy_ContinueDebug,
   eReplayProxy_FreeDebugger,
+  eReplayProxy_ContinueDebugToCondition,
+  eReplayProxy_DebugPixels,
 };
 
 DECLARE_REFLECTION_ENUM(ReplayProxyPacket);
@@ -527,9 +529,14 @@ public:
                              uint32_t instid, uint32_t idx, uint32_t view);
   IMPLEMENT_FUNCTION_PROXIED(ShaderDebugTrace *, DebugPixel, uint32_t eventId, uint32_t x,
                              uint32_t y, uint32_t sample, uint32_t primitive);
+  IMPLEMENT_FUNCTION_PROXIED(rdcarray<PixelDebugSummary>, DebugPixels, uint32_t eventId,
+                             uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                             uint32_t sample, uint32_t primitive);
   IMPLEMENT_FUNCTION_PROXIED(ShaderDebugTrace *, DebugThread, uint32_t eventId,
                              const uint32_t groupid[3], const uint32_t threadid[3]);
   IMPLEMENT_FUNCTION_PROXIED(rdcarray<ShaderDebugState>, ContinueDebug, ShaderDebugger *debugger);
+  IMPLEMENT_FUNCTION_PROXIED(rdcarray<ShaderDebugState>, ContinueDebugToCondition,
+                             ShaderDebugger *debugger, const ShaderDebugStopCondition &condition);
   IMPLEMENT_FUNCTION_PROXIED(void, FreeDebugger, ShaderDebugger *debugger);
 
   IMPLEMENT_FUNCTION_PROXIED(rdcarray<ShaderEncoding>, GetTargetShaderEncodings);
@@ -611,6 +618,11 @@ private:
     ResourceId id;
     uint32_t msSamp;
     GetTextureDataParams params;
+    // if set, the texture is block-compressed in a format the proxy renderer can't display. The
+    // compressed data is fetched as-is and decoded locally into decodedFormat.
+    bool blockDecode = false;
+    TextureDescription blockTex;
+    ResourceFormat decodedFormat;
 
     ProxyTextureProperties() {}
     // Create a proxy Id with the default get-data parameters.
@@ -27,6 +27,11 @@
 
 #include <algorithm>
 
+RDOC_CONFIG(bool, Capture_SkipOverwrittenInitialContents, true,
+            "Don't store the initial contents of resources that are completely overwritten in the "
+            "captured frame before being read. Inspecting those resources before the first write "
+            "will show cleared contents.");
+
 namespace ResourceIDGen
 {
 static int64_t globalIDCounter = 1;
@@ -34,9 +34,12 @@
 #include "api/replay/resourceid.h"
 #include "common/threading.h"
 #include "core/core.h"
+#include "core/settings.h"
 #include "os/os_specific.h"
 #include "serialise/serialiser.h"
 
+RDOC_EXTERN_CONFIG(bool, Capture_SkipOverwrittenInitialContents);
+
 // In what way (read, write, etc) was a resource referenced in a frame -
 // used to determine if initial contents are needed and to what degree.
 // These values are used both as states (representing the cumulative previous
@@ -604,8 +607,18 @@ public:
   void SetInitialContents(ResourceId id, InitialContentData contents);
   void SetInitialChunk(ResourceId id, Chunk *chunk);
 
-  // generate chunks for initial contents and insert.
-  void InsertInitialContentsChunks(WriteSerialiser &ser);
+  // generate chunks for initial contents and insert. frameChunks are the chunks that will be
+  // written for the frame itself afterwards, which count towards the capture size budget.
+  void InsertInitialContentsChunks(WriteSerialiser &ser,
+                                   const std::map<int64_t, Chunk *> &frameChunks);
+
+  // while inserting initial contents chunks for a rolling frame, returns the chunk already written
+  // for id if it's being kept for later frames. NULL otherwise.
+  Chunk *GetSerialisedInitialChunk(ResourceId id);
+
+  // read the list of resources that had initial contents dropped to fit within the capture size
+  // budget, and fill out the warning the driver should report for them.
+  bool ReadDegradedInitialContents(ReadSerialiser &ser, rdcstr &warning);
 
   // for initial contents that don't need a chunk - apply them here. This allows any patching to
   // creation-time chunks to happen before they're written to disk.
@@ -686,8 +699,18 @@ protected:
   {
     return true;
   }
+  // returns true if every part of the resource was completely overwritten in the frame before it
+  // was read in any way, so the initial contents can never be observed. Only drivers that track
+  // references at subresource granularity can determine this.
+  virtual bool IsFrameOverwritten(ResourceId id, FrameRefType refType) { return false; }
   virtual bool Prepare_InitialState(WrappedResourceType res) = 0;
   virtual uint64_t GetSize_InitialState(ResourceId id, const InitialContentData &initial) = 0;
+  // estimates the size GetSize_InitialState() would return for a postponed resource, without
+  // preparing its contents. Returns 0 if the size can't be estimated.
+  virtual uint64_t GetSize_PostponedInitialState(ResourceId id) { return 0; }
+  // returns false if the serialised initial contents of id depend on other resources' contents, so
+  // the chunk can't be kept and reused as-is in a later rolling frame.
+  virtual bool IsInitialChunkReusable(ResourceId id) { return true; }
   virtual bool Serialise_InitialState(WriteSerialiser &ser, ResourceId id, RecordType *record,
                                       const InitialContentData *initialData) = 0;
   virtual void Create_InitialState(ResourceId id, WrappedResourceType live, bool hasData) = 0;
@@ -696,6 +719,9 @@ protected:
 
   void UpdateLastWriteAndPartialUseTime(ResourceId id, FrameRefType refType);
 
+  rdcarray<ResourceId> DegradeInitialContents(rdcarray<ResourceId> &serialiseIDs, uint64_t budget,
+                                              uint64_t used);
+
   void Prepare_InitialStateIfPostponed(ResourceId id, bool midframe);
   void SkipOrPostponeOrPrepare_InitialState(ResourceId id, FrameRefType refType);
 
@@ -741,6 +767,14 @@ protected:
   // used during capture or replay - holds initial contents
   std::map<ResourceId, InitialContentDataOrChunk> m_InitialContents;
 
+  // used during rolling capture - serialised initial contents from a previous frame, kept until
+  // the resource is next marked dirty so unchanged resources don't need to be read back again
+  std::map<ResourceId, Chunk *> m_RetainedInitialChunks;
+
+  // used during rolling capture - resources whose retained chunk has been written so far while
+  // inserting the current frame's initial contents chunks
+  std::unordered_set<ResourceId> m_SerialisedRetainedChunks;
+
   // used during capture or replay - map of resources currently alive with their real IDs, used in
   // capture and replay.
   std::unordered_map<ResourceId, WrappedResourceType> m_CurrentResourceMap;
@@ -814,6 +848,10 @@ void ResourceManager<Configuration>::Shutdown()
 {
   FreeInitialContents();
 
+  for(auto it = m_RetainedInitialChunks.begin(); it != m_RetainedInitialChunks.end(); ++it)
+    it->second->Delete();
+  m_RetainedInitialChunks.clear();
+
   while(!m_LiveResourceMap.empty())
   {
     auto it = m_LiveResourceMap.begin();
@@ -956,6 +994,16 @@ void ResourceManager<Configuration>::MarkDirtyResource(ResourceId res)
     return;
 
   m_DirtyResources.insert(res);
+
+  if(!m_RetainedInitialChunks.empty())
+  {
+    auto it = m_RetainedInitialChunks.find(res);
+    if(it != m_RetainedInitialChunks.end())
+    {
+      it->second->Delete();
+      m_RetainedInitialChunks.erase(it);
+    }
+  }
 }
 
 template <typename Configuration>
@@ -1430,6 +1478,20 @@ void ResourceManager<Configuration>::PrepareInitialContents()
   uint32_t prepared = 0;
   uint32_t postponed = 0;
   uint32_t skipped = 0;
+  uint32_t retained = 0;
+
+  // drop retained contents for any resources that have since been destroyed
+  for(auto it = m_RetainedInitialChunks.begin(); it != m_RetainedInitialChunks.end();)
+  {
+    if(HasCurrentResource(it->first))
+    {
+      ++it;
+      continue;
+    }
+
+    it->second->Delete();
+    it = m_RetainedInitialChunks.erase(it);
+  }
 
   float num = float(m_DirtyResources.size());
   float idx = 0.0f;
@@ -1461,6 +1523,17 @@ void ResourceManager<Configuration>::PrepareInitialContents()
       continue;
     }
 
+    // a resource that hasn't been marked dirty since its contents were serialised for a previous
+    // rolling frame still has those contents, so re-use the chunk instead of reading it back.
+    auto retainedit = m_RetainedInitialChunks.find(id);
+    if(retainedit != m_RetainedInitialChunks.end())
+    {
+      SetInitialChunk(id, retainedit->second);
+      m_RetainedInitialChunks.erase(retainedit);
+      retained++;
+      continue;
+    }
+
     if(ShouldPostpone(id))
     {
       m_PostponedResourceIDs.insert(id);
@@ -1479,35 +1552,51 @@ void ResourceManager<Configuration>::PrepareInitialContents()
     Prepare_InitialState(res);
   }
 
-  RDCDEBUG("Prepared %u dirty resources, postponed %u, skipped %u", prepared, postponed, skipped);
+  RDCDEBUG("Prepared %u dirty resources, postponed %u, skipped %u, retained %u", prepared,
+           postponed, skipped, retained);
 }
 
 template <typename Configuration>
-void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser &ser)
+void ResourceManager<Configuration>::InsertInitialContentsChunks(
+    WriteSerialiser &ser, const std::map<int64_t, Chunk *> &frameChunks)
 {
   SCOPED_LOCK_OPTIONAL(m_Lock, m_Capturing);
 
   uint32_t dirty = 0;
   uint32_t skipped = 0;
+  uint32_t overwritten = 0;
 
   RDCDEBUG("Checking %u resources with initial contents", (uint32_t)m_InitialContents.size());
 
-  float num = float(m_InitialContents.size());
-  float idx = 0.0f;
+  const uint64_t budget =
+      uint64_t(RenderDoc::Inst().GetCaptureOptions().captureSizeBudgetMB) * 1024 * 1024;
+
+  const bool rolling = RenderDoc::Inst().IsRollingCapture();
+
+  m_SerialisedRetainedChunks.clear();
+
+  rdcarray<ResourceId> serialiseIDs;
+  serialiseIDs.reserve(m_InitialContents.size());
 
   for(auto it = m_InitialContents.begin(); it != m_InitialContents.end(); ++it)
   {
     ResourceId id = it->first;
 
-    RenderDoc::Inst().SetProgress(CaptureProgress::SerialiseInitialStates, idx / num);
-    idx += 1.0f;
+    auto refit = m_FrameReferencedResources.find(id);
 
-    if(m_FrameReferencedResources.find(id) == m_FrameReferencedResources.end() &&
+    if(refit == m_FrameReferencedResources.end() &&
        !RenderDoc::Inst().GetCaptureOptions().refAllResources)
     {
 #if ENABLED(VERBOSE_DIRTY_RESOURCES)
       RDCDEBUG("Dirty resource %s is GPU dirty but not referenced - skipping", ToStr(id).c_str());
 #endif
+      // an unreferenced resource isn't written either, so any serialised contents stay valid
+      if(rolling && it->second.chunk)
+      {
+        m_RetainedInitialChunks[id] = it->second.chunk;
+        it->second.chunk = NULL;
+      }
+
       skipped++;
       continue;
     }
@@ -1530,6 +1619,44 @@ void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser
       continue;
     }
 
+    // if the whole resource is overwritten before it's read, the contents will never be used. The
+    // resource is still listed in the needed initial contents so it gets a default initialisation
+    // on replay, the same as resources that are skipped before the frame.
+    if(refit != m_FrameReferencedResources.end() && Capture_SkipOverwrittenInitialContents() &&
+       IsFrameOverwritten(id, refit->second))
+    {
+#if ENABLED(VERBOSE_DIRTY_RESOURCES)
+      RDCDEBUG("Resource %s is completely overwritten in the frame - skipping", ToStr(id).c_str());
+#endif
+      m_PostponedResourceIDs.erase(id);
+      SetInitialContents(id, InitialContentData());
+      overwritten++;
+      continue;
+    }
+
+    serialiseIDs.push_back(id);
+  }
+
+  rdcarray<ResourceId> degraded;
+
+  if(budget > 0)
+  {
+    // everything written so far and the frame itself are needed to replay at all
+    uint64_t used = ser.GetWriter()->GetOffset();
+    for(auto it = frameChunks.begin(); it != frameChunks.end(); ++it)
+      used += it->second->GetLength();
+
+    degraded = DegradeInitialContents(serialiseIDs, budget, used);
+  }
+
+  float num = float(serialiseIDs.size());
+  float idx = 0.0f;
+
+  for(ResourceId id : serialiseIDs)
+  {
+    RenderDoc::Inst().SetProgress(CaptureProgress::SerialiseInitialStates, idx / num);
+    idx += 1.0f;
+
 #if ENABLED(VERBOSE_DIRTY_RESOURCES)
     RDCDEBUG("Serialising dirty Resource %s", ToStr(id).c_str());
 #endif
@@ -1539,31 +1666,189 @@ void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser
 
     dirty++;
 
-    if(!Need_InitialStateChunk(id, it->second.data))
+    InitialContentDataOrChunk &contents = m_InitialContents[id];
+
+    if(!Need_InitialStateChunk(id, contents.data))
     {
       // this was handled in ApplyInitialContentsNonChunks(), do nothing as there's no point copying
       // the data again (it's already been serialised).
       continue;
     }
 
-    if(it->second.chunk)
+    uint64_t size = contents.chunk ? contents.chunk->GetLength()
+                                   : GetSize_InitialState(id, contents.data);
+
+    // chunks are limited to 32-bit lengths, anything larger is read back again each frame
+    const bool retain = rolling && size < 0xf0000000ULL;
+
+    if(contents.chunk)
     {
-      it->second.chunk->Write(ser);
+      contents.chunk->Write(ser);
     }
-    else
+    else if(retain)
     {
-      uint64_t size = GetSize_InitialState(id, it->second.data);
+      // serialise to a chunk first so it can be kept for the next rolling frame
+      WriteSerialiser chunkSer(new StreamWriter(size + 1024), Ownership::Stream);
+      chunkSer.SetChunkMetadataRecording(ser.GetChunkMetadataRecording());
+      chunkSer.SetUserData(ser.GetUserData());
+
+      {
+        ScopedChunk scope(chunkSer, SystemChunk::InitialContents, size);
+
+        Serialise_InitialState(chunkSer, id, GetResourceRecord(id), &contents.data);
+
+        contents.chunk = scope.Get();
+      }
 
+      contents.chunk->Write(ser);
+    }
+    else
+    {
       SCOPED_SERIALISE_CHUNK(SystemChunk::InitialContents, size);
 
-      Serialise_InitialState(ser, id, record, &it->second.data);
+      Serialise_InitialState(ser, id, GetResourceRecord(id), &contents.data);
+    }
+
+    if(retain && IsInitialChunkReusable(id))
+    {
+      m_RetainedInitialChunks[id] = contents.chunk;
+      m_SerialisedRetainedChunks.insert(id);
+      contents.chunk = NULL;
     }
 
     // Reset back to empty contents, unloading the actual resource.
     SetInitialContents(id, InitialContentData());
   }
 
-  RDCDEBUG("Serialised %u resources, skipped %u unreferenced", dirty, skipped);
+  if(!degraded.empty())
+  {
+    SCOPED_SERIALISE_CHUNK(SystemChunk::DegradedInitialContents,
+                           degraded.size() * sizeof(ResourceId) + 16);
+    SERIALISE_ELEMENT(degraded);
+  }
+
+  RDCDEBUG("Serialised %u resources, skipped %u unreferenced, %u overwritten in the frame", dirty,
+           skipped, overwritten);
+}
+
+template <typename Configuration>
+Chunk *ResourceManager<Configuration>::GetSerialisedInitialChunk(ResourceId id)
+{
+  SCOPED_LOCK_OPTIONAL(m_Lock, m_Capturing);
+
+  if(m_SerialisedRetainedChunks.find(id) == m_SerialisedRetainedChunks.end())
+    return NULL;
+
+  auto it = m_RetainedInitialChunks.find(id);
+  return it == m_RetainedInitialChunks.end() ? NULL : it->second;
+}
+
+template <typename Configuration>
+rdcarray<ResourceId> ResourceManager<Configuration>::DegradeInitialContents(
+    rdcarray<ResourceId> &serialiseIDs, uint64_t budget, uint64_t used)
+{
+  struct SizedContents
+  {
+    ResourceId id;
+    uint64_t size;
+  };
+
+  rdcarray<SizedContents> sizes;
+  sizes.reserve(serialiseIDs.size());
+
+  uint64_t total = used;
+
+  for(ResourceId id : serialiseIDs)
+  {
+    // postponed resources are sized from an estimate where possible, rather than reading back their
+    // contents just to measure them. If there's no estimate the contents are prepared now, and
+    // kept for serialising if they're not dropped.
+    if(IsResourcePostponed(id))
+    {
+      uint64_t size = GetSize_PostponedInitialState(id);
+
+      if(size > 0)
+      {
+        sizes.push_back({id, size});
+        total += size;
+        continue;
+      }
+
+      Prepare_InitialStateIfPostponed(id, false);
+    }
+
+    const InitialContentDataOrChunk &contents = m_InitialContents[id];
+
+    if(Need_InitialStateChunk(id, contents.data))
+    {
+      uint64_t size =
+          contents.chunk ? contents.chunk->GetLength() : GetSize_InitialState(id, contents.data);
+
+      sizes.push_back({id, size});
+      total += size;
+    }
+  }
+
+  rdcarray<ResourceId> degraded;
+
+  if(total <= budget)
+    return degraded;
+
+  // drop the largest contents first, until we fit within the budget. Everything else in the capture
+  // is required to replay at all, so if that alone is over budget we can only get as close as
+  // possible.
+  std::sort(sizes.begin(), sizes.end(),
+            [](const SizedContents &a, const SizedContents &b) { return a.size > b.size; });
+
+  std::unordered_set<ResourceId> dropped;
+
+  for(const SizedContents &s : sizes)
+  {
+    if(total <= budget)
+      break;
+
+    RDCWARN("Dropping initial contents of %s (%llu bytes) to fit within capture size budget",
+            ToStr(s.id).c_str(), s.size);
+
+    SetInitialContents(s.id, InitialContentData());
+    m_PostponedResourceIDs.erase(s.id);
+    dropped.insert(s.id);
+    degraded.push_back(s.id);
+    total -= s.size;
+  }
+
+  rdcarray<ResourceId> kept;
+  kept.reserve(serialiseIDs.size() - dropped.size());
+  for(ResourceId id : serialiseIDs)
+    if(dropped.find(id) == dropped.end())
+      kept.push_back(id);
+  serialiseIDs.swap(kept);
+
+  RDCLOG("Dropped initial contents of %zu resources, estimated capture size %llu bytes",
+         degraded.size(), total);
+
+  return degraded;
+}
+
+template <typename Configuration>
+bool ResourceManager<Configuration>::ReadDegradedInitialContents(ReadSerialiser &ser,
+                                                                 rdcstr &warning)
+{
+  rdcarray<ResourceId> degraded;
+  SERIALISE_ELEMENT(degraded);
+
+  SERIALISE_CHECK_READ_ERRORS();
+
+  for(ResourceId id : degraded)
+    RDCWARN("Initial contents of %s were not stored due to the capture size budget",
+            ToStr(id).c_str());
+
+  warning = StringFormat::Fmt(
+      "The initial contents of %zu resources were not stored, to keep the capture within its "
+      "size budget. Their contents before they are first written in the frame are undefined.",
+      degraded.size());
+
+  return true;
 }
 
 template <typename Configuration>
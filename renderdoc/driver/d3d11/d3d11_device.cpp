@@ -1224,6 +1224,15 @@ bool WrappedID3D11Device::ProcessChunk(ReadSerialiser &ser, D3D11Chunk context)
     {
       return Serialise_InitialState(ser, ResourceId(), NULL, NULL);
     }
+    else if(system == SystemChunk::DegradedInitialContents)
+    {
+      rdcstr warning;
+      if(!GetResourceManager()->ReadDegradedInitialContents(ser, warning))
+        return false;
+
+      AddDebugMessage(MessageCategory::Resource_Manipulation, MessageSeverity::Medium,
+                      MessageSource::RuntimeWarning, warning);
+    }
     else if(system == SystemChunk::CaptureScope)
     {
       return Serialise_CaptureScope(ser);
@@ -2111,7 +2120,16 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
 
       GetResourceManager()->InsertReferencedChunks(ser);
 
-      GetResourceManager()->InsertInitialContentsChunks(ser);
+      RDCDEBUG("Getting Resource Record");
+
+      D3D11ResourceRecord *record = m_pImmediateContext->GetResourceRecord();
+
+      RDCDEBUG("Accumulating context resource list");
+
+      std::map<int64_t, Chunk *> recordlist;
+      record->Insert(recordlist);
+
+      GetResourceManager()->InsertInitialContentsChunks(ser, recordlist);
 
       RDCDEBUG("Creating Capture Scope");
 
@@ -2125,15 +2143,6 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
       }
 
       {
-        RDCDEBUG("Getting Resource Record");
-
-        D3D11ResourceRecord *record = m_pImmediateContext->GetResourceRecord();
-
-        RDCDEBUG("Accumulating context resource list");
-
-        std::map<int64_t, Chunk *> recordlist;
-        record->Insert(recordlist);
-
         RDCDEBUG("Flushing %u records to file serialiser", (uint32_t)recordlist.size());
 
         float num = float(recordlist.size());
@@ -1960,6 +1960,33 @@ void D3D11Replay::GetBufferData(ResourceId buff, uint64_t offset, uint64_t lengt
   GetDebugManager()->GetBufferData(buffer, offset, length, retData);
 }
 
+// works out the box to copy into the staging texture when only params.region of a subresource is
+// wanted. Returns false if the whole subresource has to be copied and cropped after reading back:
+// depth-stencil copies must be of whole subresources, and a block-compressed staging texture can't
+// end in a partial block.
+static bool GetCropBox(const GetTextureDataParams &params, DXGI_FORMAT format, bool depthStencil,
+                       uint32_t width, uint32_t height, uint32_t depth, D3D11_BOX &box)
+{
+  if(params.region.IsWhole() || (depthStencil && params.remap == RemapTexture::NoRemap))
+    return false;
+
+  const uint32_t blockSize = IsBlockFormat(format) ? 4 : 1;
+
+  const TextureRegion region = ClampTextureRegion(params.region, width, height, depth, blockSize);
+
+  if(region.width % blockSize != 0 || region.height % blockSize != 0)
+    return false;
+
+  box.left = region.x;
+  box.top = region.y;
+  box.front = region.z;
+  box.right = region.x + region.width;
+  box.bottom = region.y + region.height;
+  box.back = region.z + region.depth;
+
+  return true;
+}
+
 void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
                                  const GetTextureDataParams &params, bytebuf &data)
 {
@@ -1974,6 +2001,18 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
 
   size_t bytesize = 0;
 
+  // set when only params.region is copied into the staging texture, so only it is read back
+  bool cropOnCopy = false;
+  D3D11_BOX cropBox = {};
+
+  // copies the subresource being fetched into the staging texture, or just the region of it
+  auto copyToStaging = [&](ID3D11Resource *staging, ID3D11Resource *src) {
+    if(cropOnCopy)
+      m_pImmediateContext->CopySubresourceRegion(staging, 0, 0, 0, 0, src, subresource, &cropBox);
+    else
+      m_pImmediateContext->CopyResource(staging, src);
+  };
+
   if(WrappedID3D11Texture1D::m_TextureList.find(tex) != WrappedID3D11Texture1D::m_TextureList.end())
   {
     WrappedID3D11Texture1D *wrapTex =
@@ -1982,6 +2021,8 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
     D3D11_TEXTURE1D_DESC desc = {0};
     wrapTex->GetDesc(&desc);
 
+    const bool depthStencil = (desc.BindFlags & D3D11_BIND_DEPTH_STENCIL) != 0;
+
     desc.BindFlags = 0;
     desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
     desc.MiscFlags = 0;
@@ -2018,7 +2059,18 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
 
     subresource = s.slice * mips + s.mip;
 
-    HRESULT hr = m_pDevice->CreateTexture1D(&desc, NULL, &d);
+    cropOnCopy = GetCropBox(params, desc.Format, depthStencil, RDCMAX(1U, desc.Width >> s.mip), 1,
+                            1, cropBox);
+
+    D3D11_TEXTURE1D_DESC stagingDesc = desc;
+    if(cropOnCopy)
+    {
+      stagingDesc.Width = cropBox.right - cropBox.left;
+      stagingDesc.MipLevels = 1;
+      stagingDesc.ArraySize = 1;
+    }
+
+    HRESULT hr = m_pDevice->CreateTexture1D(&stagingDesc, NULL, &d);
 
     dummyTex = d;
 
@@ -2028,7 +2080,7 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
       return;
     }
 
-    bytesize = GetByteSize(desc.Width, 1, 1, desc.Format, s.mip);
+    bytesize = GetByteSize(stagingDesc.Width, 1, 1, stagingDesc.Format, cropOnCopy ? 0 : s.mip);
 
     if(params.remap != RemapTexture::NoRemap)
     {
@@ -2111,14 +2163,14 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
         RenderTextureInternal(texDisplay, flags);
       }
 
-      m_pImmediateContext->CopyResource(d, rtTex);
+      copyToStaging(d, rtTex);
       SAFE_RELEASE(rtTex);
 
       SAFE_RELEASE(wrappedrtv);
     }
     else
     {
-      m_pImmediateContext->CopyResource(d, wrapTex);
+      copyToStaging(d, wrapTex);
     }
   }
   else if(WrappedID3D11Texture2D1::m_TextureList.find(tex) !=
@@ -2130,6 +2182,8 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
     D3D11_TEXTURE2D_DESC desc = {0};
     wrapTex->GetDesc(&desc);
 
+    const bool depthStencil = (desc.BindFlags & D3D11_BIND_DEPTH_STENCIL) != 0;
+
     desc.BindFlags = 0;
     desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
     desc.MiscFlags = 0;
@@ -2181,7 +2235,22 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
 
     subresource = s.slice * mips + s.mip;
 
-    HRESULT hr = m_pDevice->CreateTexture2D(&desc, NULL, &d);
+    // unresolved multisampled data is copied straight into the staging texture below, so it can't
+    // be cropped
+    if(!wasms || params.resolve || params.remap != RemapTexture::NoRemap)
+      cropOnCopy = GetCropBox(params, desc.Format, depthStencil, RDCMAX(1U, desc.Width >> s.mip),
+                              RDCMAX(1U, desc.Height >> s.mip), 1, cropBox);
+
+    D3D11_TEXTURE2D_DESC stagingDesc = desc;
+    if(cropOnCopy)
+    {
+      stagingDesc.Width = cropBox.right - cropBox.left;
+      stagingDesc.Height = cropBox.bottom - cropBox.top;
+      stagingDesc.MipLevels = 1;
+      stagingDesc.ArraySize = 1;
+    }
+
+    HRESULT hr = m_pDevice->CreateTexture2D(&stagingDesc, NULL, &d);
 
     dummyTex = d;
 
@@ -2191,7 +2260,8 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
       return;
     }
 
-    bytesize = GetByteSize(desc.Width, desc.Height, 1, desc.Format, s.mip);
+    bytesize = GetByteSize(stagingDesc.Width, stagingDesc.Height, 1, stagingDesc.Format,
+                           cropOnCopy ? 0 : s.mip);
 
     if(params.remap != RemapTexture::NoRemap)
     {
@@ -2276,7 +2346,7 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
         RenderTextureInternal(texDisplay, flags);
       }
 
-      m_pImmediateContext->CopyResource(d, rtTex);
+      copyToStaging(d, rtTex);
       SAFE_RELEASE(rtTex);
 
       SAFE_RELEASE(wrappedrtv);
@@ -2298,7 +2368,7 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
       }
 
       m_pImmediateContext->ResolveSubresource(resolveTex, s.slice, wrapTex, s.slice, desc.Format);
-      m_pImmediateContext->CopyResource(d, resolveTex);
+      copyToStaging(d, resolveTex);
 
       SAFE_RELEASE(resolveTex);
     }
@@ -2310,7 +2380,7 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
     }
     else
     {
-      m_pImmediateContext->CopyResource(d, wrapTex);
+      copyToStaging(d, wrapTex);
     }
   }
   else if(WrappedID3D11Texture3D1::m_TextureList.find(tex) !=
@@ -2355,7 +2425,20 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
 
     subresource = s.mip;
 
-    HRESULT hr = m_pDevice->CreateTexture3D(&desc, NULL, &d);
+    cropOnCopy = GetCropBox(params, desc.Format, false, RDCMAX(1U, desc.Width >> s.mip),
+                            RDCMAX(1U, desc.Height >> s.mip), RDCMAX(1U, desc.Depth >> s.mip),
+                            cropBox);
+
+    D3D11_TEXTURE3D_DESC stagingDesc = desc;
+    if(cropOnCopy)
+    {
+      stagingDesc.Width = cropBox.right - cropBox.left;
+      stagingDesc.Height = cropBox.bottom - cropBox.top;
+      stagingDesc.Depth = cropBox.back - cropBox.front;
+      stagingDesc.MipLevels = 1;
+    }
+
+    HRESULT hr = m_pDevice->CreateTexture3D(&stagingDesc, NULL, &d);
 
     dummyTex = d;
 
@@ -2365,7 +2448,8 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
       return;
     }
 
-    bytesize = GetByteSize(desc.Width, desc.Height, desc.Depth, desc.Format, s.mip);
+    bytesize = GetByteSize(stagingDesc.Width, stagingDesc.Height, stagingDesc.Depth,
+                           stagingDesc.Format, cropOnCopy ? 0 : s.mip);
 
     if(params.remap != RemapTexture::NoRemap)
     {
@@ -2457,12 +2541,12 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
         SAFE_RELEASE(wrappedrtv);
       }
 
-      m_pImmediateContext->CopyResource(d, rtTex);
+      copyToStaging(d, rtTex);
       SAFE_RELEASE(rtTex);
     }
     else
     {
-      m_pImmediateContext->CopyResource(d, wrapTex);
+      copyToStaging(d, wrapTex);
     }
   }
   else
@@ -2471,6 +2555,10 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
     return;
   }
 
+  // a cropped staging texture only has the one subresource
+  if(cropOnCopy)
+    subresource = 0;
+
   MapIntercept intercept;
 
   D3D11_MAPPED_SUBRESOURCE mapped = {0};
@@ -2485,7 +2573,7 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
 
     // for 3D textures if we wanted a particular slice (arrayIdx > 0)
     // copy it into the beginning.
-    if(intercept.numSlices > 1 && s.slice > 0 && (int)s.slice < intercept.numSlices)
+    if(!cropOnCopy && intercept.numSlices > 1 && s.slice > 0 && (int)s.slice < intercept.numSlices)
     {
       byte *dst = data.data();
       byte *src = data.data() + intercept.app.DepthPitch * s.slice;
@@ -2498,6 +2586,9 @@ void D3D11Replay::GetTextureData(ResourceId tex, const Subresource &sub,
         dst += intercept.app.RowPitch;
       }
     }
+
+    if(!cropOnCopy)
+      CropTextureData(GetTexture(tex), sub, params, data);
   }
   else
   {
@@ -235,9 +235,13 @@ public:
                                 uint32_t view);
   ShaderDebugTrace *DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
                                uint32_t primitive);
+  rdcarray<PixelDebugSummary> DebugPixels(uint32_t eventId, uint32_t x, uint32_t y, uint32_t width,
+                                          uint32_t height, uint32_t sample, uint32_t primitive);
   ShaderDebugTrace *DebugThread(uint32_t eventId, const uint32_t groupid[3],
                                 const uint32_t threadid[3]);
   rdcarray<ShaderDebugState> ContinueDebug(ShaderDebugger *debugger);
+  rdcarray<ShaderDebugState> ContinueDebugToCondition(ShaderDebugger *debugger,
+                                                      const ShaderDebugStopCondition &condition);
   void FreeDebugger(ShaderDebugger *debugger);
 
   uint32_t PickVertex(uint32_t eventId, int32_t width, int32_t height, const MeshDisplay &cfg,
@@ -265,6 +269,11 @@ private:
                    const ShaderCompileFlags &compileFlags, ShaderStage type, ResourceId &id,
                    rdcstr &errors);
 
+  // fetches the inputs of every pixel in the rectangle with one replay of the event, then debugs
+  // each pixel that was hit and passes its trace to the callback
+  void DebugPixelRect(uint32_t eventId, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                      uint32_t sample, uint32_t primitive, const PixelDebugCallback &callback);
+
   void ClearPostVSCache();
 
   void InitStreamOut();
@@ -25,10 +25,12 @@
 
 #include "d3d11_resources.h"
 #include "api/app/renderdoc_app.h"
+#include "common/shader_cache.h"
 #include "driver/dxgi/dxgi_wrapped.h"
 #include "driver/shaders/dxbc/dxbc_reflect.h"
 #include "d3d11_context.h"
 #include "d3d11_renderstate.h"
+#include "d3d11_shader_cache.h"
 
 WRAPPED_POOL_INST(WrappedID3D11Buffer);
 WRAPPED_POOL_INST(WrappedID3D11Texture1D);
@@ -83,8 +85,30 @@ void WrappedShader::ShaderEntry::BuildReflection()
       D3Dx_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT == D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT,
       "Mismatched vertex input count");
 
+  ShaderReflectionCache *cache = NULL;
+  if(m_Device && m_Device->GetShaderCache())
+    cache = m_Device->GetShaderCache()->GetReflectionCache();
+
+  // the hash must be calculated before the container is created, as that consumes the bytecode
+  ShaderHash hash;
+  bool cacheable = cache && GetShaderReflectionHash(m_Bytecode, m_DebugInfoPath, GraphicsAPI::D3D11,
+                                                    m_ShaderExtSlot, ~0U, hash);
+
+  if(cacheable && GetCachedShaderReflection(cache, hash, &m_Details, &m_Mapping))
+  {
+    m_Details.rawBytes = m_Bytecode;
+    m_Details.resourceId = m_ID;
+    return;
+  }
+
+  if(GetDXBC() == NULL)
+    return;
+
   MakeShaderReflection(m_DXBCFile, &m_Details, &m_Mapping);
   m_Details.resourceId = m_ID;
+
+  if(cacheable)
+    CacheShaderReflection(cache, hash, m_Details, m_Mapping);
 }
 
 UINT GetSubresourceCount(ID3D11Resource *res)
@@ -974,9 +974,10 @@ public:
   class ShaderEntry
   {
   public:
-    ShaderEntry() : m_DXBCFile(NULL) {}
+    ShaderEntry() : m_Device(NULL), m_DXBCFile(NULL) {}
     ShaderEntry(WrappedID3D11Device *device, ResourceId id, const byte *code, size_t codeLen)
     {
+      m_Device = device;
       m_ID = id;
       m_Bytecode.assign(code, codeLen);
       m_DXBCFile = NULL;
@@ -1003,7 +1004,7 @@ public:
 
     ShaderReflection &GetDetails()
     {
-      if(!m_Built && GetDXBC() != NULL)
+      if(!m_Built)
         BuildReflection();
       m_Built = true;
       return m_Details;
@@ -1011,7 +1012,7 @@ public:
 
     const ShaderBindpointMapping &GetMapping()
     {
-      if(!m_Built && GetDXBC() != NULL)
+      if(!m_Built)
         BuildReflection();
       m_Built = true;
       return m_Mapping;
@@ -1024,6 +1025,7 @@ public:
 
     void BuildReflection();
 
+    WrappedID3D11Device *m_Device;
     ResourceId m_ID;
 
     rdcstr m_DebugInfoPath;
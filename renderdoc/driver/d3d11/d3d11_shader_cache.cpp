@@ -116,10 +116,16 @@ D3D11ShaderCache::D3D11ShaderCache(WrappedID3D11Device *wrapper)
 
   // if we failed to load from the cache
   m_ShaderCacheDirty = !success;
+
+  if(RenderDoc::Inst().IsReplayApp())
+    m_ReflectionCache = new ShaderReflectionCache("d3d11reflection.cache", m_ReflectionCacheMagic,
+                                                  m_ReflectionCacheVersion);
 }
 
 D3D11ShaderCache::~D3D11ShaderCache()
 {
+  SAFE_DELETE(m_ReflectionCache);
+
   if(m_ShaderCacheDirty)
   {
     SaveShaderCache("d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, m_ShaderCache,
@@ -30,6 +30,7 @@
 #include "driver/dx/official/d3d11_4.h"
 
 class WrappedID3D11Device;
+class ShaderReflectionCache;
 
 class D3D11ShaderCache
 {
@@ -47,12 +48,19 @@ public:
   ID3D11ComputeShader *MakeCShader(const char *source, const char *entry, const char *profile);
 
   void SetCaching(bool enabled) { m_CacheShaders = enabled; }
+  ShaderReflectionCache *GetReflectionCache() { return m_ReflectionCache; }
 private:
   static const uint32_t m_ShaderCacheMagic = 0xf000baba;
   static const uint32_t m_ShaderCacheVersion = 3;
 
+  static const uint32_t m_ReflectionCacheMagic = 0xf000d11f;
+  static const uint32_t m_ReflectionCacheVersion = 1;
+
   ID3D11Device *m_pDevice = NULL;
 
   bool m_ShaderCacheDirty = false, m_CacheShaders = false;
   std::map<uint32_t, ID3DBlob *> m_ShaderCache;
+
+  // only used on replay, for the application's shaders
+  ShaderReflectionCache *m_ReflectionCache = NULL;
 };
@@ -2071,14 +2071,15 @@ ShaderDebugTrace *D3D11Replay::DebugVertex(uint32_t eventId, uint32_t vertid, ui
   return ret;
 }
 
-ShaderDebugTrace *D3D11Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
-                                          uint32_t primitive)
+void D3D11Replay::DebugPixelRect(uint32_t eventId, uint32_t x, uint32_t y, uint32_t width,
+                                 uint32_t height, uint32_t sample, uint32_t primitive,
+                                 const PixelDebugCallback &callback)
 {
   using namespace DXBCBytecode;
   using namespace DXBCDebug;
 
-  D3D11MarkerRegion region(
-      StringFormat::Fmt("DebugPixel @ %u of (%u,%u) %u / %u", eventId, x, y, sample, primitive));
+  D3D11MarkerRegion region(StringFormat::Fmt("DebugPixel @ %u of (%u,%u) %ux%u %u / %u", eventId, x,
+                                             y, width, height, sample, primitive));
 
   D3D11RenderStateTracker tracker(m_pImmediateContext);
 
@@ -2112,7 +2113,7 @@ ShaderDebugTrace *D3D11Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
   SAFE_RELEASE(stateVS);
 
   if(!ps)
-    return new ShaderDebugTrace;
+    return;
 
   D3D11RenderState *rs = m_pImmediateContext->GetCurrentPipelineState();
 
@@ -2120,7 +2121,7 @@ ShaderDebugTrace *D3D11Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
   const ShaderReflection &refl = ps->GetDetails();
 
   if(!dxbc)
-    return new ShaderDebugTrace;
+    return;
 
   dxbc->GetDisassembly();
 
@@ -2144,7 +2145,8 @@ ShaderDebugTrace *D3D11Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
                                                floatInputs, inputVarNames, extractHlsl,
                                                structureStride);
 
-  uint32_t overdrawLevels = 100;    // maximum number of overdraw levels
+  // maximum number of fragments stored, shared between all the pixels in the rectangle
+  const uint32_t overdrawLevels = PixelDebugHitCapacity(width, height);
 
   // If the pipe contains a geometry shader, then SV_PrimitiveID cannot be used in the pixel
   // shader without being emitted from the geometry shader. For now, check if this semantic
@@ -2336,7 +2338,9 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
 
   extractHlsl += "  uint idx = " + ToStr(overdrawLevels) + ";\n";
   extractHlsl += StringFormat::Fmt(
-      "  if(abs(debug_pixelPos.x - %u.5) < 0.5f && abs(debug_pixelPos.y - %u.5) < 0.5f)\n", x, y);
+      "  if(debug_pixelPos.x >= %u.0f && debug_pixelPos.x < %u.0f &&\n"
+      "     debug_pixelPos.y >= %u.0f && debug_pixelPos.y < %u.0f)\n",
+      x, x + width, y, y + height);
   extractHlsl += "    InterlockedAdd(PSInitialBuffer[0].hit, 1, idx);\n\n";
   extractHlsl += "  idx = min(idx, " + ToStr(overdrawLevels) + ");\n\n";
   extractHlsl += "  PSInitialBuffer[idx].pos = debug_pixelPos.xyz;\n";
@@ -2458,7 +2462,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
   if(FAILED(hr))
   {
     RDCERR("Failed to create buffer HRESULT: %s", ToStr(hr).c_str());
-    return new ShaderDebugTrace;
+    return;
   }
 
   ID3D11Buffer *evalBuf = NULL;
@@ -2473,7 +2477,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     if(FAILED(hr))
     {
       RDCERR("Failed to create buffer HRESULT: %s", ToStr(hr).c_str());
-      return new ShaderDebugTrace;
+      return;
     }
   }
 
@@ -2490,7 +2494,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
   if(FAILED(hr))
   {
     RDCERR("Failed to create buffer HRESULT: %s", ToStr(hr).c_str());
-    return new ShaderDebugTrace;
+    return;
   }
 
   uint32_t evalStructStride = uint32_t(evalSampleCacheData.size() * sizeof(Vec4f));
@@ -2505,7 +2509,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     if(FAILED(hr))
     {
       RDCERR("Failed to create buffer HRESULT: %s", ToStr(hr).c_str());
-      return new ShaderDebugTrace;
+      return;
     }
   }
 
@@ -2522,7 +2526,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
   if(FAILED(hr))
   {
     RDCERR("Failed to create buffer HRESULT: %s", ToStr(hr).c_str());
-    return new ShaderDebugTrace;
+    return;
   }
 
   ID3D11UnorderedAccessView *evalUAV = NULL;
@@ -2535,7 +2539,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     if(FAILED(hr))
     {
       RDCERR("Failed to create buffer HRESULT: %s", ToStr(hr).c_str());
-      return new ShaderDebugTrace;
+      return;
     }
   }
 
@@ -2570,7 +2574,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
   if(FAILED(hr))
   {
     RDCERR("Failed to map stage buff HRESULT: %s", ToStr(hr).c_str());
-    return new ShaderDebugTrace;
+    return;
   }
 
   byte *initialData = new byte[structStride * (overdrawLevels + 1)];
@@ -2588,7 +2592,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     {
       RDCERR("Failed to map stage buff HRESULT: %s", ToStr(hr).c_str());
       SAFE_DELETE_ARRAY(initialData);
-      return new ShaderDebugTrace;
+      return;
     }
 
     evalData = new byte[evalStructStride * (overdrawLevels + 1)];
@@ -2616,22 +2620,27 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     RDCLOG("No hit for this event");
     SAFE_DELETE_ARRAY(initialData);
     SAFE_DELETE_ARRAY(evalData);
-    return new ShaderDebugTrace;
+    return;
   }
 
-  // if we encounter multiple hits at our destination pixel co-ord (or any other) we
-  // check to see if a specific primitive was requested (via primitive parameter not
-  // being set to ~0U). If it was, debug that pixel, otherwise do a best-estimate
-  // of which fragment was the last to successfully depth test and debug that, just by
-  // checking if the depth test is ordered and picking the final fragment in the series
+  if(buf[0].numHits > overdrawLevels)
+    RDCWARN("%u hits, more than the %u that could be stored. Some fragments will be missing",
+            buf[0].numHits, overdrawLevels);
+
+  // sort the hits into the pixels they landed in, keeping the order they were written in
+  rdcarray<rdcarray<uint32_t>> pixelHits;
+  pixelHits.resize(width * height);
 
-  // figure out the TL pixel's coords. Assume even top left (towards 0,0)
-  // this isn't spec'd but is a reasonable assumption.
-  int xTL = x & (~1);
-  int yTL = y & (~1);
+  for(uint32_t i = 0; i < buf[0].numHits && i < overdrawLevels; i++)
+  {
+    DebugHit *hit = (DebugHit *)(initialData + i * structStride);
 
-  // get the index of our desired pixel
-  int destIdx = (x - xTL) + 2 * (y - yTL);
+    const uint32_t col = uint32_t(hit->posx) - x;
+    const uint32_t row = uint32_t(hit->posy) - y;
+
+    if(col < width && row < height)
+      pixelHits[row * width + col].push_back(i);
+  }
 
   D3D11_COMPARISON_FUNC depthFunc = D3D11_COMPARISON_LESS;
 
@@ -2642,195 +2651,268 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     depthFunc = desc.DepthFunc;
   }
 
-  DebugHit *winner = NULL;
-  float *evalSampleCache = (float *)evalData;
-
   if(sample == ~0U)
     sample = 0;
 
-  if(primitive != ~0U)
-  {
-    for(size_t i = 0; i < buf[0].numHits && i < overdrawLevels; i++)
-    {
-      DebugHit *hit = (DebugHit *)(initialData + i * structStride);
+  tracker.State().ApplyState(m_pImmediateContext);
 
-      if(hit->primitive == primitive && hit->sample == sample)
-      {
-        winner = hit;
-        evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
-      }
-    }
-  }
+  // the constant buffers are the same for every pixel, so they're only read back once
+  bool cbuffersFetched = false;
+  rdcarray<ShaderVariable> constantBlocks;
+  rdcarray<SourceVariableMapping> cbufferSourceVars;
 
-  if(winner == NULL)
+  for(uint32_t row = 0; row < height; row++)
   {
-    for(size_t i = 0; i < buf[0].numHits && i < overdrawLevels; i++)
+    for(uint32_t col = 0; col < width; col++)
     {
-      DebugHit *hit = (DebugHit *)(initialData + i * structStride);
+      const rdcarray<uint32_t> &hits = pixelHits[row * width + col];
 
-      if(winner == NULL)
-      {
-        // If we haven't picked a winner at all yet, use the first one
-        winner = hit;
-        evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
-      }
-      else if(hit->sample == sample)
+      if(hits.empty())
+        continue;
+
+      const uint32_t px = x + col;
+      const uint32_t py = y + row;
+
+      // if we encounter multiple hits at our destination pixel co-ord (or any other) we
+      // check to see if a specific primitive was requested (via primitive parameter not
+      // being set to ~0U). If it was, debug that pixel, otherwise do a best-estimate
+      // of which fragment was the last to successfully depth test and debug that, just by
+      // checking if the depth test is ordered and picking the final fragment in the series
+
+      // figure out the TL pixel's coords. Assume even top left (towards 0,0)
+      // this isn't spec'd but is a reasonable assumption.
+      int xTL = px & (~1);
+      int yTL = py & (~1);
+
+      // get the index of our desired pixel
+      int destIdx = (px - xTL) + 2 * (py - yTL);
+
+      DebugHit *winner = NULL;
+      float *evalSampleCache = (float *)evalData;
+
+      if(primitive != ~0U)
       {
-        // If this hit is for the sample we want, check whether it's a better pick
-        if(winner->sample != sample)
-        {
-          // The previously selected winner was for the wrong sample, use this one
-          winner = hit;
-          evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
-        }
-        else if((depthFunc == D3D11_COMPARISON_ALWAYS || depthFunc == D3D11_COMPARISON_NEVER ||
-                 depthFunc == D3D11_COMPARISON_NOT_EQUAL || depthFunc == D3D11_COMPARISON_EQUAL))
+        for(uint32_t i : hits)
         {
-          // For depth functions without an inequality comparison, use the last sample encountered
-          winner = hit;
-          evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+          DebugHit *hit = (DebugHit *)(initialData + i * structStride);
+
+          if(hit->primitive == primitive && hit->sample == sample)
+          {
+            winner = hit;
+            evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+          }
         }
-        else if((depthFunc == D3D11_COMPARISON_LESS && hit->depth < winner->depth) ||
-                (depthFunc == D3D11_COMPARISON_LESS_EQUAL && hit->depth <= winner->depth) ||
-                (depthFunc == D3D11_COMPARISON_GREATER && hit->depth > winner->depth) ||
-                (depthFunc == D3D11_COMPARISON_GREATER_EQUAL && hit->depth >= winner->depth))
+      }
+
+      if(winner == NULL)
+      {
+        for(uint32_t i : hits)
         {
-          // For depth functions with an inequality, find the hit that "wins" the most
-          winner = hit;
-          evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+          DebugHit *hit = (DebugHit *)(initialData + i * structStride);
+
+          if(winner == NULL)
+          {
+            // If we haven't picked a winner at all yet, use the first one
+            winner = hit;
+            evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+          }
+          else if(hit->sample == sample)
+          {
+            // If this hit is for the sample we want, check whether it's a better pick
+            if(winner->sample != sample)
+            {
+              // The previously selected winner was for the wrong sample, use this one
+              winner = hit;
+              evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+            }
+            else if((depthFunc == D3D11_COMPARISON_ALWAYS ||
+                     depthFunc == D3D11_COMPARISON_NEVER ||
+                     depthFunc == D3D11_COMPARISON_NOT_EQUAL ||
+                     depthFunc == D3D11_COMPARISON_EQUAL))
+            {
+              // For depth functions without an inequality comparison, use the last sample
+              // encountered
+              winner = hit;
+              evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+            }
+            else if((depthFunc == D3D11_COMPARISON_LESS && hit->depth < winner->depth) ||
+                    (depthFunc == D3D11_COMPARISON_LESS_EQUAL && hit->depth <= winner->depth) ||
+                    (depthFunc == D3D11_COMPARISON_GREATER && hit->depth > winner->depth) ||
+                    (depthFunc == D3D11_COMPARISON_GREATER_EQUAL && hit->depth >= winner->depth))
+            {
+              // For depth functions with an inequality, find the hit that "wins" the most
+              winner = hit;
+              evalSampleCache = ((float *)evalData) + evalSampleCacheData.size() * 4 * i;
+            }
+          }
         }
       }
-    }
-  }
 
-  if(winner == NULL)
-  {
-    RDCLOG("Couldn't find any pixels that passed depth test at target co-ordinates");
-    SAFE_DELETE_ARRAY(initialData);
-    SAFE_DELETE_ARRAY(evalData);
-    return new ShaderDebugTrace;
-  }
+      InterpretDebugger *interpreter = new InterpretDebugger;
+      ShaderDebugTrace *ret = interpreter->BeginDebug(dxbc, refl, ps->GetMapping(), destIdx);
+      GlobalState &global = interpreter->global;
+      ThreadState &state = interpreter->activeLane();
 
-  tracker.State().ApplyState(m_pImmediateContext);
+      if(!cbuffersFetched)
+      {
+        size_t firstVar = ret->sourceVars.size();
 
-  InterpretDebugger *interpreter = new InterpretDebugger;
-  ShaderDebugTrace *ret = interpreter->BeginDebug(dxbc, refl, ps->GetMapping(), destIdx);
-  GlobalState &global = interpreter->global;
-  ThreadState &state = interpreter->activeLane();
+        AddCBuffersToGlobalState(*dxbc->GetDXBCByteCode(), *GetDebugManager(), global,
+                                 ret->sourceVars, rs->PS, refl, ps->GetMapping());
 
-  AddCBuffersToGlobalState(*dxbc->GetDXBCByteCode(), *GetDebugManager(), global, ret->sourceVars,
-                           rs->PS, refl, ps->GetMapping());
+        constantBlocks = global.constantBlocks;
+        cbufferSourceVars.append(ret->sourceVars.data() + firstVar,
+                                 ret->sourceVars.size() - firstVar);
+        cbuffersFetched = true;
+      }
+      else
+      {
+        global.constantBlocks = constantBlocks;
+        ret->sourceVars.append(cbufferSourceVars);
+      }
 
-  global.sampleEvalRegisterMask = sampleEvalRegisterMask;
+      global.sampleEvalRegisterMask = sampleEvalRegisterMask;
 
-  {
-    DebugHit *hit = winner;
+      {
+        DebugHit *hit = winner;
 
-    rdcarray<ShaderVariable> &ins = state.inputs;
-    if(!ins.empty() &&
-       ins.back().name ==
-           dxbc->GetDXBCByteCode()->GetRegisterName(DXBCBytecode::TYPE_INPUT_COVERAGE_MASK, 0))
-      ins.back().value.u.x = hit->coverage;
+        rdcarray<ShaderVariable> &ins = state.inputs;
+        if(!ins.empty() &&
+           ins.back().name ==
+               dxbc->GetDXBCByteCode()->GetRegisterName(DXBCBytecode::TYPE_INPUT_COVERAGE_MASK, 0))
+          ins.back().value.u.x = hit->coverage;
 
-    state.semantics.coverage = hit->coverage;
-    state.semantics.primID = hit->primitive;
-    state.semantics.isFrontFace = hit->isFrontFace;
+        state.semantics.coverage = hit->coverage;
+        state.semantics.primID = hit->primitive;
+        state.semantics.isFrontFace = hit->isFrontFace;
 
-    uint32_t *data = &hit->rawdata;
+        uint32_t *data = &hit->rawdata;
 
-    float *pos_ddx = (float *)data;
+        float *pos_ddx = (float *)data;
 
-    // ddx(SV_Position.x) MUST be 1.0
-    if(*pos_ddx != 1.0f)
-    {
-      RDCERR("Derivatives invalid");
-      SAFE_DELETE_ARRAY(initialData);
-      SAFE_DELETE_ARRAY(evalData);
-      delete interpreter;
-      delete ret;
-      return new ShaderDebugTrace;
-    }
+        // ddx(SV_Position.x) MUST be 1.0
+        if(*pos_ddx != 1.0f)
+        {
+          RDCERR("Derivatives invalid at (%u,%u)", px, py);
+          delete interpreter;
+          delete ret;
+          continue;
+        }
 
-    data++;
+        data++;
 
-    for(size_t i = 0; i < initialValues.size(); i++)
-    {
-      int32_t *rawout = NULL;
+        for(size_t i = 0; i < initialValues.size(); i++)
+        {
+          int32_t *rawout = NULL;
 
-      if(initialValues[i].reg >= 0)
-      {
-        ShaderVariable &invar = ins[initialValues[i].reg];
+          if(initialValues[i].reg >= 0)
+          {
+            ShaderVariable &invar = ins[initialValues[i].reg];
 
-        if(initialValues[i].sysattribute == ShaderBuiltin::PrimitiveIndex)
-        {
-          invar.value.u.x = hit->primitive;
-        }
-        else if(initialValues[i].sysattribute == ShaderBuiltin::MSAASampleIndex)
-        {
-          invar.value.u.x = hit->sample;
-        }
-        else if(initialValues[i].sysattribute == ShaderBuiltin::MSAACoverage)
-        {
-          invar.value.u.x = hit->coverage;
+            if(initialValues[i].sysattribute == ShaderBuiltin::PrimitiveIndex)
+            {
+              invar.value.u.x = hit->primitive;
+            }
+            else if(initialValues[i].sysattribute == ShaderBuiltin::MSAASampleIndex)
+            {
+              invar.value.u.x = hit->sample;
+            }
+            else if(initialValues[i].sysattribute == ShaderBuiltin::MSAACoverage)
+            {
+              invar.value.u.x = hit->coverage;
+            }
+            else if(initialValues[i].sysattribute == ShaderBuiltin::IsFrontFace)
+            {
+              invar.value.u.x = hit->isFrontFace ? ~0U : 0;
+            }
+            else
+            {
+              rawout = &invar.value.iv[initialValues[i].elem];
+
+              memcpy(rawout, data, initialValues[i].numwords * 4);
+            }
+          }
+
+          if(initialValues[i].included)
+            data += initialValues[i].numwords;
         }
-        else if(initialValues[i].sysattribute == ShaderBuiltin::IsFrontFace)
+
+        for(int i = 0; i < 4; i++)
         {
-          invar.value.u.x = hit->isFrontFace ? ~0U : 0;
+          if(i != destIdx)
+          {
+            interpreter->workgroup[i].inputs = state.inputs;
+            interpreter->workgroup[i].semantics = state.semantics;
+            interpreter->workgroup[i].variables = state.variables;
+            interpreter->workgroup[i].SetHelper();
+          }
         }
-        else
+
+        // fetch any inputs that were evaluated at sample granularity
+        for(const GlobalState::SampleEvalCacheKey &key : evalSampleCacheData)
         {
-          rawout = &invar.value.iv[initialValues[i].elem];
+          // start with the basic input value
+          ShaderVariable var = state.inputs[key.inputRegisterIndex];
 
-          memcpy(rawout, data, initialValues[i].numwords * 4);
+          // copy over the value into the variable
+          memcpy(var.value.fv, evalSampleCache, var.columns * sizeof(float));
+
+          // store in the global cache for each quad. We'll apply derivatives below to adjust for
+          // each
+          GlobalState::SampleEvalCacheKey k = key;
+          for(int i = 0; i < 4; i++)
+          {
+            k.quadIndex = i;
+            global.sampleEvalCache[k] = var;
+          }
+
+          // advance past this data - always by float4 as that's the buffer stride
+          evalSampleCache += 4;
         }
+
+        ApplyAllDerivatives(global, interpreter->workgroup, destIdx, initialValues, (float *)data);
       }
 
-      if(initialValues[i].included)
-        data += initialValues[i].numwords;
-    }
+      ret->inputs = state.inputs;
+      ret->constantBlocks = global.constantBlocks;
 
-    for(int i = 0; i < 4; i++)
-    {
-      if(i != destIdx)
-      {
-        interpreter->workgroup[i].inputs = state.inputs;
-        interpreter->workgroup[i].semantics = state.semantics;
-        interpreter->workgroup[i].variables = state.variables;
-        interpreter->workgroup[i].SetHelper();
-      }
+      dxbc->FillTraceLineInfo(*ret);
+
+      callback(px, py, ret);
     }
+  }
 
-    // fetch any inputs that were evaluated at sample granularity
-    for(const GlobalState::SampleEvalCacheKey &key : evalSampleCacheData)
-    {
-      // start with the basic input value
-      ShaderVariable var = state.inputs[key.inputRegisterIndex];
+  SAFE_DELETE_ARRAY(initialData);
+  SAFE_DELETE_ARRAY(evalData);
+}
 
-      // copy over the value into the variable
-      memcpy(var.value.fv, evalSampleCache, var.columns * sizeof(float));
+ShaderDebugTrace *D3D11Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
+                                          uint32_t primitive)
+{
+  ShaderDebugTrace *ret = NULL;
 
-      // store in the global cache for each quad. We'll apply derivatives below to adjust for each
-      GlobalState::SampleEvalCacheKey k = key;
-      for(int i = 0; i < 4; i++)
-      {
-        k.quadIndex = i;
-        global.sampleEvalCache[k] = var;
-      }
+  DebugPixelRect(eventId, x, y, 1, 1, sample, primitive,
+                 [&ret](uint32_t, uint32_t, ShaderDebugTrace *trace) { ret = trace; });
 
-      // advance past this data - always by float4 as that's the buffer stride
-      evalSampleCache += 4;
-    }
+  if(ret == NULL)
+    ret = new ShaderDebugTrace;
 
-    ApplyAllDerivatives(global, interpreter->workgroup, destIdx, initialValues, (float *)data);
-  }
+  return ret;
+}
 
-  ret->inputs = state.inputs;
-  ret->constantBlocks = global.constantBlocks;
+rdcarray<PixelDebugSummary> D3D11Replay::DebugPixels(uint32_t eventId, uint32_t x, uint32_t y,
+                                                     uint32_t width, uint32_t height,
+                                                     uint32_t sample, uint32_t primitive)
+{
+  rdcarray<PixelDebugSummary> ret = PrepareDebugPixelSummaries(x, y, width, height);
 
-  SAFE_DELETE_ARRAY(initialData);
-  SAFE_DELETE_ARRAY(evalData);
+  if(ret.empty())
+    return ret;
 
-  dxbc->FillTraceLineInfo(*ret);
+  DebugPixelRect(eventId, x, y, width, height, sample, primitive,
+                 [this, &ret, x, y, width](uint32_t px, uint32_t py, ShaderDebugTrace *trace) {
+                   SummariseDebugTrace(this, trace, ret[(py - y) * width + (px - x)]);
+                 });
 
   return ret;
 }
@@ -2955,6 +3037,12 @@ rdcarray<ShaderDebugState> D3D11Replay::ContinueDebug(ShaderDebugger *debugger)
   return interpreter->ContinueDebug(&apiWrapper);
 }
 
+rdcarray<ShaderDebugState> D3D11Replay::ContinueDebugToCondition(
+    ShaderDebugger *debugger, const ShaderDebugStopCondition &condition)
+{
+  return ContinueDebugUntil(this, debugger, condition);
+}
+
 void D3D11Replay::FreeDebugger(ShaderDebugger *debugger)
 {
   delete debugger;
@@ -2451,20 +2451,6 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
 
     GetResourceManager()->InsertReferencedChunks(ser);
 
-    GetResourceManager()->InsertInitialContentsChunks(ser);
-
-    RDCDEBUG("Creating Capture Scope");
-
-    GetResourceManager()->Serialise_InitialContentsNeeded(ser);
-
-    {
-      SCOPED_SERIALISE_CHUNK(SystemChunk::CaptureScope, 16);
-
-      Serialise_CaptureScope(ser);
-    }
-
-    m_HeaderChunk->Write(ser);
-
     // don't need to lock access to m_CmdListRecords as we are no longer
     // in capframe (the transition is thread-protected) so nothing will be
     // pushed to the vector
@@ -2498,6 +2484,20 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
 
     m_FrameCaptureRecord->Insert(recordlist);
 
+    GetResourceManager()->InsertInitialContentsChunks(ser, recordlist);
+
+    RDCDEBUG("Creating Capture Scope");
+
+    GetResourceManager()->Serialise_InitialContentsNeeded(ser);
+
+    {
+      SCOPED_SERIALISE_CHUNK(SystemChunk::CaptureScope, 16);
+
+      Serialise_CaptureScope(ser);
+    }
+
+    m_HeaderChunk->Write(ser);
+
     RDCDEBUG("Flushing %u chunks to file serialiser from context record",
              (uint32_t)recordlist.size());
 
@@ -3628,6 +3628,15 @@ bool WrappedID3D12Device::ProcessChunk(ReadSerialiser &ser, D3D12Chunk context)
     {
       return GetResourceManager()->Serialise_InitialState(ser, ResourceId(), NULL, NULL);
     }
+    else if(system == SystemChunk::DegradedInitialContents)
+    {
+      rdcstr warning;
+      if(!GetResourceManager()->ReadDegradedInitialContents(ser, warning))
+        return false;
+
+      AddDebugMessage(MessageCategory::Resource_Manipulation, MessageSeverity::Medium,
+                      MessageSource::RuntimeWarning, warning);
+    }
     else if(system == SystemChunk::CaptureScope)
     {
       return Serialise_CaptureScope(ser);
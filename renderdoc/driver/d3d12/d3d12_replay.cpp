@@ -3069,6 +3069,13 @@ void D3D12Replay::GetTextureData(ResourceId tex, const Subresource &sub,
   else
     s.slice = RDCMIN(uint32_t(resDesc.DepthOrArraySize - 1), s.slice);
 
+  // the dimensions of the subresource we're fetching, for cropping to params.region
+  const uint32_t mipWidth = RDCMAX(1U, uint32_t(resDesc.Width >> s.mip));
+  const uint32_t mipHeight = RDCMAX(1U, resDesc.Height >> s.mip);
+  const uint32_t mipDepth = resDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D
+                                ? RDCMAX(1U, uint32_t(resDesc.DepthOrArraySize >> s.mip))
+                                : 1U;
+
   D3D12_RESOURCE_DESC copyDesc = resDesc;
   copyDesc.Alignment = 0;
   copyDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
@@ -3456,13 +3463,50 @@ void D3D12Replay::GetTextureData(ResourceId tex, const Subresource &sub,
   UINT arrayStride = copyDesc.MipLevels;
   UINT planeStride = copyDesc.DepthOrArraySize * copyDesc.MipLevels;
 
+  // when only params.region is wanted, only that box is copied into the readback buffer. Copies of
+  // depth-stencil resources must be of whole subresources, so those are cropped after reading back.
+  const bool cropOnCopy = !params.region.IsWhole() && !isDepth;
+
+  D3D12_BOX cropBox = {};
+
+  // the footprints are laid out for a texture of just the region, with one mip and slice
+  D3D12_RESOURCE_DESC footprintDesc = copyDesc;
+  UINT footprintPlaneStride = planeStride;
+
+  if(cropOnCopy)
+  {
+    const uint32_t blockSize = IsBlockFormat(copyDesc.Format) ? 4 : 1;
+
+    const TextureRegion cropRegion =
+        ClampTextureRegion(params.region, mipWidth, mipHeight, mipDepth, blockSize);
+
+    cropBox.left = cropRegion.x;
+    cropBox.top = cropRegion.y;
+    cropBox.front = cropRegion.z;
+    cropBox.right = cropRegion.x + cropRegion.width;
+    cropBox.bottom = cropRegion.y + cropRegion.height;
+    cropBox.back = cropRegion.z + cropRegion.depth;
+
+    // a footprint of block-compressed data covers whole blocks, even where the box ends in a
+    // partial block at the edge of the subresource
+    footprintDesc.Width = AlignUp(cropRegion.width, blockSize);
+    footprintDesc.Height = AlignUp(cropRegion.height, blockSize);
+    footprintDesc.DepthOrArraySize =
+        copyDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? (UINT16)cropRegion.depth : 1;
+    footprintDesc.MipLevels = 1;
+    footprintPlaneStride = 1;
+  }
+
   for(UINT p = 0; p < planes; p++)
   {
     readbackDesc.Width = AlignUp(readbackDesc.Width, 512ULL);
 
+    const UINT footprintSub =
+        cropOnCopy ? p * footprintPlaneStride : s.mip + s.slice * arrayStride + p * planeStride;
+
     UINT64 subSize = 0;
-    m_pDevice->GetCopyableFootprints(&copyDesc, s.mip + s.slice * arrayStride + p * planeStride, 1,
-                                     readbackDesc.Width, layouts + p, rowcounts + p, NULL, &subSize);
+    m_pDevice->GetCopyableFootprints(&footprintDesc, footprintSub, 1, readbackDesc.Width,
+                                     layouts + p, rowcounts + p, NULL, &subSize);
     readbackDesc.Width += subSize;
   }
 
@@ -3493,7 +3537,7 @@ void D3D12Replay::GetTextureData(ResourceId tex, const Subresource &sub,
     dst.pResource = readbackBuf;
     dst.PlacedFootprint = layouts[p];
 
-    list->CopyTextureRegion(&dst, 0, 0, 0, &src, NULL);
+    list->CopyTextureRegion(&dst, 0, 0, 0, &src, cropOnCopy ? &cropBox : NULL);
   }
 
   // if we have no tmpImage, we're copying directly from the real image
@@ -3609,7 +3653,7 @@ void D3D12Replay::GetTextureData(ResourceId tex, const Subresource &sub,
     }
 
     // for 3D textures if we wanted a particular slice (slice3DCopy > 0) copy it into the beginning.
-    if(layouts[0].Footprint.Depth > 1 && slice3DCopy > 0 &&
+    if(!cropOnCopy && layouts[0].Footprint.Depth > 1 && slice3DCopy > 0 &&
        (int)slice3DCopy < layouts[0].Footprint.Depth)
     {
       for(UINT y = 0; y < rowcount; y++)
@@ -3634,6 +3678,9 @@ void D3D12Replay::GetTextureData(ResourceId tex, const Subresource &sub,
   // clean up temporary objects
   SAFE_RELEASE(readbackBuf);
   SAFE_RELEASE(tmpTexture);
+
+  if(!cropOnCopy)
+    CropTextureData(GetTexture(tex), sub, params, data);
 }
 
 void D3D12Replay::BuildCustomShader(ShaderEncoding sourceEncoding, const bytebuf &source,
@@ -23,9 +23,11 @@
  ******************************************************************************/
 
 #include "d3d12_resources.h"
+#include "common/shader_cache.h"
 #include "driver/shaders/dxbc/dxbc_reflect.h"
 #include "d3d12_command_list.h"
 #include "d3d12_command_queue.h"
+#include "d3d12_shader_cache.h"
 
 GPUAddressRangeTracker WrappedID3D12Resource::m_Addresses;
 std::map<WrappedID3D12PipelineState::DXBCKey, WrappedID3D12Shader *> WrappedID3D12Shader::m_Shaders;
@@ -377,8 +379,29 @@ void WrappedID3D12PipelineState::ShaderEntry::BuildReflection()
       D3Dx_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT == D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT,
       "Mismatched vertex input count");
 
+  ShaderReflectionCache *cache = NULL;
+  if(m_pDevice->GetShaderCache())
+    cache = m_pDevice->GetShaderCache()->GetReflectionCache();
+
+  ShaderHash hash;
+  bool cacheable = cache && GetShaderReflectionHash(m_Bytecode, rdcstr(), GraphicsAPI::D3D12,
+                                                    m_ShaderExtSlot, m_ShaderExtSpace, hash);
+
+  if(cacheable && GetCachedShaderReflection(cache, hash, &m_Details, &m_Mapping))
+  {
+    m_Details.rawBytes = m_Bytecode;
+    m_Details.resourceId = GetResourceID();
+    return;
+  }
+
+  if(GetDXBC() == NULL)
+    return;
+
   MakeShaderReflection(m_DXBCFile, &m_Details, &m_Mapping);
   m_Details.resourceId = GetResourceID();
+
+  if(cacheable)
+    CacheShaderReflection(cache, hash, m_Details, m_Mapping);
 }
 
 UINT GetPlaneForSubresource(ID3D12Resource *res, int Subresource)
@@ -787,7 +787,7 @@ public:
     }
     ShaderReflection &GetDetails()
     {
-      if(!m_Built && GetDXBC() != NULL)
+      if(!m_Built)
         BuildReflection();
       m_Built = true;
       return m_Details;
@@ -795,7 +795,7 @@ public:
 
     const ShaderBindpointMapping &GetMapping()
     {
-      if(!m_Built && GetDXBC() != NULL)
+      if(!m_Built)
         BuildReflection();
       m_Built = true;
       return m_Mapping;
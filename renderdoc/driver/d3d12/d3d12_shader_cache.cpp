@@ -308,10 +308,16 @@ D3D12ShaderCache::D3D12ShaderCache()
 
   // if we failed to load from the cache
   m_ShaderCacheDirty = !success;
+
+  if(RenderDoc::Inst().IsReplayApp())
+    m_ReflectionCache = new ShaderReflectionCache("d3d12reflection.cache", m_ReflectionCacheMagic,
+                                                  m_ReflectionCacheVersion);
 }
 
 D3D12ShaderCache::~D3D12ShaderCache()
 {
+  SAFE_DELETE(m_ReflectionCache);
+
   if(m_ShaderCacheDirty)
   {
     SaveShaderCache("d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, m_ShaderCache,
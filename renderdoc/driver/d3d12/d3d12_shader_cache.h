@@ -31,6 +31,7 @@
 #include "d3d12_common.h"
 
 class WrappedID3D11Device;
+class ShaderReflectionCache;
 
 class D3D12ShaderCache
 {
@@ -62,10 +63,17 @@ public:
   ID3DBlob *GetQuadShaderDXILBlob();
 
   void SetCaching(bool enabled) { m_CacheShaders = enabled; }
+  ShaderReflectionCache *GetReflectionCache() { return m_ReflectionCache; }
 private:
   static const uint32_t m_ShaderCacheMagic = 0xf000baba;
   static const uint32_t m_ShaderCacheVersion = 3;
 
+  static const uint32_t m_ReflectionCacheMagic = 0xf000d12f;
+  static const uint32_t m_ReflectionCacheVersion = 1;
+
   bool m_ShaderCacheDirty = false, m_CacheShaders = false;
   std::map<uint32_t, ID3DBlob *> m_ShaderCache;
+
+  // only used on replay, for the application's shaders
+  ShaderReflectionCache *m_ReflectionCache = NULL;
 };
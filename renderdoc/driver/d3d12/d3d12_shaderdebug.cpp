@@ -2122,8 +2122,9 @@ ShaderDebugTrace *D3D12Replay::DebugVertex(uint32_t eventId, uint32_t vertid, ui
   return ret;
 }
 
-ShaderDebugTrace *D3D12Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
-                                          uint32_t primitive)
+void D3D12Replay::DebugPixelRect(uint32_t eventId, uint32_t x, uint32_t y, uint32_t width,
+                                 uint32_t height, uint32_t sample, uint32_t primitive,
+                                 const PixelDebugCallback &callback)
 {
   using namespace DXBC;
   using namespace DXBCBytecode;
@@ -2131,7 +2132,8 @@ ShaderDebugTrace *D3D12Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
 
   D3D12MarkerRegion debugpixRegion(
       m_pDevice->GetQueue()->GetReal(),
-      StringFormat::Fmt("DebugPixel @ %u of (%u,%u) %u / %u", eventId, x, y, sample, primitive));
+      StringFormat::Fmt("DebugPixel @ %u of (%u,%u) %ux%u %u / %u", eventId, x, y, width, height,
+                        sample, primitive));
 
   const D3D12Pipe::State *pipelineState = GetD3D12PipelineState();
 
@@ -2142,7 +2144,7 @@ ShaderDebugTrace *D3D12Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
   if(!ps)
   {
     RDCERR("Can't debug with no current pixel shader");
-    return new ShaderDebugTrace;
+    return;
   }
 
   DXBCContainer *dxbc = ps->GetDXBC();
@@ -2151,13 +2153,13 @@ ShaderDebugTrace *D3D12Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
   if(!dxbc)
   {
     RDCERR("Pixel shader couldn't be reflected");
-    return new ShaderDebugTrace;
+    return;
   }
 
   if(!refl.debugInfo.debuggable)
   {
     RDCERR("Pixel shader is not debuggable");
-    return new ShaderDebugTrace;
+    return;
   }
 
   dxbc->GetDisassembly();
@@ -2201,7 +2203,8 @@ ShaderDebugTrace *D3D12Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t
                                                floatInputs, inputVarNames, extractHlsl,
                                                structureStride);
 
-  uint32_t overdrawLevels = 100;    // maximum number of overdraw levels
+  // maximum number of fragments stored, shared between all the pixels in the rectangle
+  const uint32_t overdrawLevels = PixelDebugHitCapacity(width, height);
 
   // If the pipe contains a geometry shader, then SV_PrimitiveID cannot be used in the pixel
   // shader without being emitted from the geometry shader. For now, check if this semantic
@@ -2367,7 +2370,9 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
 
   extractHlsl += "  uint idx = " + ToStr(overdrawLevels) + ";\n";
   extractHlsl += StringFormat::Fmt(
-      "  if(abs(debug_pixelPos.x - %u.5) < 0.5f && abs(debug_pixelPos.y - %u.5) < 0.5f)\n", x, y);
+      "  if(debug_pixelPos.x >= %u.0f && debug_pixelPos.x < %u.0f &&\n"
+      "     debug_pixelPos.y >= %u.0f && debug_pixelPos.y < %u.0f)\n",
+      x, x + width, y, y + height);
   extractHlsl += "    InterlockedAdd(PSInitialBuffer[0].hit, 1, idx);\n\n";
   extractHlsl += "  idx = min(idx, " + ToStr(overdrawLevels) + ");\n\n";
   extractHlsl += "  PSInitialBuffer[idx].pos = debug_pixelPos.xyz;\n";
@@ -2467,7 +2472,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
                                                 "ps_5_0", &psBlob) != "")
   {
     RDCERR("Failed to create shader to extract inputs");
-    return new ShaderDebugTrace;
+    return;
   }
 
   uint32_t structStride = sizeof(uint32_t)       // uint hit;
@@ -2512,7 +2517,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
   {
     RDCERR("Failed to create buffer for pixel shader debugging HRESULT: %s", ToStr(hr).c_str());
     SAFE_RELEASE(psBlob);
-    return new ShaderDebugTrace;
+    return;
   }
 
   // Create buffer to store MSAA evaluations captured in pixel shader
@@ -2529,7 +2534,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
              ToStr(hr).c_str());
       SAFE_RELEASE(pInitialValuesBuffer);
       SAFE_RELEASE(psBlob);
-      return new ShaderDebugTrace;
+      return;
     }
   }
 
@@ -2613,7 +2618,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     SAFE_RELEASE(psBlob);
     SAFE_RELEASE(pInitialValuesBuffer);
     SAFE_RELEASE(pMsaaEvalBuffer);
-    return new ShaderDebugTrace;
+    return;
   }
   SAFE_RELEASE(root);
 
@@ -2631,7 +2636,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     SAFE_RELEASE(pInitialValuesBuffer);
     SAFE_RELEASE(pMsaaEvalBuffer);
     SAFE_RELEASE(pRootSignature);
-    return new ShaderDebugTrace;
+    return;
   }
 
   // Add the descriptor for our UAV, then clear it
@@ -2666,7 +2671,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
     SAFE_RELEASE(pMsaaEvalBuffer);
     SAFE_RELEASE(pRootSignature);
     SAFE_RELEASE(initialPso);
-    return new ShaderDebugTrace;
+    return;
   }
 
   {
@@ -2712,206 +2717,291 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position,
   if(buf[0].numHits == 0)
   {
     RDCLOG("No hit for this event");
-    return new ShaderDebugTrace;
+    return;
   }
 
-  // if we encounter multiple hits at our destination pixel co-ord (or any other) we
-  // check to see if a specific primitive was requested (via primitive parameter not
-  // being set to ~0U). If it was, debug that pixel, otherwise do a best-estimate
-  // of which fragment was the last to successfully depth test and debug that, just by
-  // checking if the depth test is ordered and picking the final fragment in the series
+  if(buf[0].numHits > overdrawLevels)
+    RDCWARN("%u hits, more than the %u that could be stored. Some fragments will be missing",
+            buf[0].numHits, overdrawLevels);
+
+  // sort the hits into the pixels they landed in, keeping the order they were written in
+  rdcarray<rdcarray<uint32_t>> pixelHits;
+  pixelHits.resize(width * height);
+
+  for(uint32_t i = 0; i < buf[0].numHits && i < overdrawLevels; i++)
+  {
+    DebugHit *pHit = (DebugHit *)(initialData.data() + i * structStride);
 
-  // figure out the TL pixel's coords. Assume even top left (towards 0,0)
-  // this isn't spec'd but is a reasonable assumption.
-  int xTL = x & (~1);
-  int yTL = y & (~1);
+    const uint32_t col = uint32_t(pHit->posx) - x;
+    const uint32_t row = uint32_t(pHit->posy) - y;
 
-  // get the index of our desired pixel
-  int destIdx = (x - xTL) + 2 * (y - yTL);
+    if(col < width && row < height)
+      pixelHits[row * width + col].push_back(i);
+  }
 
   // Get depth func and determine "winner" pixel
   D3D12_COMPARISON_FUNC depthFunc = pipeDesc.DepthStencilState.DepthFunc;
-  DebugHit *pWinnerHit = NULL;
-  float *evalSampleCache = (float *)evalData.data();
 
   if(sample == ~0U)
     sample = 0;
 
-  if(primitive != ~0U)
+  // the constant buffers are the same for every pixel, so they're only fetched once
+  bool cbuffersFetched = false;
+  rdcarray<ShaderVariable> constantBlocks;
+  rdcarray<SourceVariableMapping> cbufferSourceVars;
+
+  for(uint32_t row = 0; row < height; row++)
   {
-    for(size_t i = 0; i < buf[0].numHits && i < overdrawLevels; i++)
+    for(uint32_t col = 0; col < width; col++)
     {
-      DebugHit *pHit = (DebugHit *)(initialData.data() + i * structStride);
+      const rdcarray<uint32_t> &hits = pixelHits[row * width + col];
 
-      if(pHit->primitive == primitive && pHit->sample == sample)
-      {
-        pWinnerHit = pHit;
-        evalSampleCache = ((float *)evalData.data() + evalSampleCacheData.size() * 4 * i);
-      }
-    }
-  }
+      if(hits.empty())
+        continue;
 
-  if(pWinnerHit == NULL)
-  {
-    for(size_t i = 0; i < buf[0].numHits && i < overdrawLevels; i++)
-    {
-      DebugHit *pHit = (DebugHit *)(initialData.data() + i * structStride);
+      const uint32_t px = x + col;
+      const uint32_t py = y + row;
 
-      if(pWinnerHit == NULL)
-      {
-        // If we haven't picked a winner at all yet, use the first one
-        pWinnerHit = pHit;
-        evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
-      }
-      else if(pHit->sample == sample)
+      // if we encounter multiple hits at our destination pixel co-ord (or any other) we
+      // check to see if a specific primitive was requested (via primitive parameter not
+      // being set to ~0U). If it was, debug that pixel, otherwise do a best-estimate
+      // of which fragment was the last to successfully depth test and debug that, just by
+      // checking if the depth test is ordered and picking the final fragment in the series
+
+      // figure out the TL pixel's coords. Assume even top left (towards 0,0)
+      // this isn't spec'd but is a reasonable assumption.
+      int xTL = px & (~1);
+      int yTL = py & (~1);
+
+      // get the index of our desired pixel
+      int destIdx = (px - xTL) + 2 * (py - yTL);
+
+      DebugHit *pWinnerHit = NULL;
+      float *evalSampleCache = (float *)evalData.data();
+
+      if(primitive != ~0U)
       {
-        // If this hit is for the sample we want, check whether it's a better pick
-        if(pWinnerHit->sample != sample)
-        {
-          // The previously selected winner was for the wrong sample, use this one
-          pWinnerHit = pHit;
-          evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
-        }
-        else if((depthFunc == D3D12_COMPARISON_FUNC_ALWAYS ||
-                 depthFunc == D3D12_COMPARISON_FUNC_NEVER ||
-                 depthFunc == D3D12_COMPARISON_FUNC_NOT_EQUAL ||
-                 depthFunc == D3D12_COMPARISON_FUNC_EQUAL))
+        for(uint32_t i : hits)
         {
-          // For depth functions without an inequality comparison, use the last sample encountered
-          pWinnerHit = pHit;
-          evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
-        }
-        else if((depthFunc == D3D12_COMPARISON_FUNC_LESS && pHit->depth < pWinnerHit->depth) ||
-                (depthFunc == D3D12_COMPARISON_FUNC_LESS_EQUAL && pHit->depth <= pWinnerHit->depth) ||
-                (depthFunc == D3D12_COMPARISON_FUNC_GREATER && pHit->depth > pWinnerHit->depth) ||
-                (depthFunc == D3D12_COMPARISON_FUNC_GREATER_EQUAL && pHit->depth >= pWinnerHit->depth))
-        {
-          // For depth functions with an inequality, find the hit that "wins" the most
-          pWinnerHit = pHit;
-          evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
+          DebugHit *pHit = (DebugHit *)(initialData.data() + i * structStride);
+
+          if(pHit->primitive == primitive && pHit->sample == sample)
+          {
+            pWinnerHit = pHit;
+            evalSampleCache = ((float *)evalData.data() + evalSampleCacheData.size() * 4 * i);
+          }
         }
       }
-    }
-  }
-
-  if(pWinnerHit == NULL)
-  {
-    RDCLOG("Couldn't find any pixels that passed depth test at target coordinates");
-    return new ShaderDebugTrace;
-  }
 
-  InterpretDebugger *interpreter = new InterpretDebugger;
-  ShaderDebugTrace *ret = interpreter->BeginDebug(dxbc, refl, origPSO->PS()->GetMapping(), destIdx);
-  GlobalState &global = interpreter->global;
-  ThreadState &state = interpreter->activeLane();
+      if(pWinnerHit == NULL)
+      {
+        for(uint32_t i : hits)
+        {
+          DebugHit *pHit = (DebugHit *)(initialData.data() + i * structStride);
 
-  // Fetch constant buffer data from root signature
-  GatherConstantBuffers(m_pDevice, *dxbc->GetDXBCByteCode(), rs.graphics, refl,
-                        origPSO->PS()->GetMapping(), global, ret->sourceVars);
+          if(pWinnerHit == NULL)
+          {
+            // If we haven't picked a winner at all yet, use the first one
+            pWinnerHit = pHit;
+            evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
+          }
+          else if(pHit->sample == sample)
+          {
+            // If this hit is for the sample we want, check whether it's a better pick
+            if(pWinnerHit->sample != sample)
+            {
+              // The previously selected winner was for the wrong sample, use this one
+              pWinnerHit = pHit;
+              evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
+            }
+            else if((depthFunc == D3D12_COMPARISON_FUNC_ALWAYS ||
+                     depthFunc == D3D12_COMPARISON_FUNC_NEVER ||
+                     depthFunc == D3D12_COMPARISON_FUNC_NOT_EQUAL ||
+                     depthFunc == D3D12_COMPARISON_FUNC_EQUAL))
+            {
+              // For depth functions without an inequality comparison, use the last sample
+              // encountered
+              pWinnerHit = pHit;
+              evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
+            }
+            else if((depthFunc == D3D12_COMPARISON_FUNC_LESS && pHit->depth < pWinnerHit->depth) ||
+                    (depthFunc == D3D12_COMPARISON_FUNC_LESS_EQUAL &&
+                     pHit->depth <= pWinnerHit->depth) ||
+                    (depthFunc == D3D12_COMPARISON_FUNC_GREATER &&
+                     pHit->depth > pWinnerHit->depth) ||
+                    (depthFunc == D3D12_COMPARISON_FUNC_GREATER_EQUAL &&
+                     pHit->depth >= pWinnerHit->depth))
+            {
+              // For depth functions with an inequality, find the hit that "wins" the most
+              pWinnerHit = pHit;
+              evalSampleCache = ((float *)evalData.data()) + evalSampleCacheData.size() * 4 * i;
+            }
+          }
+        }
+      }
 
-  global.sampleEvalRegisterMask = sampleEvalRegisterMask;
+      InterpretDebugger *interpreter = new InterpretDebugger;
+      ShaderDebugTrace *ret =
+          interpreter->BeginDebug(dxbc, refl, origPSO->PS()->GetMapping(), destIdx);
+      GlobalState &global = interpreter->global;
+      ThreadState &state = interpreter->activeLane();
 
-  {
-    DebugHit *pHit = pWinnerHit;
+      if(!cbuffersFetched)
+      {
+        size_t firstVar = ret->sourceVars.size();
 
-    rdcarray<ShaderVariable> &ins = state.inputs;
-    if(!ins.empty() && ins.back().name == "vCoverage")
-      ins.back().value.u.x = pHit->coverage;
+        // Fetch constant buffer data from root signature
+        GatherConstantBuffers(m_pDevice, *dxbc->GetDXBCByteCode(), rs.graphics, refl,
+                              origPSO->PS()->GetMapping(), global, ret->sourceVars);
 
-    state.semantics.coverage = pHit->coverage;
-    state.semantics.primID = pHit->primitive;
-    state.semantics.isFrontFace = pHit->isFrontFace;
+        constantBlocks = global.constantBlocks;
+        cbufferSourceVars.append(ret->sourceVars.data() + firstVar,
+                                 ret->sourceVars.size() - firstVar);
+        cbuffersFetched = true;
+      }
+      else
+      {
+        global.constantBlocks = constantBlocks;
+        ret->sourceVars.append(cbufferSourceVars);
+      }
 
-    uint32_t *data = &pHit->rawdata;
+      global.sampleEvalRegisterMask = sampleEvalRegisterMask;
 
-    float *pos_ddx = (float *)data;
+      {
+        DebugHit *pHit = pWinnerHit;
 
-    // ddx(SV_Position.x) MUST be 1.0
-    if(*pos_ddx != 1.0f)
-    {
-      RDCERR("Derivatives invalid");
-      delete interpreter;
-      delete ret;
-      return new ShaderDebugTrace;
-    }
+        rdcarray<ShaderVariable> &ins = state.inputs;
+        if(!ins.empty() && ins.back().name == "vCoverage")
+          ins.back().value.u.x = pHit->coverage;
 
-    data++;
+        state.semantics.coverage = pHit->coverage;
+        state.semantics.primID = pHit->primitive;
+        state.semantics.isFrontFace = pHit->isFrontFace;
 
-    for(size_t i = 0; i < initialValues.size(); i++)
-    {
-      int32_t *rawout = NULL;
+        uint32_t *data = &pHit->rawdata;
 
-      if(initialValues[i].reg >= 0)
-      {
-        ShaderVariable &invar = ins[initialValues[i].reg];
+        float *pos_ddx = (float *)data;
 
-        if(initialValues[i].sysattribute == ShaderBuiltin::PrimitiveIndex)
+        // ddx(SV_Position.x) MUST be 1.0
+        if(*pos_ddx != 1.0f)
         {
-          invar.value.u.x = pHit->primitive;
+          RDCERR("Derivatives invalid at (%u,%u)", px, py);
+          delete interpreter;
+          delete ret;
+          continue;
         }
-        else if(initialValues[i].sysattribute == ShaderBuiltin::MSAASampleIndex)
-        {
-          invar.value.u.x = pHit->sample;
-        }
-        else if(initialValues[i].sysattribute == ShaderBuiltin::MSAACoverage)
+
+        data++;
+
+        for(size_t i = 0; i < initialValues.size(); i++)
         {
-          invar.value.u.x = pHit->coverage;
+          int32_t *rawout = NULL;
+
+          if(initialValues[i].reg >= 0)
+          {
+            ShaderVariable &invar = ins[initialValues[i].reg];
+
+            if(initialValues[i].sysattribute == ShaderBuiltin::PrimitiveIndex)
+            {
+              invar.value.u.x = pHit->primitive;
+            }
+            else if(initialValues[i].sysattribute == ShaderBuiltin::MSAASampleIndex)
+            {
+              invar.value.u.x = pHit->sample;
+            }
+            else if(initialValues[i].sysattribute == ShaderBuiltin::MSAACoverage)
+            {
+              invar.value.u.x = pHit->coverage;
+            }
+            else if(initialValues[i].sysattribute == ShaderBuiltin::IsFrontFace)
+            {
+              invar.value.u.x = pHit->isFrontFace ? ~0U : 0;
+            }
+            else
+            {
+              rawout = &invar.value.iv[initialValues[i].elem];
+
+              memcpy(rawout, data, initialValues[i].numwords * 4);
+            }
+          }
+
+          if(initialValues[i].included)
+            data += initialValues[i].numwords;
         }
-        else if(initialValues[i].sysattribute == ShaderBuiltin::IsFrontFace)
+
+        for(int i = 0; i < 4; i++)
         {
-          invar.value.u.x = pHit->isFrontFace ? ~0U : 0;
+          if(i != destIdx)
+          {
+            interpreter->workgroup[i].inputs = state.inputs;
+            interpreter->workgroup[i].semantics = state.semantics;
+            interpreter->workgroup[i].variables = state.variables;
+            interpreter->workgroup[i].SetHelper();
+          }
         }
-        else
+
+        // Fetch any inputs that were evaluated at sample granularity
+        for(const GlobalState::SampleEvalCacheKey &key : evalSampleCacheData)
         {
-          rawout = &invar.value.iv[initialValues[i].elem];
+          // start with the basic input value
+          ShaderVariable var = state.inputs[key.inputRegisterIndex];
+
+          // copy over the value into the variable
+          memcpy(var.value.fv, evalSampleCache, var.columns * sizeof(float));
+
+          // store in the global cache for each quad. We'll apply derivatives below to adjust for
+          // each
+          GlobalState::SampleEvalCacheKey k = key;
+          for(int i = 0; i < 4; i++)
+          {
+            k.quadIndex = i;
+            global.sampleEvalCache[k] = var;
+          }
 
-          memcpy(rawout, data, initialValues[i].numwords * 4);
+          // advance past this data - always by float4 as that's the buffer stride
+          evalSampleCache += 4;
         }
+
+        ApplyAllDerivatives(global, interpreter->workgroup, destIdx, initialValues, (float *)data);
       }
 
-      if(initialValues[i].included)
-        data += initialValues[i].numwords;
-    }
+      ret->constantBlocks = global.constantBlocks;
+      ret->inputs = state.inputs;
 
-    for(int i = 0; i < 4; i++)
-    {
-      if(i != destIdx)
-      {
-        interpreter->workgroup[i].inputs = state.inputs;
-        interpreter->workgroup[i].semantics = state.semantics;
-        interpreter->workgroup[i].variables = state.variables;
-        interpreter->workgroup[i].SetHelper();
-      }
+      dxbc->FillTraceLineInfo(*ret);
+
+      callback(px, py, ret);
     }
+  }
+}
 
-    // Fetch any inputs that were evaluated at sample granularity
-    for(const GlobalState::SampleEvalCacheKey &key : evalSampleCacheData)
-    {
-      // start with the basic input value
-      ShaderVariable var = state.inputs[key.inputRegisterIndex];
+ShaderDebugTrace *D3D12Replay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
+                                          uint32_t primitive)
+{
+  ShaderDebugTrace *ret = NULL;
 
-      // copy over the value into the variable
-      memcpy(var.value.fv, evalSampleCache, var.columns * sizeof(float));
+  DebugPixelRect(eventId, x, y, 1, 1, sample, primitive,
+                 [&ret](uint32_t, uint32_t, ShaderDebugTrace *trace) { ret = trace; });
 
-      // store in the global cache for each quad. We'll apply derivatives below to adjust for each
-      GlobalState::SampleEvalCacheKey k = key;
-      for(int i = 0; i < 4; i++)
-      {
-        k.quadIndex = i;
-        global.sampleEvalCache[k] = var;
-      }
+  if(ret == NULL)
+    ret = new ShaderDebugTrace;
 
-      // advance past this data - always by float4 as that's the buffer stride
-      evalSampleCache += 4;
-    }
+  return ret;
+}
 
-    ApplyAllDerivatives(global, interpreter->workgroup, destIdx, initialValues, (float *)data);
-  }
+rdcarray<PixelDebugSummary> D3D12Replay::DebugPixels(uint32_t eventId, uint32_t x, uint32_t y,
+                                                     uint32_t width, uint32_t height,
+                                                     uint32_t sample, uint32_t primitive)
+{
+  rdcarray<PixelDebugSummary> ret = PrepareDebugPixelSummaries(x, y, width, height);
 
-  ret->constantBlocks = global.constantBlocks;
-  ret->inputs = state.inputs;
+  if(ret.empty())
+    return ret;
 
-  dxbc->FillTraceLineInfo(*ret);
+  DebugPixelRect(eventId, x, y, width, height, sample, primitive,
+                 [this, &ret, x, y, width](uint32_t px, uint32_t py, ShaderDebugTrace *trace) {
+                   SummariseDebugTrace(this, trace, ret[(py - y) * width + (px - x)]);
+                 });
 
   return ret;
 }
@@ -3047,6 +3137,12 @@ rdcarray<ShaderDebugState> D3D12Replay::ContinueDebug(ShaderDebugger *debugger)
   return interpreter->ContinueDebug(&apiWrapper);
 }
 
+rdcarray<ShaderDebugState> D3D12Replay::ContinueDebugToCondition(
+    ShaderDebugger *debugger, const ShaderDebugStopCondition &condition)
+{
+  return ContinueDebugUntil(this, debugger, condition);
+}
+
 void D3D12Replay::FreeDebugger(ShaderDebugger *debugger)
 {
   delete debugger;
@@ -2338,7 +2338,26 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
 
       GetResourceManager()->InsertReferencedChunks(ser);
 
-      GetResourceManager()->InsertInitialContentsChunks(ser);
+      RDCDEBUG("Accumulating context resource list");
+
+      std::map<int64_t, Chunk *> recordlist;
+      m_ContextRecord->Insert(recordlist);
+
+      for(auto it = m_ContextData.begin(); it != m_ContextData.end(); ++it)
+      {
+        if(m_AcceptedCtx.empty() || m_AcceptedCtx.find(it->first) != m_AcceptedCtx.end())
+        {
+          GLResourceRecord *record = it->second.m_ContextDataRecord;
+          if(record)
+          {
+            RDCDEBUG("Getting Resource Record for context ID %s with %zu chunks",
+                     ToStr(it->second.m_ContextDataResourceID).c_str(), record->NumChunks());
+            record->Insert(recordlist);
+          }
+        }
+      }
+
+      GetResourceManager()->InsertInitialContentsChunks(ser, recordlist);
 
       RDCDEBUG("Creating Capture Scope");
 
@@ -2351,25 +2370,6 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
       }
 
       {
-        RDCDEBUG("Accumulating context resource list");
-
-        std::map<int64_t, Chunk *> recordlist;
-        m_ContextRecord->Insert(recordlist);
-
-        for(auto it = m_ContextData.begin(); it != m_ContextData.end(); ++it)
-        {
-          if(m_AcceptedCtx.empty() || m_AcceptedCtx.find(it->first) != m_AcceptedCtx.end())
-          {
-            GLResourceRecord *record = it->second.m_ContextDataRecord;
-            if(record)
-            {
-              RDCDEBUG("Getting Resource Record for context ID %s with %zu chunks",
-                       ToStr(it->second.m_ContextDataResourceID).c_str(), record->NumChunks());
-              record->Insert(recordlist);
-            }
-          }
-        }
-
         RDCDEBUG("Flushing %u records to file serialiser", (uint32_t)recordlist.size());
 
         float num = float(recordlist.size());
@@ -3449,6 +3449,15 @@ bool WrappedOpenGL::ProcessChunk(ReadSerialiser &ser, GLChunk chunk)
     {
       return GetResourceManager()->Serialise_InitialState(ser, ResourceId(), NULL, NULL);
     }
+    else if(system == SystemChunk::DegradedInitialContents)
+    {
+      rdcstr warning;
+      if(!GetResourceManager()->ReadDegradedInitialContents(ser, warning))
+        return false;
+
+      AddDebugMessage(MessageCategory::Resource_Manipulation, MessageSeverity::Medium,
+                      MessageSource::RuntimeWarning, warning);
+    }
     else if(system == SystemChunk::CaptureScope)
     {
       return Serialise_CaptureScope(ser);
@@ -976,6 +976,58 @@ void GLResourceManager::PrepareTextureInitialContents(ResourceId liveid, Resourc
   SetInitialContents(origid, initContents);
 }
 
+// estimate the serialised size of every mip of a texture's contents
+static uint64_t GetTextureContentsSize(const TextureStateInitialData &TextureState)
+{
+  uint64_t ret = 0;
+
+  bool isCompressed = IsCompressedFormat(TextureState.internalformat);
+
+  GLenum fmt = eGL_NONE;
+  GLenum type = eGL_NONE;
+
+  if(!isCompressed)
+  {
+    fmt = GetBaseFormat(TextureState.internalformat);
+    type = GetDataType(TextureState.internalformat);
+  }
+
+  // loop over all the mips and estimate their size
+  for(int i = 0; i < TextureState.mips; i++)
+  {
+    uint32_t w = RDCMAX(TextureState.width >> i, 1U);
+    uint32_t h = RDCMAX(TextureState.height >> i, 1U);
+    uint32_t d = RDCMAX(TextureState.depth >> i, 1U);
+
+    if(TextureState.type == eGL_TEXTURE_CUBE_MAP_ARRAY || TextureState.type == eGL_TEXTURE_2D_ARRAY)
+      d = TextureState.depth;
+
+    if(TextureState.samples > 1)
+      d = RDCMAX(1U, TextureState.depth) * TextureState.samples;
+
+    if(TextureState.type == eGL_TEXTURE_1D_ARRAY)
+      h = TextureState.height;
+
+    uint32_t size = 0;
+
+    // calculate the actual byte size of this mip
+    if(isCompressed)
+      size = (uint32_t)GetCompressedByteSize(w, h, d, TextureState.internalformat);
+    else
+      size = (uint32_t)GetByteSize(w, h, d, fmt, type);
+
+    int targetcount = 1;
+
+    if(TextureState.type == eGL_TEXTURE_CUBE_MAP)
+      targetcount = 6;
+
+    for(int t = 0; t < targetcount; t++)
+      ret += WriteSerialiser::GetChunkAlignment() + size;
+  }
+
+  return ret;
+}
+
 uint64_t GLResourceManager::GetSize_InitialState(ResourceId resid, const GLInitialContents &initial)
 {
   if(initial.type == eResBuffer)
@@ -1019,49 +1071,7 @@ uint64_t GLResourceManager::GetSize_InitialState(ResourceId resid, const GLIniti
        TextureState.isView)
       return ret;
 
-    bool isCompressed = IsCompressedFormat(TextureState.internalformat);
-
-    GLenum fmt = eGL_NONE;
-    GLenum type = eGL_NONE;
-
-    if(!isCompressed)
-    {
-      fmt = GetBaseFormat(TextureState.internalformat);
-      type = GetDataType(TextureState.internalformat);
-    }
-
-    // otherwise loop over all the mips and estimate their size
-    for(int i = 0; i < TextureState.mips; i++)
-    {
-      uint32_t w = RDCMAX(TextureState.width >> i, 1U);
-      uint32_t h = RDCMAX(TextureState.height >> i, 1U);
-      uint32_t d = RDCMAX(TextureState.depth >> i, 1U);
-
-      if(TextureState.type == eGL_TEXTURE_CUBE_MAP_ARRAY || TextureState.type == eGL_TEXTURE_2D_ARRAY)
-        d = TextureState.depth;
-
-      if(TextureState.samples > 1)
-        d = RDCMAX(1U, TextureState.depth) * TextureState.samples;
-
-      if(TextureState.type == eGL_TEXTURE_1D_ARRAY)
-        h = TextureState.height;
-
-      uint32_t size = 0;
-
-      // calculate the actual byte size of this mip
-      if(isCompressed)
-        size = (uint32_t)GetCompressedByteSize(w, h, d, TextureState.internalformat);
-      else
-        size = (uint32_t)GetByteSize(w, h, d, fmt, type);
-
-      int targetcount = 1;
-
-      if(TextureState.type == eGL_TEXTURE_CUBE_MAP)
-        targetcount = 6;
-
-      for(int t = 0; t < targetcount; t++)
-        ret += WriteSerialiser::GetChunkAlignment() + size;
-    }
+    ret += GetTextureContentsSize(TextureState);
 
     return ret;
   }
@@ -1097,6 +1107,57 @@ uint64_t GLResourceManager::GetSize_InitialState(ResourceId resid, const GLIniti
   return 16;
 }
 
+uint64_t GLResourceManager::GetSize_PostponedInitialState(ResourceId resid)
+{
+  GLResource res = GetCurrentResource(resid);
+
+  if(res.Namespace == eResBuffer)
+  {
+    GLResourceRecord *record = GetResourceRecord(resid);
+    if(record == NULL)
+      return 0;
+
+    return record->Length + WriteSerialiser::GetChunkAlignment() + 64;
+  }
+  else if(res.Namespace == eResTexture)
+  {
+    auto it = m_Driver->m_Textures.find(resid);
+    if(it == m_Driver->m_Textures.end())
+      return 0;
+
+    const WrappedOpenGL::TextureData &details = it->second;
+
+    uint64_t ret = sizeof(TextureStateInitialData) + 64;
+
+    if(details.internalFormat == eGL_NONE || details.curType == eGL_TEXTURE_BUFFER || details.view)
+      return ret;
+
+    // the mip count isn't known without querying the texture, which may belong to another context,
+    // so assume a full mip chain. Only multisampled and rectangle textures can't have mips.
+    TextureStateInitialData state = {};
+    state.internalformat = details.internalFormat;
+    state.width = details.width;
+    state.height = details.height;
+    state.depth = details.depth;
+    state.samples = details.samples;
+    state.type = details.curType;
+    state.mips = 1;
+
+    if(details.samples <= 1 && details.curType != eGL_TEXTURE_RECTANGLE)
+    {
+      // array layers don't shrink with each mip
+      int mipHeight = details.curType == eGL_TEXTURE_1D_ARRAY ? 1 : details.height;
+      int mipDepth = details.curType == eGL_TEXTURE_3D ? details.depth : 1;
+
+      state.mips = (int)CalcNumMips(details.width, mipHeight, mipDepth);
+    }
+
+    return ret + GetTextureContentsSize(state);
+  }
+
+  return 0;
+}
+
 template <typename SerialiserType>
 bool GLResourceManager::Serialise_InitialState(SerialiserType &ser, ResourceId id,
                                                GLResourceRecord *record,
@@ -329,6 +329,7 @@ private:
   bool ResourceTypeRelease(GLResource res);
   bool Prepare_InitialState(GLResource res);
   uint64_t GetSize_InitialState(ResourceId resid, const GLInitialContents &initial);
+  uint64_t GetSize_PostponedInitialState(ResourceId resid);
 
   void PrepareTextureInitialContents(ResourceId liveid, ResourceId origid, GLResource res);
 
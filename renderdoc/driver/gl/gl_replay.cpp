@@ -2370,6 +2370,9 @@ void GLReplay::GetTextureData(ResourceId tex, const Subresource &sub,
 
   GLuint tempTex = 0;
 
+  // set if only the requested region was read back, so no crop is needed afterwards
+  bool readRegion = false;
+
   Subresource s = sub;
 
   GLenum texType = texDetails.curType;
@@ -2816,44 +2819,89 @@ void GLReplay::GetTextureData(ResourceId tex, const Subresource &sub,
       GLenum fmt = GetBaseFormat(intFormat);
       GLenum type = GetDataType(intFormat);
 
-      size_t rowSize = GetByteSize(width, 1, 1, fmt, type);
-      dataSize = GetByteSize(width, height, depth, fmt, type);
-      data.resize(dataSize);
-
-      // see above for the logic of handling arrays
-      if(arraysize > 1)
+      if(!params.region.IsWhole() && HasExt[ARB_get_texture_sub_image])
       {
-        if(m_GetTexturePrevID != tex)
-        {
-          for(size_t i = 0; i < ARRAY_COUNT(m_GetTexturePrevData); i++)
-          {
-            delete[] m_GetTexturePrevData[i];
-            m_GetTexturePrevData[i] = NULL;
-          }
-        }
+        // read back only the requested region. Regions are in top-left co-ordinates, so flip the
+        // rows into GL's bottom-up origin. From here on the dimensions are those of the region
+        const TextureRegion region = ClampTextureRegion(params.region, width, height, depth, 1);
 
-        m_GetTexturePrevID = tex;
+        GLint xoffset = GLint(region.x);
+        GLint yoffset = height - GLint(region.y + region.height);
+        GLint zoffset = 0;
 
-        RDCASSERT(s.mip < ARRAY_COUNT(m_GetTexturePrevData));
+        width = GLsizei(region.width);
+        height = GLsizei(region.height);
+        depth = 1;
 
-        // if we don't have this mip cached, fetch it now
-        if(m_GetTexturePrevData[s.mip] == NULL)
+        if(texType == eGL_TEXTURE_3D)
         {
-          m_GetTexturePrevData[s.mip] = new byte[dataSize * arraysize];
-          drv.glGetTexImage(target, (GLint)s.mip, fmt, type, m_GetTexturePrevData[s.mip]);
+          zoffset = GLint(region.z);
+          depth = GLsizei(region.depth);
+        }
+        else if(texType == eGL_TEXTURE_CUBE_MAP)
+        {
+          // the face was picked out into the target above
+          zoffset = GLint(target) - GLint(eGL_TEXTURE_CUBE_MAP_POSITIVE_X);
+        }
+        else if(texType == eGL_TEXTURE_1D_ARRAY)
+        {
+          yoffset = GLint(s.slice);
+        }
+        else if(arraysize > 1)
+        {
+          zoffset = GLint(s.slice);
         }
 
-        // now copy the slice from the cache into ret
-        byte *src = m_GetTexturePrevData[s.mip];
-        src += dataSize * s.slice;
+        dataSize = GetByteSize(width, height, depth, fmt, type);
+        data.resize(dataSize);
 
-        memcpy(data.data(), src, dataSize);
+        drv.glGetTextureSubImage(texname, (GLint)s.mip, xoffset, yoffset, zoffset, width, height,
+                                 depth, fmt, type, (GLsizei)dataSize, data.data());
+
+        readRegion = true;
       }
       else
       {
-        drv.glGetTexImage(target, (GLint)s.mip, fmt, type, data.data());
+        dataSize = GetByteSize(width, height, depth, fmt, type);
+        data.resize(dataSize);
+
+        // see above for the logic of handling arrays
+        if(arraysize > 1)
+        {
+          if(m_GetTexturePrevID != tex)
+          {
+            for(size_t i = 0; i < ARRAY_COUNT(m_GetTexturePrevData); i++)
+            {
+              delete[] m_GetTexturePrevData[i];
+              m_GetTexturePrevData[i] = NULL;
+            }
+          }
+
+          m_GetTexturePrevID = tex;
+
+          RDCASSERT(s.mip < ARRAY_COUNT(m_GetTexturePrevData));
+
+          // if we don't have this mip cached, fetch it now
+          if(m_GetTexturePrevData[s.mip] == NULL)
+          {
+            m_GetTexturePrevData[s.mip] = new byte[dataSize * arraysize];
+            drv.glGetTexImage(target, (GLint)s.mip, fmt, type, m_GetTexturePrevData[s.mip]);
+          }
+
+          // now copy the slice from the cache into ret
+          byte *src = m_GetTexturePrevData[s.mip];
+          src += dataSize * s.slice;
+
+          memcpy(data.data(), src, dataSize);
+        }
+        else
+        {
+          drv.glGetTexImage(target, (GLint)s.mip, fmt, type, data.data());
+        }
       }
 
+      size_t rowSize = GetByteSize(width, 1, 1, fmt, type);
+
       if(params.standardLayout)
       {
         // GL puts D24 in the top bits (whether or not there's stencil). We choose to standardise it
@@ -2949,6 +2997,23 @@ void GLReplay::GetTextureData(ResourceId tex, const Subresource &sub,
 
   if(tempTex)
     drv.glDeleteTextures(1, &tempTex);
+
+  if(!params.region.IsWhole() && !readRegion)
+  {
+    GetTextureDataParams cropParams = params;
+
+    // regions are in top-left co-ordinates, but uncompressed data is bottom-up unless it's been
+    // flipped for saving to disk
+    if(!params.forDiskSave && !IsCompressedFormat(intFormat))
+    {
+      TextureRegion &region = cropParams.region;
+      region.y = RDCMIN(region.y, uint32_t(height - 1));
+      region.height = RDCMAX(1U, RDCMIN(region.height, uint32_t(height) - region.y));
+      region.y = uint32_t(height) - (region.y + region.height);
+    }
+
+    CropTextureData(GetTexture(tex), sub, cropParams, data);
+  }
 }
 
 void GLReplay::BuildCustomShader(ShaderEncoding sourceEncoding, const bytebuf &source,
@@ -3674,6 +3739,14 @@ ShaderDebugTrace *GLReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y,
   return new ShaderDebugTrace();
 }
 
+rdcarray<PixelDebugSummary> GLReplay::DebugPixels(uint32_t eventId, uint32_t x, uint32_t y,
+                                                  uint32_t width, uint32_t height, uint32_t sample,
+                                                  uint32_t primitive)
+{
+  GLNOTIMP("DebugPixels");
+  return {};
+}
+
 ShaderDebugTrace *GLReplay::DebugThread(uint32_t eventId, const uint32_t groupid[3],
                                         const uint32_t threadid[3])
 {
@@ -3687,6 +3760,13 @@ rdcarray<ShaderDebugState> GLReplay::ContinueDebug(ShaderDebugger *debugger)
   return {};
 }
 
+rdcarray<ShaderDebugState> GLReplay::ContinueDebugToCondition(
+    ShaderDebugger *debugger, const ShaderDebugStopCondition &condition)
+{
+  GLNOTIMP("ContinueDebugToCondition");
+  return {};
+}
+
 void GLReplay::FreeDebugger(ShaderDebugger *debugger)
 {
   delete debugger;
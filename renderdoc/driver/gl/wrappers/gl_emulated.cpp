@@ -3279,35 +3279,40 @@ void APIENTRY _glGetTexImage(GLenum target, GLint level, const GLenum format, co
             readFmt.compType = CompType::UNormSRGB;
         }
 
-        byte *srcPixel = readback;
-        byte *dstPixel = dst;
+        const size_t srcStride = readCompSize * readCompCount;
+        const size_t dstStride = origFmt.ElementSize();
 
-        // go pixel-by-pixel, reading in the readback format and writing in the dest format
-        for(GLint i = 0; i < width * height; i++)
+        // convert row-by-row, reading in the readback format and writing in the dest format
+        rdcarray<FloatVector> row;
+        row.resize(width);
+
+        for(GLint y = 0; y < height; y++)
         {
-          FloatVector vec = DecodeFormattedComponents(readFmt, srcPixel);
+          DecodeFormattedComponentsSpan(readFmt, readback + y * width * srcStride, srcStride, width,
+                                        row.data());
+          EncodeFormattedComponentsSpan(origFmt, row.data(), width, dst + y * width * dstStride,
+                                        dstStride);
+        }
 
-          EncodeFormattedComponents(origFmt, vec, dstPixel);
+        // GL expects ABGR order for these formats where our standard encoder writes BGRA, swizzle
+        // here
+        if(origFmt.type == ResourceFormatType::R4G4B4A4 ||
+           origFmt.type == ResourceFormatType::R5G5B5A1)
+        {
+          byte *dstPixel = dst;
 
-          // GL expects ABGR order for these formats where our standard encoder writes BGRA, swizzle
-          // here
-          if(origFmt.type == ResourceFormatType::R4G4B4A4)
-          {
-            uint16_t val = 0;
-            memcpy(&val, dstPixel, sizeof(val));
-            val = ((val & 0x0fff) << 4) | ((val & 0xf000) >> 12);
-            memcpy(dstPixel, &val, sizeof(val));
-          }
-          else if(origFmt.type == ResourceFormatType::R5G5B5A1)
+          for(GLint i = 0; i < width * height; i++)
           {
             uint16_t val = 0;
             memcpy(&val, dstPixel, sizeof(val));
-            val = ((val & 0x7fff) << 1) | ((val & 0x8000) >> 12);
+            if(origFmt.type == ResourceFormatType::R4G4B4A4)
+              val = ((val & 0x0fff) << 4) | ((val & 0xf000) >> 12);
+            else
+              val = ((val & 0x7fff) << 1) | ((val & 0x8000) >> 12);
             memcpy(dstPixel, &val, sizeof(val));
-          }
 
-          dstPixel += origFmt.ElementSize();
-          srcPixel += readCompSize * readCompCount;
+            dstPixel += dstStride;
+          }
         }
       }
 
@@ -1932,6 +1932,29 @@ void ThreadState::MarkResourceAccess(ShaderDebugState *state, DXBCBytecode::Oper
     accessed.push_back(bp);
 }
 
+bool ThreadState::CalculateMathIntrinsic(DebugAPIWrapper *apiWrapper, OpcodeType opcode,
+                                         const ShaderVariable &input, ShaderVariable &output1,
+                                         ShaderVariable &output2)
+{
+  GlobalState::MathIntrinsicCacheKey key;
+  key.opcode = opcode;
+  memcpy(key.input, input.value.uv, sizeof(key.input));
+
+  auto it = global.mathIntrinsicCache.find(key);
+  if(it != global.mathIntrinsicCache.end())
+  {
+    output1 = it->second.first;
+    output2 = it->second.second;
+    return true;
+  }
+
+  if(!apiWrapper->CalculateMathIntrinsic(opcode, input, output1, output2))
+    return false;
+
+  global.mathIntrinsicCache[key] = {output1, output2};
+  return true;
+}
+
 void ThreadState::StepNext(ShaderDebugState *state, DebugAPIWrapper *apiWrapper,
                            const rdcarray<ThreadState> &prevWorkgroup)
 {
@@ -2553,7 +2576,7 @@ void ThreadState::StepNext(ShaderDebugState *state, DebugAPIWrapper *apiWrapper,
     {
       ShaderVariable calcResultA("calcA", 0.0f, 0.0f, 0.0f, 0.0f);
       ShaderVariable calcResultB("calcB", 0.0f, 0.0f, 0.0f, 0.0f);
-      if(apiWrapper->CalculateMathIntrinsic(op.operation, srcOpers[0], calcResultA, calcResultB))
+      if(CalculateMathIntrinsic(apiWrapper, op.operation, srcOpers[0], calcResultA, calcResultB))
       {
         SetDst(state, op.operands[0], op, calcResultA);
       }
@@ -2567,7 +2590,7 @@ void ThreadState::StepNext(ShaderDebugState *state, DebugAPIWrapper *apiWrapper,
     {
       ShaderVariable calcResultA("calcA", 0.0f, 0.0f, 0.0f, 0.0f);
       ShaderVariable calcResultB("calcB", 0.0f, 0.0f, 0.0f, 0.0f);
-      if(apiWrapper->CalculateMathIntrinsic(OPCODE_SINCOS, srcOpers[1], calcResultA, calcResultB))
+      if(CalculateMathIntrinsic(apiWrapper, OPCODE_SINCOS, srcOpers[1], calcResultA, calcResultB))
       {
         if(op.operands[0].type != TYPE_NULL)
           SetDst(state, op.operands[0], op, calcResultA);
@@ -5493,6 +5516,28 @@ ShaderDebugTrace *InterpretDebugger::BeginDebug(const DXBC::DXBCContainer *dxbcC
   return ret;
 }
 
+// returns true if the operation reads other lanes in the quad, and so needs a consistent snapshot of
+// the quad's registers from before any lane stepped.
+static bool ReadsQuadState(const Operation &op)
+{
+  switch(op.operation)
+  {
+    case OPCODE_DERIV_RTX:
+    case OPCODE_DERIV_RTX_COARSE:
+    case OPCODE_DERIV_RTX_FINE:
+    case OPCODE_DERIV_RTY:
+    case OPCODE_DERIV_RTY_COARSE:
+    case OPCODE_DERIV_RTY_FINE:
+    case OPCODE_SAMPLE:
+    case OPCODE_SAMPLE_B:
+    case OPCODE_SAMPLE_C:
+    case OPCODE_LOD: return true;
+    default: break;
+  }
+
+  return false;
+}
+
 void InterpretDebugger::CalcActiveMask(rdcarray<bool> &activeMask)
 {
   // one bool per workgroup thread
@@ -5620,14 +5665,27 @@ rdcarray<ShaderDebugState> InterpretDebugger::ContinueDebug(DXBCDebug::DebugAPIW
     if(active.Finished())
       break;
 
+    // calculate the current mask of which threads are active
+    CalcActiveMask(activeMask);
+
     // set up the old workgroup so that cross-workgroup/cross-quad operations (e.g. DDX/DDY) get
     // consistent results even when we step the quad out of order. Otherwise if an operation reads
     // and writes from the same register we'd trash data needed for other workgroup elements.
-    for(size_t i = 0; i < oldworkgroup.size(); i++)
-      oldworkgroup[i].variables = workgroup[i].variables;
+    // Only the derivative operations read it, so we only need to copy the registers when one of
+    // those is about to execute.
+    bool readsQuad = false;
+    for(int i = 0; i < workgroup.count(); i++)
+    {
+      if(activeMask[i] && !workgroup[i].Finished())
+        readsQuad |=
+            ReadsQuadState(dxbc->GetDXBCByteCode()->GetInstruction((size_t)workgroup[i].nextInstruction));
+    }
 
-    // calculate the current mask of which threads are active
-    CalcActiveMask(activeMask);
+    if(readsQuad)
+    {
+      for(size_t i = 0; i < oldworkgroup.size(); i++)
+        oldworkgroup[i].variables = workgroup[i].variables;
+    }
 
     // step all active members of the workgroup
     for(int i = 0; i < workgroup.count(); i++)
@@ -175,6 +175,24 @@ public:
   uint64_t sampleEvalRegisterMask = 0;
   std::map<SampleEvalCacheKey, ShaderVariable> sampleEvalCache;
 
+  struct MathIntrinsicCacheKey
+  {
+    DXBCBytecode::OpcodeType opcode;
+    uint32_t input[4];
+
+    bool operator<(const MathIntrinsicCacheKey &o) const
+    {
+      if(opcode != o.opcode)
+        return opcode < o.opcode;
+
+      return memcmp(input, o.input, sizeof(input)) < 0;
+    }
+  };
+
+  // results of rcp/rsq/exp/log/sincos from the API wrapper, since loops will often evaluate the
+  // same inputs many times and each one needs a GPU dispatch.
+  std::map<MathIntrinsicCacheKey, rdcpair<ShaderVariable, ShaderVariable>> mathIntrinsicCache;
+
   // copied from the parent trace
   rdcarray<ShaderVariable> constantBlocks;
 };
@@ -310,6 +328,10 @@ private:
   void MarkResourceAccess(ShaderDebugState *state, DXBCBytecode::OperandType type,
                           const BindingSlot &slot);
 
+  bool CalculateMathIntrinsic(DebugAPIWrapper *apiWrapper, DXBCBytecode::OpcodeType opcode,
+                              const ShaderVariable &input, ShaderVariable &output1,
+                              ShaderVariable &output2);
+
   // retrieves the value of the operand, by looking up
   // in the register file and performing any swizzling and
   // negation/abs functions
@@ -24,7 +24,9 @@
 
 #include "dxbc_reflect.h"
 #include "common/formatting.h"
+#include "common/shader_cache.h"
 #include "core/core.h"
+#include "serialise/serialiser.h"
 #include "dxbc_bytecode.h"
 #include "dxbc_container.h"
 
@@ -369,3 +371,65 @@ void MakeShaderReflection(DXBC::DXBCContainer *dxbc, ShaderReflection *refl,
     refl->interfaces[dxbc->GetReflection()->Interfaces.variables[i].offset] =
         dxbc->GetReflection()->Interfaces.variables[i].name;
 }
+
+bool GetShaderReflectionHash(const bytebuf &byteCode, const rdcstr &debugInfoPath, GraphicsAPI api,
+                             uint32_t shaderExtReg, uint32_t shaderExtSpace, ShaderHash &hash)
+{
+  if(byteCode.empty() || !debugInfoPath.empty())
+    return false;
+
+  if(!DXBC::DXBCContainer::CheckForDebugInfo(byteCode.data(), byteCode.size()) &&
+     !DXBC::DXBCContainer::GetDebugBinaryPath(byteCode.data(), byteCode.size()).empty())
+    return false;
+
+  hash.Hash(byteCode.data(), byteCode.size());
+  hash.Hash(api);
+  hash.Hash(shaderExtReg);
+  hash.Hash(shaderExtSpace);
+  return true;
+}
+
+bool GetCachedShaderReflection(ShaderReflectionCache *cache, const ShaderHash &hash,
+                               ShaderReflection *refl, ShaderBindpointMapping *mapping)
+{
+  bytebuf cached;
+  if(!cache || !cache->Find(hash, cached))
+    return false;
+
+  ReadSerialiser ser(new StreamReader(cached), Ownership::Stream);
+
+  ser.ReadChunk<uint32_t>();
+  ser.Serialise("refl"_lit, *refl);
+  ser.Serialise("mapping"_lit, *mapping);
+  ser.EndChunk();
+
+  if(ser.IsErrored())
+  {
+    *refl = ShaderReflection();
+    *mapping = ShaderBindpointMapping();
+    return false;
+  }
+
+  return true;
+}
+
+void CacheShaderReflection(ShaderReflectionCache *cache, const ShaderHash &hash,
+                           const ShaderReflection &refl, const ShaderBindpointMapping &mapping)
+{
+  if(!cache)
+    return;
+
+  // the bytecode is already part of the hash, don't store it again
+  ShaderReflection stored = refl;
+  stored.rawBytes.clear();
+
+  WriteSerialiser ser(new StreamWriter(StreamWriter::DefaultScratchSize), Ownership::Stream);
+
+  {
+    SCOPED_SERIALISE_CHUNK(1);
+    ser.Serialise("refl"_lit, stored);
+    ser.Serialise("mapping"_lit, (ShaderBindpointMapping &)mapping);
+  }
+
+  cache->Insert(hash, bytebuf(ser.GetWriter()->GetData(), (size_t)ser.GetWriter()->GetOffset()));
+}
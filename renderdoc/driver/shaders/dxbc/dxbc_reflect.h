@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include "api/replay/rdcarray.h"
+#include "api/replay/rdcstr.h"
+
 namespace DXBC
 {
 class DXBCContainer;
@@ -31,8 +34,23 @@ class DXBCContainer;
 
 struct ShaderReflection;
 struct ShaderBindpointMapping;
+struct ShaderHash;
+class ShaderReflectionCache;
+enum class GraphicsAPI : uint32_t;
 
 #define D3Dx_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT 32
 
 void MakeShaderReflection(DXBC::DXBCContainer *dxbc, ShaderReflection *refl,
                           ShaderBindpointMapping *mapping);
+
+// reflection can be cached by the hash of the bytecode, so that the container doesn't need to be
+// created at all. Returns false if the shader can't be cached, e.g. because it has separate debug
+// info that will be looked up on disk when the container is created.
+bool GetShaderReflectionHash(const bytebuf &byteCode, const rdcstr &debugInfoPath, GraphicsAPI api,
+                             uint32_t shaderExtReg, uint32_t shaderExtSpace, ShaderHash &hash);
+
+// the raw bytes aren't cached, the caller should fill them in on success.
+bool GetCachedShaderReflection(ShaderReflectionCache *cache, const ShaderHash &hash,
+                               ShaderReflection *refl, ShaderBindpointMapping *mapping);
+void CacheShaderReflection(ShaderReflectionCache *cache, const ShaderHash &hash,
+                           const ShaderReflection &refl, const ShaderBindpointMapping &mapping);
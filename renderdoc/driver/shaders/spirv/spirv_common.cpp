@@ -185,3 +185,150 @@ ShaderBuiltin MakeShaderBuiltin(ShaderStage stage, const rdcspv::BuiltIn el)
 
   return ShaderBuiltin::Undefined;
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Check IndexedIdMap", "[spirv]")
+{
+  rdcspv::IndexedIdMap<rdcstr> map;
+
+  SECTION("Insert and lookup")
+  {
+    CHECK(map.empty());
+    CHECK_FALSE(map.contains(rdcspv::Id::fromWord(5)));
+
+    map[rdcspv::Id::fromWord(5)] = "five";
+    map[rdcspv::Id::fromWord(100)] = "hundred";
+
+    CHECK(map.size() == 2);
+    CHECK(map.contains(rdcspv::Id::fromWord(5)));
+    CHECK(map.contains(rdcspv::Id::fromWord(100)));
+    CHECK_FALSE(map.contains(rdcspv::Id::fromWord(6)));
+    CHECK_FALSE(map.contains(rdcspv::Id::fromWord(1000)));
+
+    CHECK(map[rdcspv::Id::fromWord(5)] == "five");
+    CHECK(map[rdcspv::Id::fromWord(100)] == "hundred");
+
+    auto it = map.find(rdcspv::Id::fromWord(100));
+    REQUIRE((it != map.end()));
+    CHECK(it->first == rdcspv::Id::fromWord(100));
+    CHECK(it->second == "hundred");
+
+    CHECK((map.find(rdcspv::Id::fromWord(6)) == map.end()));
+    CHECK((map.find(rdcspv::Id::fromWord(1000)) == map.end()));
+
+    // looking up a missing ID through the non-const operator inserts a default value
+    CHECK(map[rdcspv::Id::fromWord(7)] == "");
+    CHECK(map.size() == 3);
+  };
+
+  SECTION("Erase")
+  {
+    map[rdcspv::Id::fromWord(1)] = "one";
+    map[rdcspv::Id::fromWord(2)] = "two";
+    map[rdcspv::Id::fromWord(3)] = "three";
+
+    map.erase(rdcspv::Id::fromWord(2));
+
+    CHECK(map.size() == 2);
+    CHECK_FALSE(map.contains(rdcspv::Id::fromWord(2)));
+    CHECK((map.find(rdcspv::Id::fromWord(2)) == map.end()));
+    CHECK(map[rdcspv::Id::fromWord(1)] == "one");
+    CHECK(map[rdcspv::Id::fromWord(3)] == "three");
+
+    // erasing a missing ID does nothing
+    map.erase(rdcspv::Id::fromWord(2));
+    map.erase(rdcspv::Id::fromWord(50));
+    CHECK(map.size() == 2);
+
+    map.erase(rdcspv::Id::fromWord(1));
+    map.erase(rdcspv::Id::fromWord(3));
+    CHECK(map.empty());
+    CHECK((map.begin() == map.end()));
+
+    // an erased ID can be inserted again, and starts from a default value
+    CHECK(map[rdcspv::Id::fromWord(2)] == "");
+    CHECK(map.size() == 1);
+  };
+
+  SECTION("Storage of erased entries is reused")
+  {
+    map[rdcspv::Id::fromWord(10)] = "ten";
+    map[rdcspv::Id::fromWord(20)] = "twenty";
+
+    const rdcstr *erased = &map[rdcspv::Id::fromWord(10)];
+
+    map.erase(rdcspv::Id::fromWord(10));
+
+    rdcstr &reused = map[rdcspv::Id::fromWord(30)];
+    CHECK(&reused == erased);
+    CHECK(reused == "");
+
+    reused = "thirty";
+
+    CHECK(map.size() == 2);
+    CHECK_FALSE(map.contains(rdcspv::Id::fromWord(10)));
+    CHECK(map[rdcspv::Id::fromWord(30)] == "thirty");
+    CHECK(map[rdcspv::Id::fromWord(20)] == "twenty");
+
+    auto it = map.find(rdcspv::Id::fromWord(30));
+    REQUIRE((it != map.end()));
+    CHECK(it->first == rdcspv::Id::fromWord(30));
+  };
+
+  SECTION("References are stable")
+  {
+    rdcstr &first = map[rdcspv::Id::fromWord(500)];
+    first = "first";
+
+    // add enough entries, below and above the first ID, to grow both the slots and the storage
+    for(uint32_t i = 1; i < 2000; i++)
+    {
+      if(i != 500)
+        map[rdcspv::Id::fromWord(i)] = StringFormat::Fmt("%u", i);
+    }
+
+    for(uint32_t i = 1; i < 2000; i += 2)
+    {
+      if(i != 500)
+        map.erase(rdcspv::Id::fromWord(i));
+    }
+
+    CHECK(&map[rdcspv::Id::fromWord(500)] == &first);
+    CHECK(first == "first");
+  };
+
+  SECTION("Iteration is in ID order")
+  {
+    const uint32_t ids[] = {50, 3, 20, 7, 1000, 1};
+
+    for(uint32_t id : ids)
+      map[rdcspv::Id::fromWord(id)] = StringFormat::Fmt("%u", id);
+
+    map.erase(rdcspv::Id::fromWord(20));
+
+    // this reuses the storage of 20 but must still be visited in ID order
+    map[rdcspv::Id::fromWord(2)] = "2";
+
+    rdcarray<uint32_t> visited;
+    for(auto it = map.begin(); it != map.end(); ++it)
+    {
+      CHECK(it->second == StringFormat::Fmt("%u", it->first.value()));
+      visited.push_back(it->first.value());
+    }
+
+    CHECK(visited == rdcarray<uint32_t>({1, 2, 3, 7, 50, 1000}));
+
+    const rdcspv::IndexedIdMap<rdcstr> &constMap = map;
+
+    visited.clear();
+    for(const rdcpair<rdcspv::Id, rdcstr> &entry : constMap)
+      visited.push_back(entry.first.value());
+
+    CHECK(visited == rdcarray<uint32_t>({1, 2, 3, 7, 50, 1000}));
+  };
+}
+
+#endif
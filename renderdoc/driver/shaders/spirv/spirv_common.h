@@ -25,8 +25,10 @@
 #pragma once
 
 #include <stdint.h>
+#include <deque>
 #include <map>
 #include "api/replay/rdcarray.h"
+#include "api/replay/rdcpair.h"
 #include "api/replay/stringise.h"
 #include "common/common.h"
 #include "spirv_gen.h"
@@ -218,6 +220,138 @@ public:
   const T &operator[](Id id) const { return (*this)[id.value()]; }
 };
 
+// a map for ID-keyed tables which only contain a subset of IDs, but which are looked up constantly
+// while parsing, reflecting and editing. Lookups go through an ID-indexed array of slots so they're
+// constant time, while the values themselves are stored compactly so memory scales with the number
+// of entries rather than the ID bound. Like std::map, references to values stay valid when other
+// entries are added or erased, and iteration is in ascending ID order.
+template <typename T>
+class IndexedIdMap
+{
+public:
+  typedef rdcpair<Id, T> value_type;
+
+  template <typename MapType, typename ValueType>
+  class iterator_base
+  {
+  public:
+    iterator_base(MapType *m, uint32_t i) : map(m), idx(i) { skipEmpty(); }
+    ValueType &operator*() const { return map->m_Entries[map->m_Slots[idx] - 1]; }
+    ValueType *operator->() const { return &map->m_Entries[map->m_Slots[idx] - 1]; }
+    iterator_base &operator++()
+    {
+      idx++;
+      skipEmpty();
+      return *this;
+    }
+    iterator_base operator++(int)
+    {
+      iterator_base ret = *this;
+      ++(*this);
+      return ret;
+    }
+    bool operator==(const iterator_base &o) const { return idx == o.idx; }
+    bool operator!=(const iterator_base &o) const { return idx != o.idx; }
+  private:
+    void skipEmpty()
+    {
+      while(idx < map->m_Slots.size() && map->m_Slots[idx] == 0)
+        idx++;
+    }
+
+    MapType *map;
+    uint32_t idx;
+  };
+
+  typedef iterator_base<IndexedIdMap, value_type> iterator;
+  typedef iterator_base<const IndexedIdMap, const value_type> const_iterator;
+
+  // reserve slots for IDs up to the given bound, to avoid resizing when the bound is known ahead
+  void reserve(uint32_t maxId)
+  {
+    if(maxId > m_Slots.size())
+      m_Slots.resize(maxId);
+  }
+
+  size_t size() const { return m_Entries.size() - m_FreeEntries.size(); }
+  bool empty() const { return size() == 0; }
+  void clear()
+  {
+    m_Slots.clear();
+    m_Entries.clear();
+    m_FreeEntries.clear();
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, (uint32_t)m_Slots.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, (uint32_t)m_Slots.size()); }
+  iterator find(Id id) { return contains(id) ? iterator(this, id.value()) : end(); }
+  const_iterator find(Id id) const
+  {
+    return contains(id) ? const_iterator(this, id.value()) : end();
+  }
+
+  bool contains(Id id) const
+  {
+    return id.value() < m_Slots.size() && m_Slots[id.value()] != 0;
+  }
+
+  T &operator[](Id id)
+  {
+    m_Slots.resize_for_index(id.value());
+
+    uint32_t &slot = m_Slots[id.value()];
+    if(slot == 0)
+    {
+      if(m_FreeEntries.empty())
+      {
+        m_Entries.push_back(value_type(id, T()));
+        slot = (uint32_t)m_Entries.size();
+      }
+      else
+      {
+        slot = m_FreeEntries.back() + 1;
+        m_FreeEntries.pop_back();
+        m_Entries[slot - 1].first = id;
+      }
+    }
+
+    return m_Entries[slot - 1].second;
+  }
+
+  // this is helpful when we have const maps that we expect to contain ids for valid SPIR-V
+  const T &operator[](Id id) const
+  {
+    if(contains(id))
+      return m_Entries[m_Slots[id.value()] - 1].second;
+
+    RDCERR("Lookup of invalid Id %u expected in IndexedIdMap", id.value());
+    return dummy;
+  }
+
+  void erase(Id id)
+  {
+    if(!contains(id))
+      return;
+
+    // reset the value to release anything it holds, and recycle its storage for the next insert.
+    // We don't compact the storage as that would move other values.
+    uint32_t &slot = m_Slots[id.value()];
+    m_Entries[slot - 1].second = T();
+    m_FreeEntries.push_back(slot - 1);
+    slot = 0;
+  }
+
+private:
+  // 1-based index into m_Entries for each ID, or 0 if the ID has no entry
+  rdcarray<uint32_t> m_Slots;
+  // std::deque never moves existing elements when appending, so references stay stable
+  std::deque<value_type> m_Entries;
+  rdcarray<uint32_t> m_FreeEntries;
+  T dummy;
+};
+
 struct IdOrWord
 {
   constexpr inline IdOrWord() : value(0) {}
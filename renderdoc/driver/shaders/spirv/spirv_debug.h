@@ -246,6 +246,9 @@ public:
   Debugger();
   ~Debugger();
   virtual void Parse(const rdcarray<uint32_t> &spirvWords);
+  // returns a new debugger with a copy of the parsed program, so the same shader can be debugged
+  // several times without parsing it again. Only valid before BeginDebug.
+  Debugger *CloneParsed() const;
   ShaderDebugTrace *BeginDebug(DebugAPIWrapper *apiWrapper, const ShaderStage stage,
                                const rdcstr &entryPoint, const rdcarray<SpecConstant> &specInfo,
                                const std::map<size_t, uint32_t> &instructionLines,
@@ -278,6 +281,8 @@ public:
   ShaderVariable MakeCompositePointer(const ShaderVariable &base, Id id, rdcarray<uint32_t> &indices);
 
   DebugAPIWrapper *GetAPIWrapper() { return apiWrapper; }
+  bool CalculateMathOp(ThreadState &lane, GLSLstd450 op, const rdcarray<ShaderVariable> &params,
+                       ShaderVariable &output);
   uint32_t GetNumInstructions() { return (uint32_t)instructionOffsets.size(); }
   GlobalState GetGlobal() { return global; }
   const rdcarray<Id> &GetLiveGlobals() { return liveGlobals; }
@@ -285,6 +290,8 @@ public:
   ThreadState &GetActiveLane() { return workgroup[activeLaneIndex]; }
   const ThreadState &GetActiveLane() const { return workgroup[activeLaneIndex]; }
 private:
+  Debugger(const Debugger &o) = default;
+
   virtual void PreParse(uint32_t maxId);
   virtual void PostParse();
   virtual void RegisterOp(Iter it);
@@ -332,6 +339,10 @@ private:
 
   SparseIdMap<size_t> idDeathOffset;
 
+  // math ops are calculated on the GPU with a full round-trip each, but they're pure functions so
+  // we cache the results keyed by the op and the raw bytes of its parameters.
+  std::map<bytebuf, rdcpair<uint8_t, ShaderValue>> mathOpResults;
+
   SparseIdMap<size_t> m_Files;
   LineColumnInfo m_CurLineCol;
   std::map<size_t, LineColumnInfo> m_LineColInfo;
@@ -1234,7 +1234,7 @@ ShaderVariable GPUOp(ThreadState &state, uint32_t instruction, const rdcarray<Id
 
   ShaderVariable ret = paramVars[0];
 
-  if(!state.debugger.GetAPIWrapper()->CalculateMathOp(state, (GLSLstd450)instruction, paramVars, ret))
+  if(!state.debugger.CalculateMathOp(state, (GLSLstd450)instruction, paramVars, ret))
     memset(ret.value.u64v, 0, sizeof(ret.value.u64v));
 
   return ret;
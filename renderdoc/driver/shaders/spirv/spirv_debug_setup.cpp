@@ -130,6 +130,12 @@ void Debugger::Parse(const rdcarray<uint32_t> &spirvWords)
   Processor::Parse(spirvWords);
 }
 
+Debugger *Debugger::CloneParsed() const
+{
+  RDCASSERT(apiWrapper == NULL && workgroup.empty());
+  return new Debugger(*this);
+}
+
 Iter Debugger::GetIterForInstruction(uint32_t inst)
 {
   return Iter(m_SPIRV, instructionOffsets[inst]);
@@ -1795,6 +1801,33 @@ void Debugger::WriteThroughPointer(const ShaderVariable &ptr, const ShaderVariab
   }
 }
 
+bool Debugger::CalculateMathOp(ThreadState &lane, GLSLstd450 op,
+                               const rdcarray<ShaderVariable> &params, ShaderVariable &output)
+{
+  bytebuf key;
+  key.append((const byte *)&op, sizeof(op));
+  for(const ShaderVariable &p : params)
+  {
+    key.append((const byte *)&p.type, sizeof(p.type));
+    key.push_back(p.columns);
+    key.append((const byte *)&p.value, VarTypeByteSize(p.type) * p.columns);
+  }
+
+  auto it = mathOpResults.find(key);
+  if(it != mathOpResults.end())
+  {
+    output.columns = it->second.first;
+    output.value = it->second.second;
+    return true;
+  }
+
+  if(!apiWrapper->CalculateMathOp(lane, op, params, output))
+    return false;
+
+  mathOpResults[key] = {output.columns, output.value};
+  return true;
+}
+
 rdcstr Debugger::GetRawName(Id id) const
 {
   return StringFormat::Fmt("_%u", id.value());
@@ -486,6 +486,14 @@ void Processor::PreParse(uint32_t maxId)
   decorations.resize(maxId);
   idOffsets.resize(maxId);
   idTypes.resize(maxId);
+
+  constants.reserve(maxId);
+  specOps.reserve(maxId);
+  dataTypes.reserve(maxId);
+  imageTypes.reserve(maxId);
+  samplerTypes.reserve(maxId);
+  sampledImageTypes.reserve(maxId);
+  functionTypes.reserve(maxId);
 }
 
 void Processor::RegisterOp(Iter it)
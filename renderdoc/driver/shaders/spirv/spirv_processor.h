@@ -549,17 +549,17 @@ protected:
   std::set<rdcstr> extensions;
   std::set<Capability> capabilities;
 
-  SparseIdMap<Constant> constants;
-  SparseIdMap<SpecOp> specOps;
+  IndexedIdMap<Constant> constants;
+  IndexedIdMap<SpecOp> specOps;
   std::set<Id> specConstants;
 
   DenseIdMap<Decorations> decorations;
 
-  SparseIdMap<DataType> dataTypes;
-  SparseIdMap<Image> imageTypes;
-  SparseIdMap<Sampler> samplerTypes;
-  SparseIdMap<SampledImage> sampledImageTypes;
-  SparseIdMap<FunctionType> functionTypes;
+  IndexedIdMap<DataType> dataTypes;
+  IndexedIdMap<Image> imageTypes;
+  IndexedIdMap<Sampler> samplerTypes;
+  IndexedIdMap<SampledImage> sampledImageTypes;
+  IndexedIdMap<FunctionType> functionTypes;
 
   std::map<Id, rdcstr> extSets;
 
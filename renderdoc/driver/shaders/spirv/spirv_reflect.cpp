@@ -691,7 +691,9 @@ void Reflector::MakeReflection(const GraphicsAPI sourceAPI, const ShaderStage st
       reflection.debugInfo.files.push_back({sources[i].name, sources[i].contents});
   }
 
-  std::set<Id> usedIds;
+  // IDs are bounded so a flat array is much cheaper than a set when marking every referenced ID
+  DenseIdMap<bool> usedIds;
+  usedIds.resize(idOffsets.size());
   std::map<Id, std::set<uint32_t>> usedStructChildren;
 
   // build the static call tree from the entry point, and build a list of all IDs referenced
@@ -712,7 +714,10 @@ void Reflector::MakeReflection(const GraphicsAPI sourceAPI, const ShaderStage st
 
       while(it.opcode() != Op::FunctionEnd)
       {
-        OpDecoder::ForEachID(it, [&usedIds](Id id, bool result) { usedIds.insert(id); });
+        OpDecoder::ForEachID(it, [&usedIds](Id id, bool result) {
+          if(id.value() < usedIds.size())
+            usedIds[id] = true;
+        });
 
         if(it.opcode() == Op::AccessChain || it.opcode() == Op::InBoundsAccessChain)
         {
@@ -783,7 +788,7 @@ void Reflector::MakeReflection(const GraphicsAPI sourceAPI, const ShaderStage st
           name = StringFormat::Fmt("_sig%u", global.id.value());
       }
 
-      const bool used = usedIds.find(global.id) != usedIds.end();
+      const bool used = usedIds[global.id];
 
       // we want to skip any members of the builtin interface block that are completely unused and
       // just came along for the ride (usually with gl_Position, but maybe declared and still
@@ -907,7 +912,7 @@ void Reflector::MakeReflection(const GraphicsAPI sourceAPI, const ShaderStage st
         bindmap.bind = -int32_t(decorations[global.id].location);
 
       bindmap.arraySize = isArray ? arraySize : 1;
-      bindmap.used = usedIds.find(global.id) != usedIds.end();
+      bindmap.used = usedIds[global.id];
 
       if(atomicCounter)
       {
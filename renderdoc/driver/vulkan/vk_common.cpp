@@ -344,6 +344,11 @@ bool VkInitParams::IsSupportedVersion(uint64_t ver)
   if(ver == CurrentVersion)
     return true;
 
+  // 0x12 -> 0x13 - image and memory initial contents can reference identical contents serialised
+  // earlier in the capture
+  if(ver == 0x12)
+    return true;
+
   // 0x11 -> 0x12 - added inline uniform block support
   if(ver == 0x11)
     return true;
@@ -1640,10 +1640,11 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
       RDCASSERTEQUAL(vkr, VK_SUCCESS);
     }
 
+    m_InitStateReadback.batching = true;
     GetResourceManager()->PrepareInitialContents();
+    m_InitStateReadback.batching = false;
     SubmitAndFlushImageStateBarriers(m_setupImageBarriers);
-    SubmitCmds();
-    FlushQ();
+    FlushInitialStateReadback();
     SubmitAndFlushImageStateBarriers(m_cleanupImageBarriers);
 
     RDCDEBUG("Attempting capture");
@@ -2011,39 +2012,16 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     GetResourceManager()->InsertReferencedChunks(ser);
 
-    GetResourceManager()->InsertInitialContentsChunks(ser);
-
-    RDCDEBUG("Creating Capture Scope");
-
-    GetResourceManager()->Serialise_InitialContentsNeeded(ser);
-    GetResourceManager()->InsertDeviceMemoryRefs(ser);
-
-    {
-      SCOPED_SERIALISE_CHUNK(SystemChunk::CaptureScope, 16);
-
-      Serialise_CaptureScope(ser);
-    }
-
-    {
-      WriteSerialiser &captureBeginSer = GetThreadSerialiser();
-      ScopedChunk scope(captureBeginSer, SystemChunk::CaptureBegin);
-
-      Serialise_BeginCaptureFrame(captureBeginSer);
-
-      m_HeaderChunk = scope.Get();
-    }
-    m_HeaderChunk->Write(ser);
-
     // don't need to lock access to m_CmdBufferRecords as we are no longer
     // in capframe (the transition is thread-protected) so nothing will be
     // pushed to the vector
 
+    std::map<int64_t, Chunk *> recordlist;
+
     {
       RDCDEBUG("Flushing %u command buffer records to file serialiser",
                (uint32_t)m_CmdBufferRecords.size());
 
-      std::map<int64_t, Chunk *> recordlist;
-
       // ensure all command buffer records within the frame evne if recorded before, but
       // otherwise order must be preserved (vs. queue submits and desc set updates)
       for(size_t i = 0; i < m_CmdBufferRecords.size(); i++)
@@ -2060,7 +2038,34 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
       }
 
       m_FrameCaptureRecord->Insert(recordlist);
+    }
 
+    BeginInitialContentsSources();
+
+    GetResourceManager()->InsertInitialContentsChunks(ser, recordlist);
+
+    RDCDEBUG("Creating Capture Scope");
+
+    GetResourceManager()->Serialise_InitialContentsNeeded(ser);
+    GetResourceManager()->InsertDeviceMemoryRefs(ser);
+
+    {
+      SCOPED_SERIALISE_CHUNK(SystemChunk::CaptureScope, 16);
+
+      Serialise_CaptureScope(ser);
+    }
+
+    {
+      WriteSerialiser &captureBeginSer = GetThreadSerialiser();
+      ScopedChunk scope(captureBeginSer, SystemChunk::CaptureBegin);
+
+      Serialise_BeginCaptureFrame(captureBeginSer);
+
+      m_HeaderChunk = scope.Get();
+    }
+    m_HeaderChunk->Write(ser);
+
+    {
       RDCDEBUG("Flushing %u chunks to file serialiser from context record",
                (uint32_t)recordlist.size());
 
@@ -2331,6 +2336,11 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
   if(m_ReplayOptions.apiValidation)
     sink = new ScopedDebugMessageSink(this);
 
+  // shader modules are parsed and reflected in the background while we read the rest of the
+  // chunks, this is finished before the frame is replayed
+  if(!IsStructuredExporting(m_State))
+    m_CreationInfo.BeginBackgroundReflection();
+
   for(;;)
   {
     PerformanceTimer timer;
@@ -2344,6 +2354,7 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
     if(reader->IsErrored())
     {
       SAFE_DELETE(sink);
+      m_CreationInfo.FinishBackgroundReflection();
       return ReplayStatus::APIDataCorrupted;
     }
 
@@ -2354,6 +2365,7 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
     if(reader->IsErrored())
     {
       SAFE_DELETE(sink);
+      m_CreationInfo.FinishBackgroundReflection();
       return ReplayStatus::APIDataCorrupted;
     }
 
@@ -2362,6 +2374,7 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
     if(!success)
     {
       SAFE_DELETE(sink);
+      m_CreationInfo.FinishBackgroundReflection();
       return m_FailedReplayStatus;
     }
 
@@ -2401,6 +2414,10 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
       m_FrameReader = new StreamReader(reader, frameDataSize);
 
+      FlushInitialContentsReferences();
+
+      m_CreationInfo.FinishBackgroundReflection();
+
       for(auto it = m_CreationInfo.m_Memory.begin(); it != m_CreationInfo.m_Memory.end(); ++it)
         it->second.SimplifyBindings();
 
@@ -2422,6 +2439,9 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
   }
 
   SAFE_DELETE(sink);
+  m_CreationInfo.FinishBackgroundReflection();
+
+  FlushInitialContentsReferences();
 
 #if ENABLED(RDOC_DEVEL)
   for(auto it = chunkInfos.begin(); it != chunkInfos.end(); ++it)
@@ -3284,6 +3304,15 @@ bool WrappedVulkan::ProcessChunk(ReadSerialiser &ser, VulkanChunk chunk)
     {
       return Serialise_InitialState(ser, ResourceId(), NULL, NULL);
     }
+    else if(system == SystemChunk::DegradedInitialContents)
+    {
+      rdcstr warning;
+      if(!GetResourceManager()->ReadDegradedInitialContents(ser, warning))
+        return false;
+
+      AddDebugMessage(MessageCategory::Resource_Manipulation, MessageSeverity::Medium,
+                      MessageSource::RuntimeWarning, warning);
+    }
     else if(system == SystemChunk::CaptureScope)
     {
       return Serialise_CaptureScope(ser);
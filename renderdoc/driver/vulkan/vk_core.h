@@ -53,7 +53,7 @@ struct VkInitParams
   uint64_t GetSerialiseSize();
 
   // check if a frame capture section version is supported
-  static const uint64_t CurrentVersion = 0x12;
+  static const uint64_t CurrentVersion = 0x13;
   static bool IsSupportedVersion(uint64_t ver);
 };
 
@@ -448,6 +448,42 @@ private:
   ImageBarrierSequence m_setupImageBarriers;
   ImageBarrierSequence m_cleanupImageBarriers;
 
+  // image and memory readbacks submitted while preparing initial contents, which haven't been
+  // waited on yet. The temporary objects used for the copies are released once they complete.
+  struct
+  {
+    bool batching = false;
+    uint64_t size = 0;
+    rdcarray<VkBuffer> buffers;
+    rdcarray<VkImage> images;
+  } m_InitStateReadback;
+
+  // a resource whose image/memory initial contents were serialised with their data, which later
+  // resources with identical contents can reference.
+  struct InitialContentsSource
+  {
+    ResourceId id;
+    // the readback of the contents. Only valid in the capture that serialised them
+    MemoryAllocation mem;
+    // where the contents are within the serialised chunk, for when a later rolling frame writes the
+    // same chunk again without reading the resource back
+    uint64_t chunkOffset = 0;
+  };
+
+  // {hash, size} of image/memory initial contents, mapped to the resource last serialised with
+  // those contents. This is kept for the whole session so that a rolling frame can reference the
+  // unchanged contents of a resource that were serialised in an earlier frame.
+  std::map<rdcpair<uint64_t, uint64_t>, InitialContentsSource> m_InitialContentsHashes;
+  // the key in m_InitialContentsHashes that each source was last serialised with
+  std::map<ResourceId, rdcpair<uint64_t, uint64_t>> m_InitialContentsKeys;
+
+  // resources serialised in the current capture with their own data, or as a reference to another
+  std::set<ResourceId> m_InitialContentsWritten, m_InitialContentsReferences;
+
+  // on replay, the copies filling initial contents that reference earlier identical contents.
+  // Recorded as the chunks are read and submitted together before the frame is replayed.
+  VkCommandBuffer m_InitialContentsRefCmd = VK_NULL_HANDLE;
+
   // a small amount of helper code during capture for handling resources on different queues in init
   // states
   struct ExternalQueue
@@ -887,6 +923,13 @@ private:
 
   ResourceDescription &GetResourceDesc(ResourceId id);
 
+  void SubmitInitialStateReadback(bool flush);
+  void FlushInitialStateReadback();
+  void BeginInitialContentsSources();
+  bool InitialContentsMatch(const MemoryAllocation &mem, byte *&contents,
+                            const InitialContentsSource &source);
+  void FlushInitialContentsReferences();
+
   bool Prepare_SparseInitialState(WrappedVkBuffer *buf);
   bool Prepare_SparseInitialState(WrappedVkImage *im);
   template <typename SerialiserType>
@@ -1008,6 +1051,11 @@ public:
   bool Prepare_InitialState(WrappedVkRes *res);
   uint64_t GetSize_InitialState(ResourceId id, const VkInitialContents &initial);
   uint64_t GetSize_SparseInitialState(ResourceId id, const VkInitialContents &initial);
+  uint64_t GetSize_PostponedInitialState(ResourceId id);
+  bool IsInitialContentsReference(ResourceId id)
+  {
+    return m_InitialContentsReferences.find(id) != m_InitialContentsReferences.end();
+  }
   template <typename SerialiserType>
   bool Serialise_InitialState(SerialiserType &ser, ResourceId id, VkResourceRecord *record,
                               const VkInitialContents *initial);
@@ -391,7 +391,7 @@ void VulkanCreationInfo::Pipeline::Init(VulkanResourceManager *resourceMan,
 
     ShaderModuleReflection &reflData = info.m_ShaderModule[shadid].m_Reflections[key];
 
-    reflData.Init(resourceMan, shadid, info.m_ShaderModule[shadid].spirv, shad.entryPoint,
+    reflData.Init(resourceMan, info, shadid, info.m_ShaderModule[shadid], shad.entryPoint,
                   pCreateInfo->pStages[i].stage, shad.specialization);
 
     shad.refl = &reflData.refl;
@@ -720,7 +720,7 @@ void VulkanCreationInfo::Pipeline::Init(VulkanResourceManager *resourceMan, Vulk
 
     ShaderModuleReflection &reflData = info.m_ShaderModule[shadid].m_Reflections[key];
 
-    reflData.Init(resourceMan, shadid, info.m_ShaderModule[shadid].spirv, shad.entryPoint,
+    reflData.Init(resourceMan, info, shadid, info.m_ShaderModule[shadid], shad.entryPoint,
                   pCreateInfo->stage.stage, shad.specialization);
 
     shad.refl = &reflData.refl;
@@ -1270,14 +1270,70 @@ void VulkanCreationInfo::ShaderModule::Init(VulkanResourceManager *resourceMan,
   else
   {
     RDCASSERT(pCreateInfo->codeSize % sizeof(uint32_t) == 0);
-    spirv.Parse(rdcarray<uint32_t>((uint32_t *)(pCreateInfo->pCode),
-                                   pCreateInfo->codeSize / sizeof(uint32_t)));
+    rdcarray<uint32_t> words((uint32_t *)(pCreateInfo->pCode),
+                             pCreateInfo->codeSize / sizeof(uint32_t));
+
+    if(info.m_ReflectionCache)
+      spirvHash.Hash(pCreateInfo->pCode, pCreateInfo->codeSize);
+
+    if(info.m_ReflectionJobs)
+      parseJob = info.m_ReflectionJobs->Submit([this, words]() { spirv.Parse(words); });
+    else
+      spirv.Parse(words);
+  }
+}
+
+void VulkanCreationInfo::BeginBackgroundReflection()
+{
+  if(m_ReflectionJobs == NULL)
+    m_ReflectionJobs = new Threading::JobQueue();
+}
+
+void VulkanCreationInfo::FinishBackgroundReflection()
+{
+  if(m_ReflectionJobs == NULL)
+    return;
+
+  m_ReflectionJobs->WaitAll();
+  SAFE_DELETE(m_ReflectionJobs);
+
+  // the handles belong to the queue
+  for(auto it = m_ShaderModule.begin(); it != m_ShaderModule.end(); ++it)
+    it->second.parseJob = 0;
+}
+
+template <typename SerialiserType>
+static void SerialiseCachedReflection(SerialiserType &ser, ShaderReflection &refl,
+                                      ShaderBindpointMapping &mapping, SPIRVPatchData &patchData)
+{
+  SERIALISE_ELEMENT(refl);
+  SERIALISE_ELEMENT(mapping);
+  SERIALISE_ELEMENT(patchData.outTopo);
+
+  for(rdcarray<SPIRVInterfaceAccess> *accesses : {&patchData.inputs, &patchData.outputs})
+  {
+    uint64_t count = accesses->size();
+    SERIALISE_ELEMENT(count);
+    accesses->resize((size_t)count);
+
+    for(SPIRVInterfaceAccess &access : *accesses)
+    {
+      uint32_t ID = access.ID.value();
+      uint32_t structID = access.structID.value();
+      SERIALISE_ELEMENT(ID);
+      SERIALISE_ELEMENT(structID);
+      SERIALISE_ELEMENT(access.structMemberIndex);
+      SERIALISE_ELEMENT(access.accessChain);
+      SERIALISE_ELEMENT(access.isArraySubsequentElement);
+      access.ID = rdcspv::Id::fromWord(ID);
+      access.structID = rdcspv::Id::fromWord(structID);
+    }
   }
 }
 
 void VulkanCreationInfo::ShaderModuleReflection::Init(VulkanResourceManager *resourceMan,
-                                                      ResourceId id, const rdcspv::Reflector &spv,
-                                                      const rdcstr &entry,
+                                                      VulkanCreationInfo &info, ResourceId id,
+                                                      ShaderModule &module, const rdcstr &entry,
                                                       VkShaderStageFlagBits stage,
                                                       const rdcarray<SpecConstant> &specInfo)
 {
@@ -1286,11 +1342,96 @@ void VulkanCreationInfo::ShaderModuleReflection::Init(VulkanResourceManager *res
     entryPoint = entry;
     stageIndex = StageIndex(stage);
 
+    ResourceId origId = resourceMan->GetOriginalID(id);
+
+    if(info.m_ReflectionJobs)
+    {
+      Threading::JobQueue *jobs = info.m_ReflectionJobs;
+      ShaderReflectionCache *cache = info.m_ReflectionCache;
+      ShaderModule *mod = &module;
+
+      jobs->Submit([this, jobs, cache, mod, specInfo, origId]() {
+        jobs->Wait(mod->parseJob);
+        Reflect(cache, mod->spirvHash, mod->spirv, specInfo, origId);
+      });
+    }
+    else
+    {
+      Reflect(info.m_ReflectionCache, module.spirvHash, module.spirv, specInfo, origId);
+    }
+  }
+}
+
+void VulkanCreationInfo::ShaderModuleReflection::Reflect(ShaderReflectionCache *cache,
+                                                         const ShaderHash &spirvHash,
+                                                         const rdcspv::Reflector &spv,
+                                                         const rdcarray<SpecConstant> &specInfo,
+                                                         ResourceId origId)
+{
+  ShaderHash hash = spirvHash;
+  bytebuf cached;
+
+  if(cache)
+  {
+    hash.Hash(entryPoint);
+    hash.Hash(stageIndex);
+    for(const SpecConstant &spec : specInfo)
+    {
+      hash.Hash(spec.specID);
+      hash.Hash(spec.value);
+      hash.Hash(spec.dataSize);
+    }
+  }
+
+  if(cache && cache->Find(hash, cached))
+  {
+    ReadSerialiser ser(new StreamReader(cached), Ownership::Stream);
+
+    ser.ReadChunk<uint32_t>();
+    SerialiseCachedReflection(ser, refl, mapping, patchData);
+    ser.EndChunk();
+
+    if(ser.IsErrored())
+    {
+      RDCWARN("Cached reflection for %s is corrupt, regenerating", entryPoint.c_str());
+      refl = ShaderReflection();
+      mapping = ShaderBindpointMapping();
+      patchData = SPIRVPatchData();
+      cached.clear();
+    }
+    else
+    {
+      // the SPIR-V itself isn't stored in the cache since we already have it
+      rdcarray<uint32_t> words = spv.GetSPIRV();
+      refl.rawBytes.assign((byte *)words.data(), words.size() * sizeof(uint32_t));
+    }
+  }
+
+  if(cached.empty())
+  {
     spv.MakeReflection(GraphicsAPI::Vulkan, ShaderStage(stageIndex), entryPoint, specInfo, refl,
                        mapping, patchData);
 
-    refl.resourceId = resourceMan->GetOriginalID(id);
+    if(cache)
+    {
+      bytebuf rawBytes;
+      rawBytes.swap(refl.rawBytes);
+
+      WriteSerialiser ser(new StreamWriter(StreamWriter::DefaultScratchSize), Ownership::Stream);
+
+      {
+        SCOPED_SERIALISE_CHUNK(1);
+        SerialiseCachedReflection(ser, refl, mapping, patchData);
+      }
+
+      cache->Insert(hash, bytebuf(ser.GetWriter()->GetData(),
+                                  (size_t)ser.GetWriter()->GetOffset()));
+
+      rawBytes.swap(refl.rawBytes);
+    }
   }
+
+  refl.resourceId = origId;
 }
 
 void VulkanCreationInfo::ShaderModuleReflection::PopulateDisassembly(const rdcspv::Reflector &spirv)
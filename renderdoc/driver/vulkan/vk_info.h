@@ -25,6 +25,8 @@
 #pragma once
 
 #include <unordered_map>
+#include "common/job_queue.h"
+#include "common/shader_cache.h"
 #include "driver/shaders/spirv/spirv_reflect.h"
 #include "vk_common.h"
 #include "vk_manager.h"
@@ -208,6 +210,8 @@ struct VulkanCreationInfo
     ResourceId specialisingPipe;
   };
 
+  struct ShaderModule;
+
   struct ShaderModuleReflection
   {
     uint32_t stageIndex;
@@ -218,11 +222,18 @@ struct VulkanCreationInfo
     SPIRVPatchData patchData;
     std::map<size_t, uint32_t> instructionLines;
 
-    void Init(VulkanResourceManager *resourceMan, ResourceId id, const rdcspv::Reflector &spv,
-              const rdcstr &entry, VkShaderStageFlagBits stage,
+    // if background reflection is active the results are only available after
+    // FinishBackgroundReflection()
+    void Init(VulkanResourceManager *resourceMan, VulkanCreationInfo &info, ResourceId id,
+              ShaderModule &module, const rdcstr &entry, VkShaderStageFlagBits stage,
               const rdcarray<SpecConstant> &specInfo);
 
     void PopulateDisassembly(const rdcspv::Reflector &spirv);
+
+  private:
+    void Reflect(ShaderReflectionCache *cache, const ShaderHash &spirvHash,
+                 const rdcspv::Reflector &spv, const rdcarray<SpecConstant> &specInfo,
+                 ResourceId origId);
   };
 
   struct Pipeline
@@ -608,12 +619,28 @@ struct VulkanCreationInfo
 
     rdcspv::Reflector spirv;
 
+    // set while the SPIR-V is being parsed in the background
+    Threading::JobHandle parseJob = 0;
+
+    // only calculated if reflection is being cached
+    ShaderHash spirvHash;
+
     rdcstr unstrippedPath;
 
     std::map<ShaderModuleReflectionKey, ShaderModuleReflection> m_Reflections;
   };
   std::unordered_map<ResourceId, ShaderModule> m_ShaderModule;
 
+  // owned by the shader cache, only available on replay
+  ShaderReflectionCache *m_ReflectionCache = NULL;
+
+  // while a capture is loading, shader modules are parsed and reflected on worker threads so that
+  // chunk processing isn't held up. All of that work is finished before the reflection data is
+  // used, in FinishBackgroundReflection().
+  void BeginBackgroundReflection();
+  void FinishBackgroundReflection();
+  Threading::JobQueue *m_ReflectionJobs = NULL;
+
   struct DescSetPool
   {
     void Init(VulkanResourceManager *resourceMan, VulkanCreationInfo &info,
@@ -649,6 +676,10 @@ struct VulkanCreationInfo
 
   void erase(ResourceId id)
   {
+    // background jobs may still be referencing a shader module
+    if(m_ReflectionJobs && m_ShaderModule.find(id) != m_ShaderModule.end())
+      m_ReflectionJobs->WaitAll();
+
     m_QueryPool.erase(id);
     m_Pipeline.erase(id);
     m_PipelineLayout.erase(id);
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "core/settings.h"
+#include "zstd/xxhash.h"
 #include "vk_core.h"
 #include "vk_debug.h"
 
@@ -34,7 +35,64 @@
 // used across init state use, and only do a single flush. Also we could then get some
 // nice command buffer reuse (although need to be careful we don't create too large a
 // command buffer that stalls the GPU).
-// See INITSTATEBATCH
+// See INITSTATEBATCH. Image and memory readbacks when preparing at the start of a capture are
+// batched, see SubmitInitialStateReadback.
+
+RDOC_CONFIG(uint32_t, Vulkan_InitialStateReadbackBatchMB, 256,
+            "The amount of initial contents readback in megabytes that can be outstanding on the "
+            "GPU at the start of a capture, before waiting for it to complete.");
+
+// the size of the buffer that an image's contents are read back into, with every sample of every
+// subresource packed one after another.
+static VkDeviceSize GetImageReadbackSize(const ImageInfo &imageInfo)
+{
+  // must ensure offset remains valid. Must be multiple of block size, or 4, depending on format
+  VkDeviceSize bufAlignment = 4;
+  if(IsBlockFormat(imageInfo.format))
+    bufAlignment = (VkDeviceSize)GetByteSize(1, 1, 1, imageInfo.format, 0);
+
+  int numLayers = imageInfo.layerCount;
+  if(imageInfo.sampleCount > 1)
+    numLayers *= imageInfo.sampleCount;
+
+  const uint32_t planeCount = GetYUVPlaneCount(imageInfo.format);
+  const VkFormat sizeFormat = GetDepthOnlyFormat(imageInfo.format);
+
+  VkDeviceSize size = 0;
+
+  for(int a = 0; a < numLayers; a++)
+  {
+    for(int m = 0; m < imageInfo.levelCount; m++)
+    {
+      size = AlignUp(size, bufAlignment);
+
+      if(planeCount > 1)
+      {
+        // need to consider each plane aspect separately. We simplify the calculation by just
+        // aligning up the width to a multiple of 4, that ensures each plane will start at a
+        // multiple of 4 because the rowpitch must be a multiple of 4
+        size += GetByteSize(AlignUp4(imageInfo.extent.width), imageInfo.extent.height,
+                            imageInfo.extent.depth, sizeFormat, m);
+      }
+      else
+      {
+        size += GetByteSize(imageInfo.extent.width, imageInfo.extent.height,
+                            imageInfo.extent.depth, sizeFormat, m);
+
+        if(sizeFormat != imageInfo.format)
+        {
+          // if there's stencil and depth, allocate space for stencil
+          size = AlignUp(size, bufAlignment);
+
+          size += GetByteSize(imageInfo.extent.width, imageInfo.extent.height,
+                              imageInfo.extent.depth, VK_FORMAT_S8_UINT, m);
+        }
+      }
+    }
+  }
+
+  return size;
+}
 
 bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
 {
@@ -203,36 +261,7 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
 
     VkFormat sizeFormat = GetDepthOnlyFormat(imageInfo.format);
 
-    for(int a = 0; a < numLayers; a++)
-    {
-      for(int m = 0; m < imageInfo.levelCount; m++)
-      {
-        bufInfo.size = AlignUp(bufInfo.size, bufAlignment);
-
-        if(planeCount > 1)
-        {
-          // need to consider each plane aspect separately. We simplify the calculation by just
-          // aligning up the width to a multiple of 4, that ensures each plane will start at a
-          // multiple of 4 because the rowpitch must be a multiple of 4
-          bufInfo.size += GetByteSize(AlignUp4(imageInfo.extent.width), imageInfo.extent.height,
-                                      imageInfo.extent.depth, sizeFormat, m);
-        }
-        else
-        {
-          bufInfo.size += GetByteSize(imageInfo.extent.width, imageInfo.extent.height,
-                                      imageInfo.extent.depth, sizeFormat, m);
-
-          if(sizeFormat != imageInfo.format)
-          {
-            // if there's stencil and depth, allocate space for stencil
-            bufInfo.size = AlignUp(bufInfo.size, bufAlignment);
-
-            bufInfo.size += GetByteSize(imageInfo.extent.width, imageInfo.extent.height,
-                                        imageInfo.extent.depth, VK_FORMAT_S8_UINT, m);
-          }
-        }
-      }
-    }
+    bufInfo.size = GetImageReadbackSize(imageInfo);
 
     // since this happens during capture, we don't want to start serialising extra buffer creates,
     // so we manually create & then just wrap.
@@ -404,18 +433,17 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
     SubmitAndFlushImageStateBarriers(m_setupImageBarriers);
-    SubmitCmds();
-    FlushQ();
-    SubmitAndFlushImageStateBarriers(m_cleanupImageBarriers);
-
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(dstBuf), NULL);
-    GetResourceManager()->ReleaseWrappedResource(dstBuf);
 
+    // the temporary buffer and array image are destroyed once the batch has been waited on
+    m_InitStateReadback.buffers.push_back(dstBuf);
     if(arrayIm != VK_NULL_HANDLE)
-    {
-      ObjDisp(d)->DestroyImage(Unwrap(d), Unwrap(arrayIm), NULL);
-      GetResourceManager()->ReleaseWrappedResource(arrayIm);
-    }
+      m_InitStateReadback.images.push_back(arrayIm);
+    m_InitStateReadback.size += readbackmem.size;
+
+    // if another queue family needs to re-acquire the image afterwards we have to wait for the copy
+    // to complete before releasing it back
+    SubmitInitialStateReadback(!m_cleanupImageBarriers.empty());
+    SubmitAndFlushImageStateBarriers(m_cleanupImageBarriers);
 
     GetResourceManager()->SetInitialContents(id, VkInitialContents(type, readbackmem));
 
@@ -498,12 +526,10 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
-    SubmitCmds();
-    FlushQ();
+    m_InitStateReadback.buffers.push_back(dstBuf);
+    m_InitStateReadback.size += readbackmem.size;
 
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(dstBuf), NULL);
-    GetResourceManager()->ReleaseWrappedResource(dstBuf);
+    SubmitInitialStateReadback(false);
 
     GetResourceManager()->SetInitialContents(id, VkInitialContents(type, readbackmem));
 
@@ -517,6 +543,164 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
   return false;
 }
 
+void WrappedVulkan::SubmitInitialStateReadback(bool flush)
+{
+  SubmitCmds();
+
+  // while preparing all dirty resources at the start of a capture we only wait once the batch has
+  // grown past the limit - everything outstanding is flushed before the frame begins. Any other
+  // time we're being called the contents are needed immediately, or the application could
+  // overwrite the resource as soon as we return.
+  const uint64_t batchLimit = uint64_t(Vulkan_InitialStateReadbackBatchMB()) * 1024 * 1024;
+
+  if(flush || !m_InitStateReadback.batching || m_InitStateReadback.size >= batchLimit)
+    FlushInitialStateReadback();
+}
+
+void WrappedVulkan::BeginInitialContentsSources()
+{
+  m_InitialContentsWritten.clear();
+  m_InitialContentsReferences.clear();
+
+  // forget any sources that have been destroyed since the last capture
+  for(auto it = m_InitialContentsHashes.begin(); it != m_InitialContentsHashes.end();)
+  {
+    if(GetResourceManager()->HasCurrentResource(it->second.id))
+      ++it;
+    else
+      it = m_InitialContentsHashes.erase(it);
+  }
+
+  for(auto it = m_InitialContentsKeys.begin(); it != m_InitialContentsKeys.end();)
+  {
+    if(GetResourceManager()->HasCurrentResource(it->first))
+      ++it;
+    else
+      it = m_InitialContentsKeys.erase(it);
+  }
+}
+
+bool WrappedVulkan::InitialContentsMatch(const MemoryAllocation &mem, byte *&contents,
+                                         const InitialContentsSource &source)
+{
+  // identical hashes aren't enough to share contents, a collision would silently replace one
+  // resource's contents with another's. Compare the bytes.
+
+  // the source's data has to be earlier in this capture to be referenced. If it wasn't read back
+  // and serialised in this capture, it can still have been written from a chunk that an earlier
+  // rolling frame serialised, in which case we compare against the chunk.
+  if(m_InitialContentsWritten.find(source.id) == m_InitialContentsWritten.end())
+  {
+    Chunk *chunk = GetResourceManager()->GetSerialisedInitialChunk(source.id);
+
+    if(chunk == NULL || source.chunkOffset + mem.size > chunk->GetLength())
+      return false;
+
+    return memcmp(contents, chunk->GetData() + source.chunkOffset, (size_t)mem.size) == 0;
+  }
+
+  const MemoryAllocation &ref = source.mem;
+
+  if(ref.mem == VK_NULL_HANDLE || ref.size != mem.size)
+    return false;
+
+  VkDevice d = GetDev();
+  VkResult vkr = VK_SUCCESS;
+
+  byte *refContents = NULL;
+  bool match = false;
+
+  if(ref.mem == mem.mem)
+  {
+    // both were suballocated from the same memory, which can only be mapped once. Remap it over
+    // both ranges and point contents at its new location
+    ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(mem.mem));
+
+    VkDeviceSize start = RDCMIN(mem.offs, ref.offs);
+    VkDeviceSize end = RDCMAX(mem.offs + mem.size, ref.offs + ref.size);
+
+    byte *base = NULL;
+    vkr = ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mem.mem), start, end - start, 0, (void **)&base);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    if(base == NULL)
+    {
+      contents = NULL;
+      return false;
+    }
+
+    contents = base + (mem.offs - start);
+    refContents = base + (ref.offs - start);
+
+    match = memcmp(contents, refContents, (size_t)mem.size) == 0;
+  }
+  else
+  {
+    vkr = ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(ref.mem), ref.offs, ref.size, 0,
+                                (void **)&refContents);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    if(refContents == NULL)
+      return false;
+
+    VkMappedMemoryRange range = {
+        VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, NULL, Unwrap(ref.mem), ref.offs,
+        ref.size,
+    };
+
+    vkr = ObjDisp(d)->InvalidateMappedMemoryRanges(Unwrap(d), 1, &range);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    match = memcmp(contents, refContents, (size_t)mem.size) == 0;
+
+    ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(ref.mem));
+  }
+
+  return match;
+}
+
+void WrappedVulkan::FlushInitialContentsReferences()
+{
+  VkCommandBuffer cmd = m_InitialContentsRefCmd;
+
+  if(cmd == VK_NULL_HANDLE)
+    return;
+
+  m_InitialContentsRefCmd = VK_NULL_HANDLE;
+
+  VkResult vkr = ObjDisp(cmd)->EndCommandBuffer(Unwrap(cmd));
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  AddPendingCommandBuffer(cmd);
+
+  SubmitCmds();
+  FlushQ();
+}
+
+void WrappedVulkan::FlushInitialStateReadback()
+{
+  SubmitCmds();
+  FlushQ();
+
+  VkDevice d = GetDev();
+
+  for(VkBuffer buf : m_InitStateReadback.buffers)
+  {
+    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(buf), NULL);
+    GetResourceManager()->ReleaseWrappedResource(buf);
+  }
+
+  for(VkImage im : m_InitStateReadback.images)
+  {
+    ObjDisp(d)->DestroyImage(Unwrap(d), Unwrap(im), NULL);
+    GetResourceManager()->ReleaseWrappedResource(im);
+  }
+
+  m_InitStateReadback.buffers.clear();
+  m_InitStateReadback.images.clear();
+  m_InitStateReadback.size = 0;
+}
+
 uint64_t WrappedVulkan::GetSize_InitialState(ResourceId id, const VkInitialContents &initial)
 {
   if(initial.type == eResDescriptorSet)
@@ -541,6 +725,28 @@ uint64_t WrappedVulkan::GetSize_InitialState(ResourceId id, const VkInitialConte
   return 128;
 }
 
+uint64_t WrappedVulkan::GetSize_PostponedInitialState(ResourceId id)
+{
+  VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
+
+  if(record == NULL)
+    return 0;
+
+  // this matches GetSize_InitialState() once the contents are prepared, with the readback buffer
+  // sized from the record instead of from a readback. Sparse resources are left unknown.
+  if(record->resType == eResDeviceMemory)
+  {
+    return uint64_t(128 + record->Length + WriteSerialiser::GetChunkAlignment());
+  }
+  else if(record->resType == eResImage && record->resInfo && !record->resInfo->IsSparse())
+  {
+    return uint64_t(128 + GetImageReadbackSize(record->resInfo->imageInfo) +
+                    WriteSerialiser::GetChunkAlignment());
+  }
+
+  return 0;
+}
+
 static rdcliteral NameOfType(VkResourceType type)
 {
   switch(type)
@@ -555,8 +761,8 @@ static rdcliteral NameOfType(VkResourceType type)
 }
 
 template <typename SerialiserType>
-bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, VkResourceRecord *,
-                                           const VkInitialContents *initial)
+bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id,
+                                           VkResourceRecord *record, const VkInitialContents *initial)
 {
   bool ret = true;
 
@@ -920,7 +1126,10 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, V
 
     byte *Contents = NULL;
     uint64_t ContentsSize = initial ? initial->mem.size : 0;
+    ResourceId ContentsRef;
     MemoryAllocation mappedMem;
+    bool canReference = false;
+    rdcpair<uint64_t, uint64_t> contentsKey;
 
     // Serialise this separately so that it can be used on reading to prepare the upload memory
     SERIALISE_ELEMENT(ContentsSize);
@@ -952,9 +1161,38 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, V
 
         vkr = ObjDisp(d)->InvalidateMappedMemoryRanges(Unwrap(d), 1, &range);
         RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+        // MSAA images are uploaded through an array image on replay and don't keep their upload
+        // buffer around, so they can't be the source of a reference. Similarly we don't reference
+        // their data from anywhere else.
+        canReference = ContentsSize > 0;
+        if(type == eResImage && record && record->resInfo &&
+           record->resInfo->imageInfo.sampleCount > 1)
+          canReference = false;
+
+        if(canReference)
+        {
+          // seed with the type so that only contents of the same type of resource are matched
+          uint64_t hash = XXH64(Contents, (size_t)ContentsSize, (unsigned long long)type);
+
+          contentsKey = {hash, ContentsSize};
+
+          auto it = m_InitialContentsHashes.find(contentsKey);
+          if(it != m_InitialContentsHashes.end() &&
+             InitialContentsMatch(mappedMem, Contents, it->second))
+            ContentsRef = it->second.id;
+        }
       }
     }
-    else if(IsReplayingAndReading() && !ser.IsErrored())
+
+    // if the contents are identical to those of a resource earlier in this capture, we serialise a
+    // reference to that resource instead of duplicating the data.
+    if(ser.VersionAtLeast(0x13))
+    {
+      SERIALISE_ELEMENT(ContentsRef).TypedAs(NameOfType(type));
+    }
+
+    if(IsReplayingAndReading() && !ser.IsErrored())
     {
       // create a buffer with memory attached, which we will fill with the initial contents
       VkBufferCreateInfo bufInfo = {
@@ -974,15 +1212,90 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, V
       vkr = vkBindBufferMemory(d, uploadBuf, uploadMemory.mem, uploadMemory.offs);
       RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-      mappedMem = uploadMemory;
+      if(ContentsRef == ResourceId())
+      {
+        mappedMem = uploadMemory;
+
+        ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mappedMem.mem), mappedMem.offs,
+                              AlignUp(mappedMem.size, nonCoherentAtomSize), 0, (void **)&Contents);
+      }
+      else
+      {
+        // the referenced initial contents were serialised earlier, so they've already been
+        // uploaded. Copy from there on the GPU
+        VkInitialContents refContents = GetResourceManager()->GetInitialContents(ContentsRef);
+
+        if(refContents.buf == VK_NULL_HANDLE || refContents.mem.size < ContentsSize)
+        {
+          RDCERR("Initial contents for %s reference %s which has no matching upload buffer",
+                 ToStr(id).c_str(), ToStr(ContentsRef).c_str());
+        }
+        else
+        {
+          // INITSTATEBATCH - the copies are all recorded into one command buffer, and submitted
+          // once every initial contents chunk has been read. See FlushInitialContentsReferences
+          VkCommandBuffer cmd = m_InitialContentsRefCmd;
+
+          if(cmd == VK_NULL_HANDLE)
+          {
+            cmd = m_InitialContentsRefCmd = GetNextCmd();
+
+            // keep it out of any other submit until we've finished recording
+            RemovePendingCommandBuffer(cmd);
 
-      ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mappedMem.mem), mappedMem.offs,
-                            AlignUp(mappedMem.size, nonCoherentAtomSize), 0, (void **)&Contents);
+            VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                  NULL, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+            vkr = ObjDisp(cmd)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+            RDCASSERTEQUAL(vkr, VK_SUCCESS);
+          }
+
+          VkBufferCopy region = {0, 0, ContentsSize};
+
+          ObjDisp(cmd)->CmdCopyBuffer(Unwrap(cmd), Unwrap(refContents.buf), Unwrap(uploadBuf), 1,
+                                      &region);
+        }
+      }
     }
 
     // not using SERIALISE_ELEMENT_ARRAY so we can deliberately avoid allocation - we serialise
     // directly into upload memory
-    ser.Serialise("Contents"_lit, Contents, ContentsSize, SerialiserFlags::NoFlags);
+    if(ContentsRef == ResourceId())
+      ser.Serialise("Contents"_lit, Contents, ContentsSize, SerialiserFlags::NoFlags);
+
+    if(ser.IsWriting())
+    {
+      if(ContentsRef != ResourceId())
+      {
+        m_InitialContentsReferences.insert(id);
+      }
+      else
+      {
+        m_InitialContentsWritten.insert(id);
+
+        if(canReference)
+        {
+          // this resource is now the source for its contents. Forget it as the source of any
+          // contents it had before
+          auto keyit = m_InitialContentsKeys.find(id);
+          if(keyit != m_InitialContentsKeys.end() && !(keyit->second == contentsKey))
+          {
+            auto it = m_InitialContentsHashes.find(keyit->second);
+            if(it != m_InitialContentsHashes.end() && it->second.id == id)
+              m_InitialContentsHashes.erase(it);
+          }
+
+          m_InitialContentsKeys[id] = contentsKey;
+
+          InitialContentsSource &source = m_InitialContentsHashes[contentsKey];
+          source.id = id;
+          source.mem = mappedMem;
+          // the contents are the last thing serialised. If this is being serialised into its own
+          // chunk to be kept for later rolling frames, that chunk starts at offset 0
+          source.chunkOffset = ser.GetWriter()->GetOffset() - ContentsSize;
+        }
+      }
+    }
 
     // unmap the resource we mapped before - we need to do this on read and on write.
     if(!IsStructuredExporting(m_State) && mappedMem.mem != VK_NULL_HANDLE)
@@ -911,6 +911,64 @@ MemRefs *VulkanResourceManager::FindMemRefs(ResourceId mem)
     return NULL;
 }
 
+bool VulkanResourceManager::IsFrameOverwritten(ResourceId id, FrameRefType refType)
+{
+  // a read anywhere in the resource (possibly through an alias) means we must keep the contents
+  if(!IsDirtyFrameRef(refType) || IncludesRead(refType))
+    return false;
+
+  if(!HasCurrentResource(id))
+    return false;
+
+  VkResourceRecord *record = GetResourceRecord(id);
+
+  if(!record)
+    return false;
+
+  VkResourceType type = IdentifyTypeByPtr(GetCurrentResource(id));
+
+  if(type == eResImage)
+  {
+    // sparse images also store their page mapping in the initial contents
+    if(!record->resInfo || record->resInfo->IsSparse())
+      return false;
+
+    LockedConstImageStateRef state = m_Core->FindConstImageState(id);
+
+    if(!state)
+      return false;
+
+    // every subresource must have been completely written first
+    for(auto it = state->subresourceStates.begin(); it != state->subresourceStates.end(); ++it)
+    {
+      if(!IsCompleteWriteFrameRef(it->state().refType))
+        return false;
+    }
+
+    return true;
+  }
+  else if(type == eResDeviceMemory)
+  {
+    MemRefs *memRefs = FindMemRefs(id);
+
+    if(!memRefs)
+      return false;
+
+    // every range in the memory must have been completely written first. Writes from images bound
+    // to the memory are not tracked by range, so those ranges will fail this check.
+    for(auto it = memRefs->rangeRefs.begin();
+        it != memRefs->rangeRefs.end() && it->start() < record->Length; ++it)
+    {
+      if(!IsCompleteWriteFrameRef(it->value()))
+        return false;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
 bool VulkanResourceManager::Prepare_InitialState(WrappedVkRes *res)
 {
   return m_Core->Prepare_InitialState(res);
@@ -921,6 +979,17 @@ uint64_t VulkanResourceManager::GetSize_InitialState(ResourceId id, const VkInit
   return m_Core->GetSize_InitialState(id, initial);
 }
 
+uint64_t VulkanResourceManager::GetSize_PostponedInitialState(ResourceId id)
+{
+  return m_Core->GetSize_PostponedInitialState(id);
+}
+
+bool VulkanResourceManager::IsInitialChunkReusable(ResourceId id)
+{
+  // a reference is only valid while the referenced contents are written earlier in the same frame
+  return !m_Core->IsInitialContentsReference(id);
+}
+
 bool VulkanResourceManager::Serialise_InitialState(WriteSerialiser &ser, ResourceId id,
                                                    VkResourceRecord *record,
                                                    const VkInitialContents *initial)
@@ -475,8 +475,11 @@ public:
 private:
   bool ResourceTypeRelease(WrappedVkRes *res);
 
+  bool IsFrameOverwritten(ResourceId id, FrameRefType refType);
   bool Prepare_InitialState(WrappedVkRes *res);
   uint64_t GetSize_InitialState(ResourceId id, const VkInitialContents &initial);
+  uint64_t GetSize_PostponedInitialState(ResourceId id);
+  bool IsInitialChunkReusable(ResourceId id);
   bool Serialise_InitialState(WriteSerialiser &ser, ResourceId id, VkResourceRecord *record,
                               const VkInitialContents *initial);
   void Create_InitialState(ResourceId id, WrappedVkRes *live, bool hasData);
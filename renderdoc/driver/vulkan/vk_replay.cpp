@@ -440,7 +440,7 @@ ShaderReflection *VulkanReplay::GetShader(ResourceId pipeline, ResourceId shader
   // if this shader was never used in a pipeline the reflection won't be prepared. Do that now -
   // this will be ignored if it was already prepared.
   shad->second.GetReflection(entry.name, pipeline)
-      .Init(GetResourceManager(), shader, shad->second.spirv, entry.name,
+      .Init(GetResourceManager(), m_pDriver->m_CreationInfo, shader, shad->second, entry.name,
             VkShaderStageFlagBits(1 << uint32_t(entry.stage)), {});
 
   return &shad->second.GetReflection(entry.name, pipeline).refl;
@@ -3498,18 +3498,47 @@ void VulkanReplay::GetTextureData(ResourceId tex, const Subresource &sub,
     copyregion[i].imageExtent.depth = RDCMAX(1U, copyregion[i].imageExtent.depth >> s.mip);
   }
 
+  // 3D textures that were remapped have been rendered out to a 2D array
+  const bool remapped3D = imInfo.type == VK_IMAGE_TYPE_3D && params.remap != RemapTexture::NoRemap;
+
+  // crop to the requested region as part of the copy, so only that is read back. ASTC and PVRTC
+  // blocks aren't 4x4 so they can't be cropped, and are left for CropTextureData to reject below
+  const ResourceFormat copyFormat = MakeResourceFormat(imCreateInfo.format);
+  const bool cropOnCopy = copyFormat.type != ResourceFormatType::ASTC &&
+                          copyFormat.type != ResourceFormatType::PVRTC;
+
+  const TextureRegion readRegion = ClampTextureRegion(
+      cropOnCopy ? params.region : TextureRegion(), copyregion[0].imageExtent.width,
+      copyregion[0].imageExtent.height,
+      remapped3D ? imCreateInfo.arrayLayers : copyregion[0].imageExtent.depth,
+      IsBlockFormat(imCreateInfo.format) ? 4 : 1);
+
+  for(int i = 0; i < 2; i++)
+  {
+    copyregion[i].imageOffset.x = (int32_t)readRegion.x;
+    copyregion[i].imageOffset.y = (int32_t)readRegion.y;
+    copyregion[i].imageExtent.width = readRegion.width;
+    copyregion[i].imageExtent.height = readRegion.height;
+
+    if(!remapped3D)
+    {
+      copyregion[i].imageOffset.z = (int32_t)readRegion.z;
+      copyregion[i].imageExtent.depth = readRegion.depth;
+    }
+  }
+
   uint32_t dataSize = 0;
 
   // for most combined depth-stencil images this will be large enough for both to be copied
   // separately, but for D24S8 we need to add extra space since they won't be copied packed
-  dataSize = GetByteSize(imInfo.extent.width, imInfo.extent.height, imInfo.extent.depth,
-                         imCreateInfo.format, s.mip);
+  dataSize = GetByteSize(readRegion.width, readRegion.height, readRegion.depth,
+                         imCreateInfo.format, 0);
 
   if(imCreateInfo.format == VK_FORMAT_D24_UNORM_S8_UINT)
   {
     dataSize = AlignUp(dataSize, 4U);
-    dataSize += GetByteSize(imInfo.extent.width, imInfo.extent.height, imInfo.extent.depth,
-                            VK_FORMAT_S8_UINT, s.mip);
+    dataSize += GetByteSize(readRegion.width, readRegion.height, readRegion.depth,
+                            VK_FORMAT_S8_UINT, 0);
   }
 
   VkBufferCreateInfo bufInfo = {
@@ -3542,24 +3571,22 @@ void VulkanReplay::GetTextureData(ResourceId tex, const Subresource &sub,
 
   if(isDepth && isStencil)
   {
-    copyregion[1].bufferOffset =
-        GetByteSize(imInfo.extent.width, imInfo.extent.height, imInfo.extent.depth,
-                    GetDepthOnlyFormat(imCreateInfo.format), s.mip);
+    copyregion[1].bufferOffset = GetByteSize(readRegion.width, readRegion.height, readRegion.depth,
+                                             GetDepthOnlyFormat(imCreateInfo.format), 0);
 
     copyregion[1].bufferOffset = AlignUp(copyregion[1].bufferOffset, (VkDeviceSize)4);
 
     vt->CmdCopyImageToBuffer(Unwrap(cmd), srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                              readbackBuf, 2, copyregion);
   }
-  else if(imInfo.type == VK_IMAGE_TYPE_3D && params.remap != RemapTexture::NoRemap)
+  else if(remapped3D)
   {
     // copy in each slice from the 2D array we created to render out the 3D texture
-    for(uint32_t i = 0; i < imCreateInfo.arrayLayers; i++)
+    for(uint32_t i = 0; i < readRegion.depth; i++)
     {
-      copyregion[0].imageSubresource.baseArrayLayer = i;
+      copyregion[0].imageSubresource.baseArrayLayer = readRegion.z + i;
       copyregion[0].bufferOffset =
-          i * GetByteSize(imCreateInfo.extent.width, imCreateInfo.extent.height, 1,
-                          imCreateInfo.format, s.mip);
+          i * GetByteSize(readRegion.width, readRegion.height, 1, imCreateInfo.format, 0);
       vt->CmdCopyImageToBuffer(Unwrap(cmd), srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                                readbackBuf, 1, copyregion);
     }
@@ -3645,9 +3672,7 @@ void VulkanReplay::GetTextureData(ResourceId tex, const Subresource &sub,
   }
   else if(isDepth && isStencil)
   {
-    size_t pixelCount = std::max(1U, imCreateInfo.extent.width >> s.mip) *
-                        std::max(1U, imCreateInfo.extent.height >> s.mip) *
-                        std::max(1U, imCreateInfo.extent.depth >> s.mip);
+    size_t pixelCount = size_t(readRegion.width) * readRegion.height * readRegion.depth;
 
     // for some reason reading direct from mapped memory here is *super* slow on android (1.5s to
     // iterate over the image), so we memcpy to a temporary buffer.
@@ -3782,6 +3807,9 @@ void VulkanReplay::GetTextureData(ResourceId tex, const Subresource &sub,
     delete[] tmpView;
     vt->DestroyRenderPass(Unwrap(dev), tmpRP, NULL);
   }
+
+  if(!cropOnCopy)
+    CropTextureData(GetTexture(tex), sub, params, data);
 }
 
 void VulkanReplay::BuildCustomShader(ShaderEncoding sourceEncoding, const bytebuf &source,
@@ -224,6 +224,10 @@ VulkanShaderCache::VulkanShaderCache(WrappedVulkan *driver)
   // if we failed to load from the cache
   m_ShaderCacheDirty = !success;
 
+  if(IsReplayMode(driver->GetState()))
+    m_ReflectionCache = new ShaderReflectionCache("vkreflection.cache", m_ReflectionCacheMagic,
+                                                  m_ReflectionCacheVersion);
+
   m_pDriver = driver;
   m_Device = driver->GetDev();
 
@@ -438,6 +442,8 @@ VulkanShaderCache::~VulkanShaderCache()
       VulkanShaderCacheCallbacks.Destroy(it->second);
   }
 
+  SAFE_DELETE(m_ReflectionCache);
+
   for(size_t i = 0; i < ARRAY_COUNT(m_BuiltinShaderModules); i++)
     for(size_t b = 0; b < ARRAY_COUNT(m_BuiltinShaderModules[0]); b++)
       for(size_t t = 0; t < ARRAY_COUNT(m_BuiltinShaderModules[0][0]); t++)
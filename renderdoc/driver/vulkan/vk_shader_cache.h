@@ -30,6 +30,8 @@
 
 typedef rdcarray<uint32_t> *SPIRVBlob;
 
+class ShaderReflectionCache;
+
 enum class BuiltinShader
 {
   BlitVS,
@@ -115,10 +117,14 @@ public:
   bool IsMS2ArraySupported() { return m_MS2ArraySupported; }
   bool IsArray2MSSupported() { return m_Array2MSSupported; }
   void SetCaching(bool enabled) { m_CacheShaders = enabled; }
+  ShaderReflectionCache *GetReflectionCache() { return m_ReflectionCache; }
 private:
   static const uint32_t m_ShaderCacheMagic = 0xf00d00d5;
   static const uint32_t m_ShaderCacheVersion = 1;
 
+  static const uint32_t m_ReflectionCacheMagic = 0xf00d4ef1;
+  static const uint32_t m_ReflectionCacheVersion = 1;
+
   void GetPipeCacheBlob();
   void SetPipeCacheBlob(bytebuf &blob);
 
@@ -133,6 +139,9 @@ private:
   bool m_ShaderCacheDirty = false, m_CacheShaders = false;
   std::map<uint32_t, SPIRVBlob> m_ShaderCache;
 
+  // only used on replay, for the application's shaders
+  ShaderReflectionCache *m_ReflectionCache = NULL;
+
   SPIRVBlob m_BuiltinShaderBlobs[arraydim<BuiltinShader>()][arraydim<BuiltinShaderBaseType>()]
                                 [arraydim<BuiltinShaderTextureType>()] = {};
   VkShaderModule m_BuiltinShaderModules[arraydim<BuiltinShader>()][arraydim<BuiltinShaderBaseType>()]
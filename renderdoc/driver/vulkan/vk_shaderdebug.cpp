@@ -341,6 +341,9 @@ public:
     m_ResourcesDirty = true;
   }
 
+  // the draw has been replayed by someone else, so replay back to pristine state next time
+  void MarkResourcesDirty() { m_ResourcesDirty = true; }
+
   virtual void AddDebugMessage(MessageCategory c, MessageSeverity sv, MessageSource src,
                                rdcstr d) override
   {
@@ -2820,6 +2823,8 @@ enum class InputSpecConstant
   DestX,
   DestY,
   AddressMSB,
+  DestWidth,
+  DestHeight,
   Count,
 };
 
@@ -3147,6 +3152,19 @@ static void CreatePSInputFetcher(rdcarray<uint32_t> &fragspv, uint32_t &structSt
 
   editor.SetName(destXY, "destXY");
 
+  rdcspv::Id destWidth =
+      editor.AddSpecConstantImmediate<float>(1.0f, (uint32_t)InputSpecConstant::DestWidth);
+  rdcspv::Id destHeight =
+      editor.AddSpecConstantImmediate<float>(1.0f, (uint32_t)InputSpecConstant::DestHeight);
+
+  editor.SetName(destWidth, "destWidth");
+  editor.SetName(destHeight, "destHeight");
+
+  rdcspv::Id destSize = editor.AddConstant(
+      rdcspv::OpSpecConstantComposite(float2Type, editor.MakeId(), {destWidth, destHeight}));
+
+  editor.SetName(destSize, "destSize");
+
   rdcspv::Id PSHit = editor.DeclareStructType({
       // float4 pos;
       float4Type,
@@ -3372,8 +3390,6 @@ static void CreatePSInputFetcher(rdcarray<uint32_t> &fragspv, uint32_t &structSt
   rdcspv::Id uint32BufPtr = editor.DeclareType(rdcspv::Pointer(uint32Type, bufferClass));
   rdcspv::Id floatBufPtr = editor.DeclareType(rdcspv::Pointer(floatType, bufferClass));
 
-  rdcspv::Id glsl450 = editor.ImportExtInst("GLSL.std.450");
-
   editor.AddCapability(rdcspv::Capability::DerivativeControl);
 
   {
@@ -3510,26 +3526,29 @@ static void CreatePSInputFetcher(rdcarray<uint32_t> &fragspv, uint32_t &structSt
       rdcspv::Id fragXY = ops.add(rdcspv::OpVectorShuffle(
           float2Type, editor.MakeId(), fragCoordLoaded, fragCoordLoaded, {0, 1}));
 
-      // subtract from the destination co-ord
+      // subtract from the destination rectangle's top-left co-ord
       rdcspv::Id fragXYRelative =
           ops.add(rdcspv::OpFSub(float2Type, editor.MakeId(), fragXY, destXY));
 
-      // abs()
-      rdcspv::Id fragXYAbs = ops.add(rdcspv::OpGLSL450(float2Type, editor.MakeId(), glsl450,
-                                                       rdcspv::GLSLstd450::FAbs, {fragXYRelative}));
+      rdcspv::Id zero = editor.AddConstantImmediate<float>(0.0f);
+      rdcspv::Id zero2 = editor.AddConstant(
+          rdcspv::OpConstantComposite(float2Type, editor.MakeId(), {zero, zero}));
 
-      rdcspv::Id half = editor.AddConstantImmediate<float>(0.5f);
-      rdcspv::Id threshold =
-          editor.AddConstant(rdcspv::OpConstantComposite(float2Type, editor.MakeId(), {half, half}));
+      // at or past the top-left
+      rdcspv::Id inRectMin = ops.add(
+          rdcspv::OpFOrdGreaterThanEqual(bool2Type, editor.MakeId(), fragXYRelative, zero2));
 
-      // less than 0.5
-      rdcspv::Id inPixelXY =
-          ops.add(rdcspv::OpFOrdLessThan(bool2Type, editor.MakeId(), fragXYAbs, threshold));
+      // and before the bottom-right
+      rdcspv::Id inRectMax =
+          ops.add(rdcspv::OpFOrdLessThan(bool2Type, editor.MakeId(), fragXYRelative, destSize));
 
-      // both less than 0.5
-      rdcspv::Id inPixel = ops.add(rdcspv::OpAll(boolType, editor.MakeId(), inPixelXY));
+      rdcspv::Id inRectXY =
+          ops.add(rdcspv::OpLogicalAnd(bool2Type, editor.MakeId(), inRectMin, inRectMax));
 
-      // bool inPixel = all(abs(gl_FragCoord.xy - dest.xy) < 0.5f);
+      // in both dimensions
+      rdcspv::Id inPixel = ops.add(rdcspv::OpAll(boolType, editor.MakeId(), inRectXY));
+
+      // bool inPixel = all(gl_FragCoord.xy - dest.xy >= 0.0f && gl_FragCoord.xy - dest.xy < size);
 
       rdcspv::Id killLabel = editor.MakeId();
       rdcspv::Id continueLabel = editor.MakeId();
@@ -3895,19 +3914,20 @@ ShaderDebugTrace *VulkanReplay::DebugVertex(uint32_t eventId, uint32_t vertid, u
   return ret;
 }
 
-ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y,
-                                           uint32_t sample, uint32_t primitive)
+void VulkanReplay::DebugPixelRect(uint32_t eventId, uint32_t x, uint32_t y, uint32_t width,
+                                  uint32_t height, uint32_t sample, uint32_t primitive,
+                                  const PixelDebugCallback &callback)
 {
   if(!GetAPIProperties().shaderDebugging)
   {
     RDCUNIMPLEMENTED("Pixel debugging not yet implemented for Vulkan");
-    return new ShaderDebugTrace;
+    return;
   }
 
   if(!m_pDriver->GetDeviceEnabledFeatures().fragmentStoresAndAtomics)
   {
     RDCWARN("Pixel debugging is not supported without fragment stores");
-    return new ShaderDebugTrace;
+    return;
   }
 
   VkDevice dev = m_pDriver->GetDev();
@@ -3916,8 +3936,9 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   const VulkanRenderState &state = m_pDriver->GetRenderState();
   VulkanCreationInfo &c = m_pDriver->m_CreationInfo;
 
-  rdcstr regionName = StringFormat::Fmt("DebugPixel @ %u of (%u,%u) sample %u primitive %u",
-                                        eventId, x, y, sample, primitive);
+  rdcstr regionName =
+      StringFormat::Fmt("DebugPixel @ %u of (%u,%u) %ux%u sample %u primitive %u", eventId, x, y,
+                        width, height, sample, primitive);
 
   VkMarkerRegion region(regionName);
 
@@ -3929,7 +3950,7 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   if(!(draw->flags & DrawFlags::Drawcall))
   {
     RDCLOG("No drawcall selected");
-    return new ShaderDebugTrace();
+    return;
   }
 
   const VulkanCreationInfo::Pipeline &pipe = c.m_Pipeline[state.graphics.pipeline];
@@ -3937,7 +3958,7 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   if(pipe.shaders[4].module == ResourceId())
   {
     RDCLOG("No pixel shader bound at draw");
-    return new ShaderDebugTrace();
+    return;
   }
 
   // get ourselves in pristine state before this draw (without any side effects it may have had)
@@ -3953,19 +3974,11 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   if(!shadRefl.refl.debugInfo.debuggable)
   {
     RDCLOG("Shader is not debuggable: %s", shadRefl.refl.debugInfo.debugStatus.c_str());
-    return new ShaderDebugTrace();
+    return;
   }
 
   shadRefl.PopulateDisassembly(shader.spirv);
 
-  VulkanAPIWrapper *apiWrapper =
-      new VulkanAPIWrapper(m_pDriver, c, VK_SHADER_STAGE_FRAGMENT_BIT, eventId);
-
-  std::map<ShaderBuiltin, ShaderVariable> &builtins = apiWrapper->builtin_inputs;
-  builtins[ShaderBuiltin::DeviceIndex] = ShaderVariable(rdcstr(), 0U, 0U, 0U, 0U);
-  builtins[ShaderBuiltin::DrawIndex] = ShaderVariable(rdcstr(), draw->drawIndex, 0U, 0U, 0U);
-  builtins[ShaderBuiltin::Position] = ShaderVariable(rdcstr(), x, y, 0U, 0U);
-
   // If the pipe contains a geometry shader, then Primitive ID cannot be used in the pixel
   // shader without being emitted from the geometry shader. For now, check if this semantic
   // will succeed in a new pixel shader with the rest of the pipe unchanged
@@ -4069,7 +4082,8 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   if(!Vulkan_Debug_PSDebugDumpDirPath().empty())
     FileIO::WriteAll(Vulkan_Debug_PSDebugDumpDirPath() + "/debug_psinput_after.spv", fragspv);
 
-  uint32_t overdrawLevels = 100;    // maximum number of overdraw levels
+  // maximum number of fragments stored, shared between all the pixels in the rectangle
+  const uint32_t overdrawLevels = PixelDebugHitCapacity(width, height);
 
   VkGraphicsPipelineCreateInfo graphicsInfo = {};
 
@@ -4103,11 +4117,15 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
     uint32_t arrayLength;
     float destX;
     float destY;
+    float destWidth;
+    float destHeight;
   } specData = {};
 
   specData.arrayLength = overdrawLevels;
-  specData.destX = float(x) + 0.5f;
-  specData.destY = float(y) + 0.5f;
+  specData.destX = float(x);
+  specData.destY = float(y);
+  specData.destWidth = float(width);
+  specData.destHeight = float(height);
 
   VkDescriptorPool descpool = VK_NULL_HANDLE;
   rdcarray<VkDescriptorSetLayout> setLayouts;
@@ -4149,14 +4167,7 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
 
     // if the pool failed due to limits, it will be NULL so bail now
     if(descpool == VK_NULL_HANDLE)
-    {
-      delete apiWrapper;
-
-      ShaderDebugTrace *ret = new ShaderDebugTrace;
-      ret->stage = ShaderStage::Pixel;
-
-      return ret;
-    }
+      return;
 
     // create pipeline layout with new descriptor set layouts
     const rdcarray<VkPushConstantRange> &push = c.m_PipelineLayout[pipe.layout].pushRanges;
@@ -4214,6 +4225,14 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
       {
           (uint32_t)InputSpecConstant::DestY, offsetof(SpecData, destY), sizeof(SpecData::destY),
       },
+      {
+          (uint32_t)InputSpecConstant::DestWidth, offsetof(SpecData, destWidth),
+          sizeof(SpecData::destWidth),
+      },
+      {
+          (uint32_t)InputSpecConstant::DestHeight, offsetof(SpecData, destHeight),
+          sizeof(SpecData::destHeight),
+      },
       {
           (uint32_t)InputSpecConstant::AddressMSB, offsetof(SpecData, bufferAddress) + 4,
           sizeof(uint32_t),
@@ -4365,6 +4384,28 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   bytebuf data;
   GetBufferData(GetResID(m_BindlessFeedback.FeedbackBuffer.buf), 0, 0, data);
 
+  if(descpool != VK_NULL_HANDLE)
+  {
+    // delete descriptors. Technically we don't have to free the descriptor sets, but our tracking
+    // on replay doesn't handle destroying children of pooled objects so we do it explicitly anyway.
+    m_pDriver->vkFreeDescriptorSets(dev, descpool, (uint32_t)descSets.size(), descSets.data());
+
+    m_pDriver->vkDestroyDescriptorPool(dev, descpool, NULL);
+  }
+
+  for(VkDescriptorSetLayout layout : setLayouts)
+    m_pDriver->vkDestroyDescriptorSetLayout(dev, layout, NULL);
+
+  // delete pipeline layout
+  m_pDriver->vkDestroyPipelineLayout(dev, pipeLayout, NULL);
+
+  // delete pipeline
+  m_pDriver->vkDestroyPipeline(dev, inputsPipe, NULL);
+
+  // delete shader modules
+  for(VkShaderModule s : modules)
+    m_pDriver->vkDestroyShaderModule(dev, s, NULL);
+
   byte *base = data.data();
   uint32_t numHits = ((uint32_t *)base)[0];
   uint32_t totalHits = ((uint32_t *)base)[1];
@@ -4377,23 +4418,22 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
 
   base += sizeof(Vec4f);
 
-  PSHit *winner = NULL;
-
   RDCLOG("Got %u hit candidates out of %u total instances", numHits, totalHits);
 
-  // if we encounter multiple hits at our destination pixel co-ord (or any other) we
-  // check to see if a specific primitive was requested (via primitive parameter not
-  // being set to ~0U). If it was, debug that pixel, otherwise do a best-estimate
-  // of which fragment was the last to successfully depth test and debug that, just by
-  // checking if the depth test is ordered and picking the final fragment in the series
+  // sort the hits into the pixels they landed in, keeping the order they were written in
+  rdcarray<rdcarray<uint32_t>> pixelHits;
+  pixelHits.resize(width * height);
 
-  // figure out the TL pixel's coords. Assume even top left (towards 0,0)
-  // this isn't spec'd but is a reasonable assumption.
-  int xTL = x & (~1);
-  int yTL = y & (~1);
+  for(uint32_t i = 0; i < numHits; i++)
+  {
+    PSHit *hit = (PSHit *)(base + structSize * i);
 
-  // get the index of our desired pixel
-  int destIdx = (x - xTL) + 2 * (y - yTL);
+    const uint32_t col = uint32_t(hit->pos.x) - x;
+    const uint32_t row = uint32_t(hit->pos.y) - y;
+
+    if(col < width && row < height)
+      pixelHits[row * width + col].push_back(i);
+  }
 
   VkCompareOp depthOp = state.depthCompareOp;
 
@@ -4401,177 +4441,238 @@ ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_
   if(!state.depthTestEnable)
     depthOp = VK_COMPARE_OP_ALWAYS;
 
-  for(uint32_t i = 0; i < numHits; i++)
-  {
-    PSHit *hit = (PSHit *)(base + structSize * i);
-
-    if(hit->valid != validMagicNumber)
-    {
-      RDCWARN("Hit %u doesn't have valid magic number", i);
-      continue;
-    }
+  // the shader is parsed once, and each pixel's debugger starts from a copy of it
+  rdcspv::Debugger program;
+  bool parsed = false;
 
-    if(hit->ddxDerivCheck != 1.0f)
+  for(uint32_t row = 0; row < height; row++)
+  {
+    for(uint32_t col = 0; col < width; col++)
     {
-      RDCWARN("Hit %u doesn't have valid derivatives", i);
-      continue;
-    }
+      const uint32_t px = x + col;
+      const uint32_t py = y + row;
 
-    // see if this hit is a closer match than the previous winner.
+      PSHit *winner = NULL;
 
-    // if there's no previous winner it's clearly better
-    if(winner == NULL)
-    {
-      winner = hit;
-      continue;
-    }
+      // if we encounter multiple hits at our destination pixel co-ord (or any other) we
+      // check to see if a specific primitive was requested (via primitive parameter not
+      // being set to ~0U). If it was, debug that pixel, otherwise do a best-estimate
+      // of which fragment was the last to successfully depth test and debug that, just by
+      // checking if the depth test is ordered and picking the final fragment in the series
 
-    // if we're looking for a specific primitive
-    if(primitive != ~0U)
-    {
-      // and this hit is a match and the winner isn't, it's better
-      if(winner->prim != primitive && hit->prim == primitive)
+      for(uint32_t i : pixelHits[row * width + col])
       {
-        winner = hit;
-        continue;
+        PSHit *hit = (PSHit *)(base + structSize * i);
+
+        if(hit->valid != validMagicNumber)
+        {
+          RDCWARN("Hit %u doesn't have valid magic number", i);
+          continue;
+        }
+
+        if(hit->ddxDerivCheck != 1.0f)
+        {
+          RDCWARN("Hit %u doesn't have valid derivatives", i);
+          continue;
+        }
+
+        // see if this hit is a closer match than the previous winner.
+
+        // if there's no previous winner it's clearly better
+        if(winner == NULL)
+        {
+          winner = hit;
+          continue;
+        }
+
+        // if we're looking for a specific primitive
+        if(primitive != ~0U)
+        {
+          // and this hit is a match and the winner isn't, it's better
+          if(winner->prim != primitive && hit->prim == primitive)
+          {
+            winner = hit;
+            continue;
+          }
+
+          // if the winner is a match and we're not, we can't be better so stop now
+          if(winner->prim == primitive && hit->prim != primitive)
+          {
+            continue;
+          }
+        }
+
+        // if we're looking for a particular sample, check that
+        if(sample != ~0U)
+        {
+          if(winner->sample != sample && hit->sample == sample)
+          {
+            winner = hit;
+            continue;
+          }
+
+          if(winner->sample == sample && hit->sample != sample)
+          {
+            continue;
+          }
+        }
+
+        // otherwise apply depth test
+        switch(depthOp)
+        {
+          case VK_COMPARE_OP_NEVER:
+          case VK_COMPARE_OP_EQUAL:
+          case VK_COMPARE_OP_NOT_EQUAL:
+          case VK_COMPARE_OP_ALWAYS:
+          default:
+            // don't emulate equal or not equal since we don't know the reference value. Take any
+            // hit (thus meaning the last hit)
+            winner = hit;
+            break;
+          case VK_COMPARE_OP_LESS:
+            if(hit->pos.z < winner->pos.z)
+              winner = hit;
+            break;
+          case VK_COMPARE_OP_LESS_OR_EQUAL:
+            if(hit->pos.z <= winner->pos.z)
+              winner = hit;
+            break;
+          case VK_COMPARE_OP_GREATER:
+            if(hit->pos.z > winner->pos.z)
+              winner = hit;
+            break;
+          case VK_COMPARE_OP_GREATER_OR_EQUAL:
+            if(hit->pos.z >= winner->pos.z)
+              winner = hit;
+            break;
+        }
       }
 
-      // if the winner is a match and we're not, we can't be better so stop now
-      if(winner->prim == primitive && hit->prim != primitive)
-      {
+      if(winner == NULL)
         continue;
-      }
-    }
 
-    // if we're looking for a particular sample, check that
-    if(sample != ~0U)
-    {
-      if(winner->sample != sample && hit->sample == sample)
+      if(!parsed)
       {
-        winner = hit;
-        continue;
+        program.Parse(shader.spirv.GetSPIRV());
+        parsed = true;
       }
 
-      if(winner->sample == sample && hit->sample != sample)
+      // figure out the TL pixel's coords. Assume even top left (towards 0,0)
+      // this isn't spec'd but is a reasonable assumption.
+      int xTL = px & (~1);
+      int yTL = py & (~1);
+
+      // get the index of our desired pixel
+      int destIdx = (px - xTL) + 2 * (py - yTL);
+
+      // the replay is still in the pristine state before the draw, so the API wrapper can be
+      // created now
+      VulkanAPIWrapper *apiWrapper =
+          new VulkanAPIWrapper(m_pDriver, c, VK_SHADER_STAGE_FRAGMENT_BIT, eventId);
+
+      std::map<ShaderBuiltin, ShaderVariable> &builtins = apiWrapper->builtin_inputs;
+      builtins[ShaderBuiltin::DeviceIndex] = ShaderVariable(rdcstr(), 0U, 0U, 0U, 0U);
+      builtins[ShaderBuiltin::DrawIndex] = ShaderVariable(rdcstr(), draw->drawIndex, 0U, 0U, 0U);
+      builtins[ShaderBuiltin::Position] = ShaderVariable(rdcstr(), px, py, 0U, 0U);
+
+      rdcspv::Debugger *debugger = program.CloneParsed();
+
+      // the data immediately follows the PSHit header. Every piece of data is uniformly aligned,
+      // either 16-byte by default or 32-byte if larger components exist. The output is in input
+      // signature order.
+      byte *PSInputs = (byte *)(winner + 1);
+      byte *value = (byte *)(PSInputs + 0 * structStride);
+      byte *ddxcoarse = (byte *)(PSInputs + 1 * structStride);
+      byte *ddycoarse = (byte *)(PSInputs + 2 * structStride);
+      byte *ddxfine = (byte *)(PSInputs + 3 * structStride);
+      byte *ddyfine = (byte *)(PSInputs + 4 * structStride);
+
+      for(size_t i = 0; i < shadRefl.refl.inputSignature.size(); i++)
       {
-        continue;
-      }
-    }
+        const SigParameter &param = shadRefl.refl.inputSignature[i];
 
-    // otherwise apply depth test
-    switch(depthOp)
-    {
-      case VK_COMPARE_OP_NEVER:
-      case VK_COMPARE_OP_EQUAL:
-      case VK_COMPARE_OP_NOT_EQUAL:
-      case VK_COMPARE_OP_ALWAYS:
-      default:
-        // don't emulate equal or not equal since we don't know the reference value. Take any hit
-        // (thus meaning the last hit)
-        winner = hit;
-        break;
-      case VK_COMPARE_OP_LESS:
-        if(hit->pos.z < winner->pos.z)
-          winner = hit;
-        break;
-      case VK_COMPARE_OP_LESS_OR_EQUAL:
-        if(hit->pos.z <= winner->pos.z)
-          winner = hit;
-        break;
-      case VK_COMPARE_OP_GREATER:
-        if(hit->pos.z > winner->pos.z)
-          winner = hit;
-        break;
-      case VK_COMPARE_OP_GREATER_OR_EQUAL:
-        if(hit->pos.z >= winner->pos.z)
-          winner = hit;
-        break;
-    }
-  }
+        bool builtin = true;
+        if(param.systemValue == ShaderBuiltin::Undefined)
+        {
+          builtin = false;
+          apiWrapper->location_inputs.resize(
+              RDCMAX((uint32_t)apiWrapper->location_inputs.size(), param.regIndex + 1));
+          apiWrapper->location_derivatives.resize(
+              RDCMAX((uint32_t)apiWrapper->location_derivatives.size(), param.regIndex + 1));
+        }
 
-  ShaderDebugTrace *ret = NULL;
+        ShaderVariable &var = builtin ? apiWrapper->builtin_inputs[param.systemValue]
+                                      : apiWrapper->location_inputs[param.regIndex];
+        rdcspv::DebugAPIWrapper::DerivativeDeltas &deriv =
+            builtin ? apiWrapper->builtin_derivatives[param.systemValue]
+                    : apiWrapper->location_derivatives[param.regIndex];
 
-  if(winner)
-  {
-    rdcspv::Debugger *debugger = new rdcspv::Debugger;
-    debugger->Parse(shader.spirv.GetSPIRV());
-
-    // the data immediately follows the PSHit header. Every piece of data is uniformly aligned,
-    // either 16-byte by default or 32-byte if larger components exist. The output is in input
-    // signature order.
-    byte *PSInputs = (byte *)(winner + 1);
-    byte *value = (byte *)(PSInputs + 0 * structStride);
-    byte *ddxcoarse = (byte *)(PSInputs + 1 * structStride);
-    byte *ddycoarse = (byte *)(PSInputs + 2 * structStride);
-    byte *ddxfine = (byte *)(PSInputs + 3 * structStride);
-    byte *ddyfine = (byte *)(PSInputs + 4 * structStride);
+        const uint32_t comp = Bits::CountTrailingZeroes(uint32_t(param.regChannelMask));
+        const uint32_t elemSize = VarTypeByteSize(param.varType);
 
-    for(size_t i = 0; i < shadRefl.refl.inputSignature.size(); i++)
-    {
-      const SigParameter &param = shadRefl.refl.inputSignature[i];
+        const size_t sz = elemSize * param.compCount;
 
-      bool builtin = true;
-      if(param.systemValue == ShaderBuiltin::Undefined)
-      {
-        builtin = false;
-        apiWrapper->location_inputs.resize(
-            RDCMAX((uint32_t)apiWrapper->location_inputs.size(), param.regIndex + 1));
-        apiWrapper->location_derivatives.resize(
-            RDCMAX((uint32_t)apiWrapper->location_derivatives.size(), param.regIndex + 1));
+        memcpy(((byte *)var.value.u64v) + elemSize * comp, value + i * paramAlign, sz);
+        memcpy(((byte *)deriv.ddxcoarse.value.u64v) + elemSize * comp, ddxcoarse + i * paramAlign,
+               sz);
+        memcpy(((byte *)deriv.ddycoarse.value.u64v) + elemSize * comp, ddycoarse + i * paramAlign,
+               sz);
+        memcpy(((byte *)deriv.ddxfine.value.u64v) + elemSize * comp, ddxfine + i * paramAlign, sz);
+        memcpy(((byte *)deriv.ddyfine.value.u64v) + elemSize * comp, ddyfine + i * paramAlign, sz);
       }
 
-      ShaderVariable &var = builtin ? apiWrapper->builtin_inputs[param.systemValue]
-                                    : apiWrapper->location_inputs[param.regIndex];
-      rdcspv::DebugAPIWrapper::DerivativeDeltas &deriv =
-          builtin ? apiWrapper->builtin_derivatives[param.systemValue]
-                  : apiWrapper->location_derivatives[param.regIndex];
+      ShaderDebugTrace *ret = debugger->BeginDebug(apiWrapper, ShaderStage::Pixel, entryPoint, spec,
+                                                   shadRefl.instructionLines, shadRefl.patchData,
+                                                   destIdx);
 
-      const uint32_t comp = Bits::CountTrailingZeroes(uint32_t(param.regChannelMask));
-      const uint32_t elemSize = VarTypeByteSize(param.varType);
+      callback(px, py, ret);
+    }
+  }
 
-      const size_t sz = elemSize * param.compCount;
+  // if any pixel was debugged, replay the draw to get back to 'normal' state for this event as
+  // ResetReplay would. Callers that keep a trace past the callback must mark its resources dirty.
+  if(parsed)
+    m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
+}
 
-      memcpy(((byte *)var.value.u64v) + elemSize * comp, value + i * paramAlign, sz);
-      memcpy(((byte *)deriv.ddxcoarse.value.u64v) + elemSize * comp, ddxcoarse + i * paramAlign, sz);
-      memcpy(((byte *)deriv.ddycoarse.value.u64v) + elemSize * comp, ddycoarse + i * paramAlign, sz);
-      memcpy(((byte *)deriv.ddxfine.value.u64v) + elemSize * comp, ddxfine + i * paramAlign, sz);
-      memcpy(((byte *)deriv.ddyfine.value.u64v) + elemSize * comp, ddyfine + i * paramAlign, sz);
-    }
+ShaderDebugTrace *VulkanReplay::DebugPixel(uint32_t eventId, uint32_t x, uint32_t y,
+                                           uint32_t sample, uint32_t primitive)
+{
+  ShaderDebugTrace *ret = NULL;
 
-    ret = debugger->BeginDebug(apiWrapper, ShaderStage::Pixel, entryPoint, spec,
-                               shadRefl.instructionLines, shadRefl.patchData, destIdx);
-    apiWrapper->ResetReplay();
-  }
-  else
+  DebugPixelRect(eventId, x, y, 1, 1, sample, primitive,
+                 [&ret](uint32_t, uint32_t, ShaderDebugTrace *trace) {
+                   // the draw is replayed once the pixel is debugged, so the resources will need
+                   // to be replayed back before the draw when they're next fetched
+                   rdcspv::Debugger *debugger = (rdcspv::Debugger *)trace->debugger;
+                   ((VulkanAPIWrapper *)debugger->GetAPIWrapper())->MarkResourcesDirty();
+                   ret = trace;
+                 });
+
+  if(ret == NULL)
   {
     RDCLOG("Didn't get any valid hit to debug");
-    delete apiWrapper;
 
     ret = new ShaderDebugTrace;
     ret->stage = ShaderStage::Pixel;
   }
 
-  if(descpool != VK_NULL_HANDLE)
-  {
-    // delete descriptors. Technically we don't have to free the descriptor sets, but our tracking
-    // on replay doesn't handle destroying children of pooled objects so we do it explicitly anyway.
-    m_pDriver->vkFreeDescriptorSets(dev, descpool, (uint32_t)descSets.size(), descSets.data());
-
-    m_pDriver->vkDestroyDescriptorPool(dev, descpool, NULL);
-  }
-
-  for(VkDescriptorSetLayout layout : setLayouts)
-    m_pDriver->vkDestroyDescriptorSetLayout(dev, layout, NULL);
+  return ret;
+}
 
-  // delete pipeline layout
-  m_pDriver->vkDestroyPipelineLayout(dev, pipeLayout, NULL);
+rdcarray<PixelDebugSummary> VulkanReplay::DebugPixels(uint32_t eventId, uint32_t x, uint32_t y,
+                                                      uint32_t width, uint32_t height,
+                                                      uint32_t sample, uint32_t primitive)
+{
+  rdcarray<PixelDebugSummary> ret = PrepareDebugPixelSummaries(x, y, width, height);
 
-  // delete pipeline
-  m_pDriver->vkDestroyPipeline(dev, inputsPipe, NULL);
+  if(ret.empty())
+    return ret;
 
-  // delete shader modules
-  for(VkShaderModule s : modules)
-    m_pDriver->vkDestroyShaderModule(dev, s, NULL);
+  DebugPixelRect(eventId, x, y, width, height, sample, primitive,
+                 [this, &ret, x, y, width](uint32_t px, uint32_t py, ShaderDebugTrace *trace) {
+                   SummariseDebugTrace(this, trace, ret[(py - y) * width + (px - x)]);
+                 });
 
   return ret;
 }
@@ -4712,6 +4813,12 @@ rdcarray<ShaderDebugState> VulkanReplay::ContinueDebug(ShaderDebugger *debugger)
   return ret;
 }
 
+rdcarray<ShaderDebugState> VulkanReplay::ContinueDebugToCondition(
+    ShaderDebugger *debugger, const ShaderDebugStopCondition &condition)
+{
+  return ContinueDebugUntil(this, debugger, condition);
+}
+
 void VulkanReplay::FreeDebugger(ShaderDebugger *debugger)
 {
   delete debugger;
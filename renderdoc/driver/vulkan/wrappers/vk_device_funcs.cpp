@@ -903,6 +903,7 @@ void WrappedVulkan::Shutdown()
   // destroy debug manager and any objects it created
   SAFE_DELETE(m_DebugManager);
   SAFE_DELETE(m_ShaderCache);
+  m_CreationInfo.m_ReflectionCache = NULL;
 
   if(m_Instance && ObjDisp(m_Instance)->DestroyDebugReportCallbackEXT &&
      m_DbgReportCallback != VK_NULL_HANDLE)
@@ -3332,6 +3333,8 @@ bool WrappedVulkan::Serialise_vkCreateDevice(SerialiserType &ser, VkPhysicalDevi
 
     m_ShaderCache = new VulkanShaderCache(this);
 
+    m_CreationInfo.m_ReflectionCache = m_ShaderCache->GetReflectionCache();
+
     m_DebugManager = new VulkanDebugManager(this);
 
     m_Replay->CreateResources();
@@ -30,6 +30,10 @@
 #include "common/common.h"
 #include "os/os_specific.h"
 
+#if ENABLED(RDOC_SSE2)
+#include <emmintrin.h>
+#endif
+
 //	for(int i=0; i < 256; i++)
 //	{
 //		uint8_t comp = i&0xff;
@@ -814,6 +818,298 @@ void EncodeFormattedComponents(const ResourceFormat &fmt, FloatVector v, byte *d
   }
 }
 
+// the span functions below pick a kernel once for the format then run it over every texel. Only
+// common formats get a dedicated kernel, anything else falls back to the per-texel functions.
+// Each kernel must produce exactly the same results as the per-texel path.
+
+typedef void (*DecodeSpanKernel)(const byte *data, size_t stride, size_t count, FloatVector *out);
+typedef void (*EncodeSpanKernel)(const FloatVector *in, size_t count, byte *data, size_t stride);
+
+template <uint32_t compCount>
+static void DecodeSpanFloat32(const byte *data, size_t stride, size_t count, FloatVector *out)
+{
+  for(size_t i = 0; i < count; i++, data += stride)
+  {
+    FloatVector v(0.0f, 0.0f, 0.0f, 1.0f);
+    memcpy(&v.x, data, sizeof(float) * compCount);
+    out[i] = v;
+  }
+}
+
+template <uint32_t compCount>
+static void DecodeSpanFloat16(const byte *data, size_t stride, size_t count, FloatVector *out)
+{
+  for(size_t i = 0; i < count; i++, data += stride)
+  {
+    uint16_t halves[compCount];
+    memcpy(halves, data, sizeof(halves));
+
+    FloatVector v(0.0f, 0.0f, 0.0f, 1.0f);
+    float *comp = &v.x;
+    for(uint32_t c = 0; c < compCount; c++)
+      comp[c] = ConvertFromHalf(halves[c]);
+    out[i] = v;
+  }
+}
+
+template <uint32_t compCount, bool srgb, bool bgra>
+static void DecodeSpanUNorm8(const byte *data, size_t stride, size_t count, FloatVector *out)
+{
+  size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  if(compCount == 4 && !srgb)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(255.0f);
+
+    for(; i < count; i++, data += stride)
+    {
+      uint32_t packed;
+      memcpy(&packed, data, sizeof(packed));
+
+      __m128i ints = _mm_cvtsi32_si128(int(packed));
+      ints = _mm_unpacklo_epi8(ints, zero);
+      ints = _mm_unpacklo_epi16(ints, zero);
+
+      // a true divide rather than multiplying by the reciprocal, to match the scalar path exactly
+      __m128 floats = _mm_div_ps(_mm_cvtepi32_ps(ints), scale);
+      if(bgra)
+        floats = _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(3, 0, 1, 2));
+
+      _mm_storeu_ps(&out[i].x, floats);
+    }
+  }
+#endif
+
+  for(; i < count; i++, data += stride)
+  {
+    FloatVector v(0.0f, 0.0f, 0.0f, 1.0f);
+    float *comp = &v.x;
+    for(uint32_t c = 0; c < compCount; c++)
+    {
+      // alpha is never interpreted as sRGB
+      if(srgb && c < 3)
+        comp[c] = SRGB8_lookuptable[data[c]];
+      else
+        comp[c] = float(data[c]) / 255.0f;
+    }
+
+    if(bgra)
+      std::swap(v.x, v.z);
+
+    out[i] = v;
+  }
+}
+
+template <bool bgra>
+static void DecodeSpanR10G10B10A2(const byte *data, size_t stride, size_t count, FloatVector *out)
+{
+  for(size_t i = 0; i < count; i++, data += stride)
+  {
+    uint32_t packed;
+    memcpy(&packed, data, sizeof(packed));
+
+    Vec4f v = ConvertFromR10G10B10A2(packed);
+    out[i] = bgra ? FloatVector(v.z, v.y, v.x, v.w) : FloatVector(v.x, v.y, v.z, v.w);
+  }
+}
+
+static void DecodeSpanR11G11B10(const byte *data, size_t stride, size_t count, FloatVector *out)
+{
+  for(size_t i = 0; i < count; i++, data += stride)
+  {
+    uint32_t packed;
+    memcpy(&packed, data, sizeof(packed));
+
+    Vec3f v = ConvertFromR11G11B10(packed);
+    out[i] = FloatVector(v.x, v.y, v.z, 1.0f);
+  }
+}
+
+template <uint32_t compCount>
+static void EncodeSpanFloat32(const FloatVector *in, size_t count, byte *data, size_t stride)
+{
+  for(size_t i = 0; i < count; i++, data += stride)
+    memcpy(data, &in[i].x, sizeof(float) * compCount);
+}
+
+template <uint32_t compCount>
+static void EncodeSpanFloat16(const FloatVector *in, size_t count, byte *data, size_t stride)
+{
+  for(size_t i = 0; i < count; i++, data += stride)
+  {
+    uint16_t halves[compCount];
+    const float *comp = &in[i].x;
+    for(uint32_t c = 0; c < compCount; c++)
+      halves[c] = ConvertToHalf(comp[c]);
+    memcpy(data, halves, sizeof(halves));
+  }
+}
+
+template <uint32_t compCount, bool srgb>
+static void EncodeSpanUNorm8(const FloatVector *in, size_t count, byte *data, size_t stride)
+{
+  size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  if(compCount == 4 && !srgb)
+  {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(float(0xff));
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for(; i < count; i++, data += stride)
+    {
+      __m128 floats = _mm_loadu_ps(&in[i].x);
+      floats = _mm_min_ps(_mm_max_ps(floats, zero), one);
+      floats = _mm_add_ps(_mm_mul_ps(floats, scale), half);
+
+      // truncate like the scalar cast, then narrow 32-bit -> 16-bit -> 8-bit. Values are already
+      // in [0, 255] so the saturating packs don't change anything.
+      __m128i ints = _mm_cvttps_epi32(floats);
+      ints = _mm_packs_epi32(ints, ints);
+      ints = _mm_packus_epi16(ints, ints);
+
+      uint32_t packed = uint32_t(_mm_cvtsi128_si32(ints));
+      memcpy(data, &packed, sizeof(packed));
+    }
+  }
+#endif
+
+  for(; i < count; i++, data += stride)
+  {
+    const float *comp = &in[i].x;
+    for(uint32_t c = 0; c < compCount; c++)
+    {
+      // alpha is never interpreted as sRGB
+      if(srgb && c < 3)
+        data[c] = uint8_t(ConvertLinearToSRGB(comp[c]) * float(0xff) + 0.5f);
+      else
+        data[c] = uint8_t(RDCCLAMP(comp[c], 0.0f, 1.0f) * float(0xff) + 0.5f);
+    }
+  }
+}
+
+#define SPAN_KERNEL_BY_COUNT(kernel, ...)     \
+  switch(fmt.compCount)                       \
+  {                                           \
+    case 1: return &kernel<1, ##__VA_ARGS__>; \
+    case 2: return &kernel<2, ##__VA_ARGS__>; \
+    case 3: return &kernel<3, ##__VA_ARGS__>; \
+    case 4: return &kernel<4, ##__VA_ARGS__>; \
+    default: return NULL;                     \
+  }
+
+static DecodeSpanKernel GetDecodeSpanKernel(const ResourceFormat &fmt)
+{
+  if(fmt.type == ResourceFormatType::R10G10B10A2 && fmt.compType == CompType::UNorm)
+  {
+    if(fmt.BGRAOrder())
+      return &DecodeSpanR10G10B10A2<true>;
+    return &DecodeSpanR10G10B10A2<false>;
+  }
+
+  if(fmt.type == ResourceFormatType::R11G11B10)
+    return &DecodeSpanR11G11B10;
+
+  // BGRA order only changes anything for the 8-bit kernels
+  if(fmt.type != ResourceFormatType::Regular || (fmt.BGRAOrder() && fmt.compByteWidth != 1))
+    return NULL;
+
+  if(fmt.compByteWidth == 4 && (fmt.compType == CompType::Float || fmt.compType == CompType::Depth))
+  {
+    SPAN_KERNEL_BY_COUNT(DecodeSpanFloat32);
+  }
+  else if(fmt.compByteWidth == 2 && fmt.compType == CompType::Float)
+  {
+    SPAN_KERNEL_BY_COUNT(DecodeSpanFloat16);
+  }
+  else if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNorm)
+  {
+    if(fmt.BGRAOrder())
+    {
+      SPAN_KERNEL_BY_COUNT(DecodeSpanUNorm8, false, true);
+    }
+    SPAN_KERNEL_BY_COUNT(DecodeSpanUNorm8, false, false);
+  }
+  else if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNormSRGB)
+  {
+    if(fmt.BGRAOrder())
+    {
+      SPAN_KERNEL_BY_COUNT(DecodeSpanUNorm8, true, true);
+    }
+    SPAN_KERNEL_BY_COUNT(DecodeSpanUNorm8, true, false);
+  }
+
+  return NULL;
+}
+
+static EncodeSpanKernel GetEncodeSpanKernel(const ResourceFormat &fmt)
+{
+  // the per-texel encoder doesn't swizzle regular formats for BGRA order, so neither do we
+  if(fmt.type != ResourceFormatType::Regular)
+    return NULL;
+
+  if(fmt.compByteWidth == 4 && (fmt.compType == CompType::Float || fmt.compType == CompType::Depth))
+  {
+    SPAN_KERNEL_BY_COUNT(EncodeSpanFloat32);
+  }
+  else if(fmt.compByteWidth == 2 && fmt.compType == CompType::Float)
+  {
+    SPAN_KERNEL_BY_COUNT(EncodeSpanFloat16);
+  }
+  else if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNorm)
+  {
+    SPAN_KERNEL_BY_COUNT(EncodeSpanUNorm8, false);
+  }
+  else if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNormSRGB)
+  {
+    SPAN_KERNEL_BY_COUNT(EncodeSpanUNorm8, true);
+  }
+
+  return NULL;
+}
+
+#undef SPAN_KERNEL_BY_COUNT
+
+void DecodeFormattedComponentsSpan(const ResourceFormat &fmt, const byte *data, size_t stride,
+                                   size_t count, FloatVector *out, bool *success)
+{
+  if(success)
+    *success = true;
+
+  DecodeSpanKernel kernel = GetDecodeSpanKernel(fmt);
+
+  if(kernel)
+  {
+    kernel(data, stride, count, out);
+    return;
+  }
+
+  for(size_t i = 0; i < count; i++, data += stride)
+    out[i] = DecodeFormattedComponents(fmt, data, success);
+}
+
+void EncodeFormattedComponentsSpan(const ResourceFormat &fmt, const FloatVector *in, size_t count,
+                                   byte *data, size_t stride, bool *success)
+{
+  if(success)
+    *success = true;
+
+  EncodeSpanKernel kernel = GetEncodeSpanKernel(fmt);
+
+  if(kernel)
+  {
+    kernel(in, count, data, stride);
+    return;
+  }
+
+  for(size_t i = 0; i < count; i++, data += stride)
+    EncodeFormattedComponents(fmt, in[i], data, success);
+}
+
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #undef None
@@ -1548,4 +1844,106 @@ TEST_CASE("Check format conversion", "[format]")
   };
 }
 
+TEST_CASE("Check span conversion matches per-texel conversion", "[format]")
+{
+  // generate some arbitrary but deterministic texel data, including values outside [0, 1] when
+  // interpreted as floats. We avoid NaNs since encoding those isn't well defined.
+  rdcarray<byte> texels;
+  texels.resize(16 * 67);
+  uint32_t seed = 0x1234567;
+  for(byte &b : texels)
+  {
+    seed = seed * 1103515245U + 12345U;
+    b = byte(seed >> 16);
+  }
+
+  // stride deliberately larger than any texel, to check it's respected
+  const size_t stride = 16;
+  const size_t count = texels.size() / stride;
+
+  rdcarray<ResourceFormat> formats;
+
+  for(CompType compType : {CompType::Float, CompType::UNorm, CompType::UNormSRGB})
+  {
+    for(uint8_t byteWidth : {1, 2, 4})
+    {
+      for(uint8_t compCount = 1; compCount <= 4; compCount++)
+      {
+        ResourceFormat fmt;
+        fmt.type = ResourceFormatType::Regular;
+        fmt.compType = compType;
+        fmt.compByteWidth = byteWidth;
+        fmt.compCount = compCount;
+        formats.push_back(fmt);
+
+        if(byteWidth == 1 && compCount >= 3)
+        {
+          fmt.SetBGRAOrder(true);
+          formats.push_back(fmt);
+        }
+      }
+    }
+  }
+
+  {
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::R10G10B10A2;
+    fmt.compType = CompType::UNorm;
+    fmt.compCount = 4;
+    formats.push_back(fmt);
+    fmt.SetBGRAOrder(true);
+    formats.push_back(fmt);
+    fmt.SetBGRAOrder(false);
+    fmt.compType = CompType::UInt;
+    formats.push_back(fmt);
+
+    fmt.type = ResourceFormatType::R11G11B10;
+    fmt.compType = CompType::Float;
+    fmt.compCount = 3;
+    formats.push_back(fmt);
+  }
+
+  for(const ResourceFormat &fmt : formats)
+  {
+    INFO("Format " << fmt.Name().c_str() << (fmt.BGRAOrder() ? " BGRA" : ""));
+
+    rdcarray<FloatVector> decoded;
+    decoded.resize(count);
+
+    bool spanSuccess = false, texelSuccess = false;
+    DecodeFormattedComponentsSpan(fmt, texels.data(), stride, count, decoded.data(), &spanSuccess);
+
+    for(size_t i = 0; i < count; i++)
+    {
+      FloatVector expected = DecodeFormattedComponents(fmt, texels.data() + i * stride, &texelSuccess);
+      // compare bitwise so that we catch even the smallest differences, and infinities
+      CHECK(memcmp(&decoded[i], &expected, sizeof(FloatVector)) == 0);
+    }
+
+    CHECK(spanSuccess == texelSuccess);
+
+    // encode values in a sensible range since out of range inputs aren't well defined for all
+    // formats (e.g. negative values to sRGB)
+    for(FloatVector &v : decoded)
+    {
+      float *comp = &v.x;
+      for(int c = 0; c < 4; c++)
+        comp[c] = RDCCLAMP(comp[c] == comp[c] ? comp[c] : 0.0f, 0.0f, 1.0f);
+    }
+
+    rdcarray<byte> spanEncoded, texelEncoded;
+    spanEncoded.resize(texels.size());
+    texelEncoded.resize(texels.size());
+
+    EncodeFormattedComponentsSpan(fmt, decoded.data(), count, spanEncoded.data(), stride,
+                                  &spanSuccess);
+
+    for(size_t i = 0; i < count; i++)
+      EncodeFormattedComponents(fmt, decoded[i], texelEncoded.data() + i * stride, &texelSuccess);
+
+    CHECK(spanSuccess == texelSuccess);
+    CHECK(spanEncoded == texelEncoded);
+  }
+}
+
 #endif
@@ -182,3 +182,11 @@ FloatVector DecodeFormattedComponents(const ResourceFormat &fmt, const byte *dat
                                       bool *success = NULL);
 void EncodeFormattedComponents(const ResourceFormat &fmt, FloatVector v, byte *data,
                                bool *success = NULL);
+
+// convert a run of count texels, stride bytes apart in the packed data. Results are identical to
+// calling the functions above per-texel, but the format is only dispatched once and common formats
+// use dedicated kernels, so prefer these for whole rows or images.
+void DecodeFormattedComponentsSpan(const ResourceFormat &fmt, const byte *data, size_t stride,
+                                   size_t count, FloatVector *out, bool *success = NULL);
+void EncodeFormattedComponentsSpan(const ResourceFormat &fmt, const FloatVector *in, size_t count,
+                                   byte *data, size_t stride, bool *success = NULL);
@@ -616,6 +616,45 @@ TEST_CASE("Test OS-specific functions", "[osspecific]")
     CHECK(ip == Network::MakeIP(216, 58, 211, 174));
     CHECK(mask == 0xFFFFFFFe);
   };
+
+  SECTION("File watching")
+  {
+    rdcstr filename = FileIO::GetTempFolderFilename() + "filewatch.txt";
+    rdcstr otherFilename = FileIO::GetTempFolderFilename() + "filewatch_other.txt";
+    rdcstr tempFilename = FileIO::GetTempFolderFilename() + "filewatch.tmp";
+
+    REQUIRE(FileIO::WriteAll(filename, "foo"));
+
+    FileIO::FileWatchHandle *watch = FileIO::filewatch_open(filename);
+
+// platforms without a native implementation always report changes
+#if ENABLED(RDOC_LINUX)
+    REQUIRE(watch != NULL);
+    CHECK_FALSE(FileIO::filewatch_changed(watch));
+
+    // changes to other files in the same directory don't count
+    REQUIRE(FileIO::WriteAll(otherFilename, "bar"));
+    CHECK_FALSE(FileIO::filewatch_changed(watch));
+#endif
+
+    REQUIRE(FileIO::WriteAll(filename, "foobar"));
+    CHECK(FileIO::filewatch_changed(watch));
+
+#if ENABLED(RDOC_LINUX)
+    // the change is only reported once
+    CHECK_FALSE(FileIO::filewatch_changed(watch));
+#endif
+
+    // replacing the file by renaming over it is also a change
+    REQUIRE(FileIO::WriteAll(tempFilename, "baz"));
+    REQUIRE(FileIO::Move(tempFilename.c_str(), filename.c_str(), true));
+    CHECK(FileIO::filewatch_changed(watch));
+
+    FileIO::filewatch_close(watch);
+
+    FileIO::Delete(filename.c_str());
+    FileIO::Delete(otherFilename.c_str());
+  };
 };
 
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
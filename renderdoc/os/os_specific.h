@@ -137,6 +137,25 @@ public:
   data m_Data;
 };
 
+template <class data, class lock>
+class ConditionVariableTemplate
+{
+public:
+  ConditionVariableTemplate();
+  ~ConditionVariableTemplate();
+
+  // the lock must be held exactly once by the calling thread. It's released while waiting and
+  // re-acquired before returning. Wakeups can be spurious, so re-check the condition afterwards.
+  void Wait(lock &cs);
+  void WakeAll();
+
+  // no copying
+  ConditionVariableTemplate &operator=(const ConditionVariableTemplate &other) = delete;
+  ConditionVariableTemplate(const ConditionVariableTemplate &other) = delete;
+
+  data m_Data;
+};
+
 void Init();
 void Shutdown();
 uint64_t AllocateTLSSlot();
@@ -145,6 +164,7 @@ void *GetTLSValue(uint64_t slot);
 void SetTLSValue(uint64_t slot, void *value);
 
 // must typedef CriticalSectionTemplate<X> CriticalSection
+// and ConditionVariableTemplate<X, CriticalSection> ConditionVariable
 
 void SetCurrentThreadName(const rdcstr &name);
 
@@ -155,6 +175,7 @@ void JoinThread(ThreadHandle handle);
 void DetachThread(ThreadHandle handle);
 void CloseThread(ThreadHandle handle);
 void Sleep(uint32_t milliseconds);
+uint32_t GetNumberOfCores();
 
 // kind of windows specific, to handle this case:
 // http://blogs.msdn.com/b/oldnewthing/archive/2013/11/05/10463645.aspx
@@ -330,6 +351,27 @@ void logfile_close(LogFileHandle *logHandle, const char *deleteFilename);
 // may fail on the shared logfile
 rdcstr logfile_readall(uint64_t offset, const char *filename);
 
+// functions for watching a file for changes on disk. filewatch_changed never blocks, and returns
+// true if the file has been written, replaced or deleted since the watch was opened or last
+// checked. Platforms that can't tell always return true, as does a NULL watch.
+struct FileWatchHandle;
+FileWatchHandle *filewatch_open(const rdcstr &filename);
+bool filewatch_changed(FileWatchHandle *watch);
+void filewatch_close(FileWatchHandle *watch);
+
+// functions for mapping an open file into memory. fmap maps the whole file copy-on-write, so the
+// memory can be modified without the file changing, and sets length to its size. A file that may
+// be truncated by another program while it's mapped shouldn't be mapped, as reading past the new
+// end would fault. fmap_write resizes a file that's open for reading and writing to length bytes,
+// allocating the space on disk, and maps it so that writes to the memory go to the file.
+// Both return NULL on failure, and the file can then be read or written normally. fmap_flush
+// writes the memory back to the file and returns false if that failed. A mapping stays valid after
+// the file is closed, until funmap.
+byte *fmap(FILE *f, uint64_t &length);
+byte *fmap_write(FILE *f, uint64_t length);
+bool fmap_flush(byte *ptr, uint64_t length);
+void funmap(byte *ptr, uint64_t length);
+
 // utility functions
 inline bool WriteAll(const rdcstr &filename, const void *buffer, size_t size)
 {
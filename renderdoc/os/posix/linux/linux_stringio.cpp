@@ -29,6 +29,7 @@
 #include <pwd.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/inotify.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -712,6 +713,92 @@ void GetLibraryFilename(rdcstr &selfName)
 
   selfName = librenderdoc_path;
 }
+
+struct FileWatchHandle
+{
+  int fd = -1;
+  rdcstr name;
+};
+
+FileWatchHandle *filewatch_open(const rdcstr &filename)
+{
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if(fd < 0)
+  {
+    RDCWARN("Couldn't initialise inotify to watch '%s': %d", filename.c_str(), (int)errno);
+    return NULL;
+  }
+
+  // watch the directory rather than the file itself, since many tools write to a temporary file
+  // and rename it over the original, which would leave a watch on the file pointing at the old
+  // inode.
+  rdcstr dir = get_dirname(filename);
+
+  int wd = inotify_add_watch(fd, dir.c_str(),
+                             IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+
+  if(wd < 0)
+  {
+    RDCWARN("Couldn't add inotify watch on '%s': %d", dir.c_str(), (int)errno);
+    close(fd);
+    return NULL;
+  }
+
+  FileWatchHandle *ret = new FileWatchHandle;
+  ret->fd = fd;
+  ret->name = get_basename(filename);
+  return ret;
+}
+
+bool filewatch_changed(FileWatchHandle *watch)
+{
+  if(watch == NULL || watch->fd < 0)
+    return true;
+
+  bool changed = false;
+
+  alignas(inotify_event) char buf[4096];
+
+  // drain all pending events. The fd is non-blocking so this stops with EAGAIN once it's empty
+  for(;;)
+  {
+    ssize_t len = read(watch->fd, buf, sizeof(buf));
+
+    if(len <= 0)
+      break;
+
+    for(ssize_t offs = 0; offs < len;)
+    {
+      const inotify_event *ev = (const inotify_event *)(buf + offs);
+
+      // if the directory itself went away the watch is removed, so we can't tell anything more
+      if(ev->mask & IN_IGNORED)
+      {
+        close(watch->fd);
+        watch->fd = -1;
+        return true;
+      }
+
+      // if events were dropped we can't tell what happened
+      if(ev->mask & IN_Q_OVERFLOW)
+        changed = true;
+      else if(ev->len > 0 && watch->name == ev->name)
+        changed = true;
+
+      offs += sizeof(inotify_event) + ev->len;
+    }
+  }
+
+  return changed;
+}
+
+void filewatch_close(FileWatchHandle *watch)
+{
+  if(watch && watch->fd >= 0)
+    close(watch->fd);
+  delete watch;
+}
 };
 
 namespace StringFormat
@@ -105,6 +105,8 @@ struct pthreadRWLockData
   pthread_rwlockattr_t attr;
 };
 typedef RWLockTemplate<pthreadRWLockData> RWLock;
+
+typedef ConditionVariableTemplate<pthread_cond_t, CriticalSection> ConditionVariable;
 };
 
 namespace Bits
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -574,6 +575,89 @@ void logfile_close(LogFileHandle *logHandle, const char *deleteFilename)
     close(fd);
   }
 }
+
+#if DISABLED(RDOC_LINUX)
+// file watching is only implemented with inotify on linux, elsewhere every check reports a change
+FileWatchHandle *filewatch_open(const rdcstr &filename)
+{
+  return NULL;
+}
+
+bool filewatch_changed(FileWatchHandle *watch)
+{
+  return true;
+}
+
+void filewatch_close(FileWatchHandle *watch)
+{
+}
+#endif
+
+byte *fmap(FILE *f, uint64_t &length)
+{
+  ::fflush(f);
+  int fd = ::fileno(f);
+
+  struct stat st = {};
+  if(::fstat(fd, &st) != 0 || st.st_size <= 0 || uint64_t(st.st_size) > SIZE_MAX)
+    return NULL;
+
+  void *ret = ::mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if(ret == MAP_FAILED)
+    return NULL;
+
+  length = (uint64_t)st.st_size;
+  return (byte *)ret;
+}
+
+byte *fmap_write(FILE *f, uint64_t length)
+{
+  if(length == 0 || length > SIZE_MAX)
+    return NULL;
+
+  ::fflush(f);
+  int fd = ::fileno(f);
+
+  struct stat st = {};
+  if(::fstat(fd, &st) != 0)
+    return NULL;
+
+  // map before resizing, so that a file we can't map (e.g. one only open for writing) is untouched
+  void *ret = ::mmap(NULL, (size_t)length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(ret == MAP_FAILED)
+    return NULL;
+
+  // the space has to be allocated up front rather than just resizing the file. A sparse file would
+  // only allocate as pages are stored to, and if the disk filled up then we'd get SIGBUS.
+#if ENABLED(RDOC_APPLE)
+  // there's no posix_fallocate, so let the caller write the file instead
+  int err = ENOTSUP;
+#else
+  int err = ::posix_fallocate(fd, 0, (off_t)length);
+#endif
+
+  if(err != 0)
+  {
+    ::munmap(ret, (size_t)length);
+    // posix_fallocate can have partly extended the file before failing
+    if(::ftruncate(fd, st.st_size) != 0)
+      RDCWARN("Couldn't restore file size after failing to allocate: %d", (int)errno);
+    return NULL;
+  }
+
+  return (byte *)ret;
+}
+
+bool fmap_flush(byte *ptr, uint64_t length)
+{
+  return ptr && ::msync(ptr, (size_t)length, MS_SYNC) == 0;
+}
+
+void funmap(byte *ptr, uint64_t length)
+{
+  if(ptr)
+    ::munmap(ptr, (size_t)length);
+}
 };
 
 namespace StringFormat
@@ -157,6 +157,30 @@ void RWLock::ReadUnlock()
   pthread_rwlock_unlock(&m_Data.rwlock);
 }
 
+template <>
+ConditionVariable::ConditionVariableTemplate()
+{
+  pthread_cond_init(&m_Data, NULL);
+}
+
+template <>
+ConditionVariable::~ConditionVariableTemplate()
+{
+  pthread_cond_destroy(&m_Data);
+}
+
+template <>
+void ConditionVariable::Wait(CriticalSection &cs)
+{
+  pthread_cond_wait(&m_Data, &cs.m_Data.lock);
+}
+
+template <>
+void ConditionVariable::WakeAll()
+{
+  pthread_cond_broadcast(&m_Data);
+}
+
 struct ThreadInitData
 {
   std::function<void()> entryFunc;
@@ -303,4 +327,10 @@ void Sleep(uint32_t milliseconds)
 {
   usleep(milliseconds * 1000);
 }
+
+uint32_t GetNumberOfCores()
+{
+  long ret = sysconf(_SC_NPROCESSORS_ONLN);
+  return ret > 0 ? (uint32_t)ret : 1;
+}
 };
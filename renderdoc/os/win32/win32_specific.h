@@ -64,6 +64,7 @@ namespace Threading
 {
 typedef CriticalSectionTemplate<CRITICAL_SECTION> CriticalSection;
 typedef RWLockTemplate<SRWLOCK> RWLock;
+typedef ConditionVariableTemplate<CONDITION_VARIABLE, CriticalSection> ConditionVariable;
 };
 
 namespace Bits
@@ -768,6 +768,97 @@ void logfile_close(LogFileHandle *logHandle, const char *deleteFilename)
     ::DeleteFileW(wpath.c_str());
   }
 }
+
+// file watching isn't implemented here, so every check reports a change
+FileWatchHandle *filewatch_open(const rdcstr &filename)
+{
+  return NULL;
+}
+
+bool filewatch_changed(FileWatchHandle *watch)
+{
+  return true;
+}
+
+void filewatch_close(FileWatchHandle *watch)
+{
+}
+
+byte *fmap(FILE *f, uint64_t &length)
+{
+  ::fflush(f);
+  HANDLE file = (HANDLE)::_get_osfhandle(::_fileno(f));
+
+  LARGE_INTEGER size = {};
+  if(file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+     uint64_t(size.QuadPart) > SIZE_MAX)
+    return NULL;
+
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  if(mapping == NULL)
+    return NULL;
+
+  // the view keeps the mapping object alive until it's unmapped
+  void *ret = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  CloseHandle(mapping);
+
+  if(ret == NULL)
+    return NULL;
+
+  length = (uint64_t)size.QuadPart;
+  return (byte *)ret;
+}
+
+byte *fmap_write(FILE *f, uint64_t length)
+{
+  if(length == 0 || length > SIZE_MAX)
+    return NULL;
+
+  ::fflush(f);
+  HANDLE file = (HANDLE)::_get_osfhandle(::_fileno(f));
+
+  LARGE_INTEGER size = {};
+  if(file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size))
+    return NULL;
+
+  // set the end of the file ourselves rather than letting the mapping extend it. The space for a
+  // file that isn't sparse is allocated here, so a full disk fails now instead of raising an
+  // exception when the view is written to.
+  FILE_END_OF_FILE_INFO eof = {};
+  eof.EndOfFile.QuadPart = (LONGLONG)length;
+  if(!SetFileInformationByHandle(file, FileEndOfFileInfo, &eof, sizeof(eof)))
+    return NULL;
+
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READWRITE, DWORD(length >> 32),
+                                      DWORD(length & 0xffffffff), NULL);
+
+  void *ret = NULL;
+  if(mapping)
+  {
+    ret = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)length);
+    CloseHandle(mapping);
+  }
+
+  // leave a file we can't map (e.g. one only open for writing) the size it was
+  if(ret == NULL)
+  {
+    eof.EndOfFile = size;
+    SetFileInformationByHandle(file, FileEndOfFileInfo, &eof, sizeof(eof));
+  }
+
+  return (byte *)ret;
+}
+
+bool fmap_flush(byte *ptr, uint64_t length)
+{
+  return ptr && FlushViewOfFile(ptr, (SIZE_T)length) == TRUE;
+}
+
+void funmap(byte *ptr, uint64_t length)
+{
+  if(ptr)
+    UnmapViewOfFile(ptr);
+}
 };
 
 namespace StringFormat
@@ -151,6 +151,25 @@ void RWLock::ReadUnlock()
   ReleaseSRWLockShared(&m_Data);
 }
 
+ConditionVariable::ConditionVariableTemplate()
+{
+  InitializeConditionVariable(&m_Data);
+}
+
+ConditionVariable::~ConditionVariableTemplate()
+{
+}
+
+void ConditionVariable::Wait(CriticalSection &cs)
+{
+  SleepConditionVariableCS(&m_Data, &cs.m_Data, INFINITE);
+}
+
+void ConditionVariable::WakeAll()
+{
+  WakeAllConditionVariable(&m_Data);
+}
+
 struct ThreadInitData
 {
   std::function<void()> entryFunc;
@@ -355,4 +374,11 @@ void Sleep(uint32_t milliseconds)
 {
   ::Sleep((DWORD)milliseconds);
 }
+
+uint32_t GetNumberOfCores()
+{
+  SYSTEM_INFO info = {};
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors : 1;
+}
 };
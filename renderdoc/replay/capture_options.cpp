@@ -184,4 +184,5 @@ CaptureOptions::CaptureOptions()
   refAllResources = false;
   captureAllCmdLists = false;
   debugOutputMute = true;
+  captureSizeBudgetMB = 0;
 }
@@ -27,12 +27,14 @@
 #include "api/replay/renderdoc_replay.h"
 #include "api/replay/version.h"
 #include "common/common.h"
+#include "common/job_queue.h"
 #include "common/formatting.h"
 #include "core/core.h"
 #include "maths/camera.h"
 #include "maths/formatpacking.h"
 #include "miniz/miniz.h"
 #include "replay/replay_driver.h"
+#include "replay/texture_stats.h"
 #include "strings/string_utils.h"
 #include "superluminal/superluminal.h"
 
@@ -168,6 +170,20 @@ extern "C" RENDERDOC_API uint16_t RENDERDOC_CC RENDERDOC_FloatToHalf(float f)
   return ConvertToHalf(f);
 }
 
+extern "C" RENDERDOC_API TextureComparison RENDERDOC_CC RENDERDOC_CompareTextureData(
+    const ResourceFormat &formatA, const bytebuf &dataA, const ResourceFormat &formatB,
+    const bytebuf &dataB, uint32_t width, uint32_t height, uint32_t depth, float threshold,
+    bool diffImage)
+{
+  TextureComparison ret;
+
+  Threading::JobQueue jobs;
+  CompareTextureData(formatA, dataA.data(), dataA.size(), formatB, dataB.data(), dataB.size(),
+                     width, height, depth, threshold, diffImage, ret, &jobs);
+
+  return ret;
+}
+
 extern "C" RENDERDOC_API ICamera *RENDERDOC_CC RENDERDOC_InitCamera(CameraType type)
 {
   return new Camera(type);
@@ -111,8 +111,9 @@ void DoSerialise(SerialiserType &ser, CaptureOptions &el)
   SERIALISE_MEMBER(refAllResources);
   SERIALISE_MEMBER(captureAllCmdLists);
   SERIALISE_MEMBER(debugOutputMute);
+  SERIALISE_MEMBER(captureSizeBudgetMB);
 
-  SIZE_CHECK(20);
+  SIZE_CHECK(24);
 }
 
 template <typename SerialiserType>
@@ -398,6 +399,17 @@ void DoSerialise(SerialiserType &ser, ShaderDebugState &el)
   SIZE_CHECK(88);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ShaderDebugStopCondition &el)
+{
+  SERIALISE_MEMBER(instructions);
+  SERIALISE_MEMBER(events);
+  SERIALISE_MEMBER(watchVariables);
+  SERIALISE_MEMBER(maxSteps);
+
+  SIZE_CHECK(64);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, ShaderDebugTrace &el)
 {
@@ -421,6 +433,21 @@ void DoSerialise(SerialiserType &ser, ShaderDebugTrace &el)
   SIZE_CHECK(184);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, PixelDebugSummary &el)
+{
+  SERIALISE_MEMBER(x);
+  SERIALISE_MEMBER(y);
+  SERIALISE_MEMBER(numSteps);
+  SERIALISE_MEMBER(firstNaNStep);
+  SERIALISE_MEMBER(firstNaNInstruction);
+  SERIALISE_MEMBER(debugged);
+  SERIALISE_MEMBER(firstNaNVariable);
+  SERIALISE_MEMBER(outputs);
+
+  SIZE_CHECK(72);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, TextureFilter &el)
 {
@@ -2297,7 +2324,9 @@ INSTANTIATE_SERIALISE_TYPE(ShaderReflection)
 INSTANTIATE_SERIALISE_TYPE(ShaderVariable)
 INSTANTIATE_SERIALISE_TYPE(SourceVariableMapping);
 INSTANTIATE_SERIALISE_TYPE(ShaderDebugState)
+INSTANTIATE_SERIALISE_TYPE(ShaderDebugStopCondition)
 INSTANTIATE_SERIALISE_TYPE(ShaderDebugTrace)
+INSTANTIATE_SERIALISE_TYPE(PixelDebugSummary)
 INSTANTIATE_SERIALISE_TYPE(ResourceDescription)
 INSTANTIATE_SERIALISE_TYPE(TextureDescription)
 INSTANTIATE_SERIALISE_TYPE(BufferDescription)
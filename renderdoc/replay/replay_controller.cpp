@@ -24,15 +24,22 @@
  ******************************************************************************/
 
 #include "replay_controller.h"
+#include <ctype.h>
+#include <set>
 #include <string.h>
 #include <time.h>
+#include "common/block_decode.h"
 #include "common/dds_readwrite.h"
+#include "common/job_queue.h"
+#include "common/png_write.h"
+#include "core/settings.h"
 #include "driver/ihv/amd/amd_isa.h"
 #include "driver/ihv/amd/amd_rgp.h"
 #include "jpeg-compressor/jpgd.h"
 #include "jpeg-compressor/jpge.h"
 #include "maths/formatpacking.h"
 #include "os/os_specific.h"
+#include "replay/texture_stats.h"
 #include "serialise/rdcfile.h"
 #include "serialise/serialiser.h"
 #include "stb/stb_image.h"
@@ -40,6 +47,10 @@
 #include "strings/string_utils.h"
 #include "tinyexr/tinyexr.h"
 
+RDOC_CONFIG(bool, Replay_CPUTextureStatistics, false,
+            "Calculate texture min/max and histograms on the CPU from the texture data, rather "
+            "than on the GPU. They are also calculated on the CPU if the GPU calculation fails.");
+
 static void fileWriteFunc(void *context, void *data, int size)
 {
   FileIO::fwrite(data, 1, size, (FILE *)context);
@@ -171,11 +182,106 @@ rdcstr ReplayController::DisassembleShader(ResourceId pipeline, const ShaderRefl
   if(refl == NULL)
     return "; Error: No shader specified";
 
+  return GetCachedDisassembly(pipeline, refl, target).text;
+}
+
+uint32_t ReplayController::GetDisassemblyLineCount(ResourceId pipeline,
+                                                   const ShaderReflection *refl, const char *target)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  if(refl == NULL)
+    return 0;
+
+  return (uint32_t)GetCachedDisassembly(pipeline, refl, target).lineOffsets.size();
+}
+
+rdcstr ReplayController::DisassembleShaderLines(ResourceId pipeline, const ShaderReflection *refl,
+                                                const char *target, uint32_t firstLine,
+                                                uint32_t numLines)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  if(refl == NULL)
+    return "; Error: No shader specified";
+
+  const CachedDisassembly &disasm = GetCachedDisassembly(pipeline, refl, target);
+
+  const size_t lineCount = disasm.lineOffsets.size();
+
+  if(firstLine >= lineCount || numLines == 0)
+    return rdcstr();
+
+  size_t lastLine = RDCMIN(lineCount, (size_t)firstLine + numLines);
+
+  size_t start = disasm.lineOffsets[firstLine];
+  size_t end = lastLine < lineCount ? disasm.lineOffsets[lastLine] : disasm.text.size();
+
+  return disasm.text.substr(start, end - start);
+}
+
+const ReplayController::CachedDisassembly &ReplayController::GetCachedDisassembly(
+    ResourceId pipeline, const ShaderReflection *refl, const char *target)
+{
+  DisassemblyKey key = {pipeline, refl->resourceId, refl->entryPoint, target};
+
+  auto it = m_Disassembly.find(key);
+  if(it != m_Disassembly.end())
+  {
+    it->second.lastUse = ++m_DisassemblyUse;
+    return it->second;
+  }
+
+  CachedDisassembly &disasm = m_Disassembly[key];
+  disasm.lastUse = ++m_DisassemblyUse;
+
+  bool gcn = false;
   for(const rdcstr &t : m_GCNTargets)
+  {
     if(t == target)
-      return GCNISA::Disassemble(refl->encoding, refl->stage, refl->rawBytes, target);
+    {
+      disasm.text = GCNISA::Disassemble(refl->encoding, refl->stage, refl->rawBytes, target);
+      gcn = true;
+      break;
+    }
+  }
+
+  if(!gcn)
+    disasm.text = m_pDevice->DisassembleShader(m_pDevice->GetLiveID(pipeline), refl, target);
+
+  const char *text = disasm.text.c_str();
+  const size_t len = disasm.text.size();
+
+  for(size_t i = 0; i < len; i++)
+  {
+    if(i == 0 || text[i - 1] == '\n')
+      disasm.lineOffsets.push_back(i);
+  }
+
+  m_DisassemblyBytes += disasm.GetSize();
+
+  // evict the least recently used entries to stay within the limit, always keeping the new one
+  while(m_DisassemblyBytes > MaxCachedDisassemblyBytes && m_Disassembly.size() > 1)
+  {
+    auto lru = m_Disassembly.end();
+    for(auto d = m_Disassembly.begin(); d != m_Disassembly.end(); ++d)
+    {
+      if(&d->second == &disasm)
+        continue;
+
+      if(lru == m_Disassembly.end() || d->second.lastUse < lru->second.lastUse)
+        lru = d;
+    }
+
+    m_DisassemblyBytes -= lru->second.GetSize();
+    m_Disassembly.erase(lru);
+  }
 
-  return m_pDevice->DisassembleShader(m_pDevice->GetLiveID(pipeline), refl, target);
+  return disasm;
 }
 
 FrameDescription ReplayController::GetFrameInfo()
@@ -555,11 +661,65 @@ bytebuf ReplayController::GetTextureData(ResourceId tex, const Subresource &sub)
   return ret;
 }
 
-bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path)
+bytebuf ReplayController::GetTextureRegionData(ResourceId tex, const Subresource &sub, uint32_t x,
+                                               uint32_t y, uint32_t z, uint32_t width,
+                                               uint32_t height, uint32_t depth)
 {
   CHECK_REPLAY_THREAD();
   RENDERDOC_PROFILEFUNCTION();
 
+  bytebuf ret;
+
+  ResourceId liveId = m_pDevice->GetLiveID(tex);
+
+  if(liveId == ResourceId())
+  {
+    RDCERR("Couldn't get Live ID for %s getting texture data", ToStr(tex).c_str());
+    return ret;
+  }
+
+  if(width == 0 || height == 0)
+    return ret;
+
+  GetTextureDataParams params;
+  params.region.x = x;
+  params.region.y = y;
+  params.region.z = z;
+  params.region.width = width;
+  params.region.height = height;
+  params.region.depth = RDCMAX(1U, depth);
+
+  m_pDevice->GetTextureData(liveId, sub, params, ret);
+
+  return ret;
+}
+
+// a texture's data fetched from the device along with the settings to save it with, so that
+// converting and encoding it can happen off the replay thread.
+struct TextureSaveData
+{
+  TextureSaveData() = default;
+  TextureSaveData(const TextureSaveData &) = delete;
+  TextureSaveData &operator=(const TextureSaveData &) = delete;
+  ~TextureSaveData()
+  {
+    for(size_t i = 0; i < subdata.size(); i++)
+      delete[] subdata[i];
+  }
+
+  TextureSave sd;
+  TextureDescription td;
+  rdcarray<byte *> subdata;
+  uint32_t rowPitch = 0;
+  uint32_t numMips = 0;
+  uint32_t numSlices = 0;
+  bool singleSlice = false;
+};
+
+bool ReplayController::FetchTextureSave(const TextureSave &saveData, TextureSaveData &out)
+{
+  CHECK_REPLAY_THREAD();
+
   TextureSave sd = saveData;    // mutable copy
   ResourceId liveid = m_pDevice->GetLiveID(sd.resourceId);
 
@@ -571,8 +731,6 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
 
   TextureDescription td = m_pDevice->GetTexture(liveid);
 
-  bool success = false;
-
   // clamp sample/mip/slice indices
   if(td.msSamp == 1)
   {
@@ -757,6 +915,17 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   // if we're downcasting, pick either RGBA8 or RGBA32 to downcast to
   RemapTexture remap = RemapTexture::NoRemap;
 
+  // block-compressed data we can decode ourselves is fetched as-is and decoded here, saving a
+  // remap on the GPU and a much larger transfer if the replay is remote. Casts and black/white
+  // point mapping are only applied by the GPU remap.
+  ResourceFormat blockDecodeFormat;
+  bool blockDecode = downcast && IsBlockDecodeSupported(td.format) &&
+                     sd.typeCast == CompType::Typeless && sd.comp.blackPoint == 0.0f &&
+                     sd.comp.whitePoint == 1.0f;
+
+  if(blockDecode)
+    blockDecodeFormat = td.format;
+
   if(downcast)
   {
     const bool destHDR = (sd.destType == FileType::DDS || sd.destType == FileType::HDR ||
@@ -844,6 +1013,8 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     slicePitch = rowPitch * td.height;
   }
 
+  Threading::JobQueue jobs;
+
   // loop over fetching subresources
   for(uint32_t s = 0; s < numSlices; s++)
   {
@@ -858,7 +1029,7 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       params.standardLayout = true;
       params.typeCast = sd.typeCast;
       params.resolve = resolveSamples;
-      params.remap = remap;
+      params.remap = blockDecode ? RemapTexture::NoRemap : remap;
       params.blackPoint = sd.comp.blackPoint;
       params.whitePoint = sd.comp.whitePoint;
 
@@ -867,6 +1038,22 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       bytebuf data;
       m_pDevice->GetTextureData(liveid, sub, params, data);
 
+      if(blockDecode && !data.empty())
+      {
+        uint32_t w = RDCMAX(1U, td.width >> m);
+        uint32_t h = RDCMAX(1U, td.height >> m);
+        uint32_t d = RDCMAX(1U, td.depth >> m);
+
+        bytebuf decoded;
+        decoded.resize(w * h * d * bytesPerPixel);
+
+        if(DecodeBlockCompressed(blockDecodeFormat, data.data(), data.size(), w, h, d, td.format,
+                                 decoded.data(), &jobs))
+          data.swap(decoded);
+        else
+          data.clear();
+      }
+
       if(data.empty())
       {
         RDCERR("Couldn't get bytes for mip %u, slice %u", mip, slice);
@@ -932,6 +1119,26 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     }
   }
 
+  out.sd = sd;
+  out.td = td;
+  out.subdata.swap(subdata);
+  out.rowPitch = rowPitch;
+  out.numMips = numMips;
+  out.numSlices = numSlices;
+  out.singleSlice = singleSlice;
+
+  return true;
+}
+
+static bool WriteTextureSave(TextureSaveData &data, const char *path, Threading::JobQueue *jobs)
+{
+  TextureSave &sd = data.sd;
+  TextureDescription &td = data.td;
+  rdcarray<byte *> &subdata = data.subdata;
+  uint32_t rowPitch = data.rowPitch;
+
+  bool success = false;
+
   // should have been handled above, but verify incoming data is RGBA8 or RGBA32
   if(sd.slice.slicesAsGrid && (td.format.compByteWidth == 1 || td.format.compByteWidth == 4) &&
      td.format.compCount == 4 && !td.format.Special())
@@ -952,28 +1159,22 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
 
     memset(combinedData, 0, td.width * td.height * pixelStride);
 
-    for(size_t i = 0; i < subdata.size(); i++)
-    {
-      uint32_t gridx = (uint32_t)i % sd.slice.sliceGridWidth;
-      uint32_t gridy = (uint32_t)i / sd.slice.sliceGridWidth;
+    Threading::ParallelFor(jobs, subdata.size(), 1, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++)
+      {
+        uint32_t gridx = (uint32_t)i % sd.slice.sliceGridWidth;
+        uint32_t gridy = (uint32_t)i / sd.slice.sliceGridWidth;
 
-      uint32_t yoffs = gridy * sliceHeight;
-      uint32_t xoffs = gridx * sliceWidth;
+        uint32_t yoffs = gridy * sliceHeight;
+        uint32_t xoffs = gridx * sliceWidth;
 
-      for(uint32_t y = 0; y < sliceHeight; y++)
-      {
-        for(uint32_t x = 0; x < sliceWidth; x++)
-        {
-          uint32_t *srcpix = (uint32_t *)&subdata[i][(y * sliceWidth + x) * pixelStride + 0];
-          uint32_t *dstpix =
-              (uint32_t *)&combinedData[((y + yoffs) * td.width + x + xoffs) * pixelStride + 0];
+        for(uint32_t y = 0; y < sliceHeight; y++)
+          memcpy(&combinedData[((y + yoffs) * td.width + xoffs) * pixelStride],
+                 &subdata[i][y * sliceWidth * pixelStride], sliceWidth * pixelStride);
 
-          memcpy(dstpix, srcpix, pixelStride);
-        }
+        delete[] subdata[i];
       }
-
-      delete[] subdata[i];
-    }
+    });
 
     subdata.resize(1);
     subdata[0] = combinedData;
@@ -1014,31 +1215,29 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     uint32_t gridx[6] = {2, 0, 1, 1, 1, 3};
     uint32_t gridy[6] = {1, 1, 0, 2, 1, 1};
 
-    for(size_t i = 0; i < subdata.size(); i++)
-    {
-      uint32_t yoffs = gridy[i] * sliceHeight;
-      uint32_t xoffs = gridx[i] * sliceWidth;
-
-      for(uint32_t y = 0; y < sliceHeight; y++)
+    Threading::ParallelFor(jobs, subdata.size(), 1, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++)
       {
-        for(uint32_t x = 0; x < sliceWidth; x++)
-        {
-          uint32_t *srcpix = (uint32_t *)&subdata[i][(y * sliceWidth + x) * pixelStride + 0];
-          uint32_t *dstpix =
-              (uint32_t *)&combinedData[((y + yoffs) * td.width + x + xoffs) * pixelStride + 0];
+        uint32_t yoffs = gridy[i] * sliceHeight;
+        uint32_t xoffs = gridx[i] * sliceWidth;
 
-          memcpy(dstpix, srcpix, pixelStride);
-        }
-      }
+        for(uint32_t y = 0; y < sliceHeight; y++)
+          memcpy(&combinedData[((y + yoffs) * td.width + xoffs) * pixelStride],
+                 &subdata[i][y * sliceWidth * pixelStride], sliceWidth * pixelStride);
 
-      delete[] subdata[i];
-    }
+        delete[] subdata[i];
+      }
+    });
 
     subdata.resize(1);
     subdata[0] = combinedData;
     rowPitch = td.width * 4;
   }
 
+  // the conversions below run on bands of rows in parallel. Pick a band size so that each job has
+  // a reasonable amount of work even for narrow images.
+  const size_t minRows = RDCMAX(1U, (64U * 1024U) / RDCMAX(1U, td.width));
+
   int numComps = td.format.compCount;
 
   // if we want a grayscale image of one channel, splat it across all channels
@@ -1051,37 +1250,28 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     uint32_t compWidth = td.format.compByteWidth;
     uint32_t compCount = td.format.compCount;
 
-    uint32_t val = 0;
-    uint32_t max = ~0U;
+    Threading::ParallelFor(jobs, td.height, minRows, [&](size_t begin, size_t end) {
+      uint32_t val = 0;
+      uint32_t max = ~0U;
 
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
+      for(size_t y = begin; y < end; y++)
       {
-        memcpy(&val, &subdata[0][(y * td.width + x) * pixelStride + sd.channelExtract * compWidth],
-               td.format.compByteWidth);
-
-        switch(compCount)
+        for(uint32_t x = 0; x < td.width; x++)
         {
-          case 4:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 3 * compWidth], &max,
-                   td.format.compByteWidth);
-            DELIBERATE_FALLTHROUGH();
-          case 3:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 2 * compWidth], &val,
-                   td.format.compByteWidth);
-            DELIBERATE_FALLTHROUGH();
-          case 2:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 1 * compWidth], &val,
-                   td.format.compByteWidth);
-            DELIBERATE_FALLTHROUGH();
-          case 1:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 0 * compWidth], &val,
-                   td.format.compByteWidth);
-            break;
+          byte *pixel = &subdata[0][(y * td.width + x) * pixelStride];
+
+          memcpy(&val, pixel + sd.channelExtract * compWidth, compWidth);
+
+          switch(compCount)
+          {
+            case 4: memcpy(pixel + 3 * compWidth, &max, compWidth); DELIBERATE_FALLTHROUGH();
+            case 3: memcpy(pixel + 2 * compWidth, &val, compWidth); DELIBERATE_FALLTHROUGH();
+            case 2: memcpy(pixel + 1 * compWidth, &val, compWidth); DELIBERATE_FALLTHROUGH();
+            case 1: memcpy(pixel + 0 * compWidth, &val, compWidth); break;
+          }
         }
       }
-    }
+    });
   }
 
   // handle formats that don't support alpha
@@ -1089,46 +1279,57 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   {
     byte *nonalpha = new byte[td.width * td.height * 3];
 
-    for(uint32_t y = 0; y < td.height; y++)
+    // the background colours are the same for every pixel, so convert them up front
+    Vec4f bgCols[3] = {
+        Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z),
+        RenderDoc::Inst().LightCheckerboardColor(),
+        RenderDoc::Inst().DarkCheckerboardColor(),
+    };
+
+    for(Vec4f &col : bgCols)
     {
-      for(uint32_t x = 0; x < td.width; x++)
-      {
-        byte r = subdata[0][(y * td.width + x) * 4 + 0];
-        byte g = subdata[0][(y * td.width + x) * 4 + 1];
-        byte b = subdata[0][(y * td.width + x) * 4 + 2];
-        byte a = subdata[0][(y * td.width + x) * 4 + 3];
+      col.x = ConvertLinearToSRGB(col.x);
+      col.y = ConvertLinearToSRGB(col.y);
+      col.z = ConvertLinearToSRGB(col.z);
+    }
 
-        if(sd.alpha != AlphaMapping::Discard)
+    Threading::ParallelFor(jobs, td.height, minRows, [&](size_t begin, size_t end) {
+      for(size_t y = begin; y < end; y++)
+      {
+        for(uint32_t x = 0; x < td.width; x++)
         {
-          Vec4f col = Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z);
-          if(sd.alpha == AlphaMapping::BlendToCheckerboard)
+          byte r = subdata[0][(y * td.width + x) * 4 + 0];
+          byte g = subdata[0][(y * td.width + x) * 4 + 1];
+          byte b = subdata[0][(y * td.width + x) * 4 + 2];
+          byte a = subdata[0][(y * td.width + x) * 4 + 3];
+
+          if(sd.alpha != AlphaMapping::Discard)
           {
-            bool lightSquare = ((x / 64) % 2) == ((y / 64) % 2);
-            col = lightSquare ? RenderDoc::Inst().LightCheckerboardColor()
-                              : RenderDoc::Inst().DarkCheckerboardColor();
+            Vec4f col = bgCols[0];
+            if(sd.alpha == AlphaMapping::BlendToCheckerboard)
+            {
+              bool lightSquare = ((x / 64) % 2) == ((y / 64) % 2);
+              col = lightSquare ? bgCols[1] : bgCols[2];
+            }
+
+            FloatVector pixel = FloatVector(float(r) / 255.0f, float(g) / 255.0f,
+                                            float(b) / 255.0f, float(a) / 255.0f);
+
+            pixel.x = pixel.x * pixel.w + col.x * (1.0f - pixel.w);
+            pixel.y = pixel.y * pixel.w + col.y * (1.0f - pixel.w);
+            pixel.z = pixel.z * pixel.w + col.z * (1.0f - pixel.w);
+
+            r = byte(pixel.x * 255.0f);
+            g = byte(pixel.y * 255.0f);
+            b = byte(pixel.z * 255.0f);
           }
 
-          col.x = ConvertLinearToSRGB(col.x);
-          col.y = ConvertLinearToSRGB(col.y);
-          col.z = ConvertLinearToSRGB(col.z);
-
-          FloatVector pixel = FloatVector(float(r) / 255.0f, float(g) / 255.0f, float(b) / 255.0f,
-                                          float(a) / 255.0f);
-
-          pixel.x = pixel.x * pixel.w + col.x * (1.0f - pixel.w);
-          pixel.y = pixel.y * pixel.w + col.y * (1.0f - pixel.w);
-          pixel.z = pixel.z * pixel.w + col.z * (1.0f - pixel.w);
-
-          r = byte(pixel.x * 255.0f);
-          g = byte(pixel.y * 255.0f);
-          b = byte(pixel.z * 255.0f);
+          nonalpha[(y * td.width + x) * 3 + 0] = r;
+          nonalpha[(y * td.width + x) * 3 + 1] = g;
+          nonalpha[(y * td.width + x) * 3 + 2] = b;
         }
-
-        nonalpha[(y * td.width + x) * 3 + 0] = r;
-        nonalpha[(y * td.width + x) * 3 + 1] = g;
-        nonalpha[(y * td.width + x) * 3 + 2] = b;
       }
-    }
+    });
 
     delete[] subdata[0];
 
@@ -1144,22 +1345,24 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   {
     byte *rg0 = new byte[td.width * td.height * 3];
 
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
+    Threading::ParallelFor(jobs, td.height, minRows, [&](size_t begin, size_t end) {
+      for(size_t y = begin; y < end; y++)
       {
-        byte r = subdata[0][(y * td.width + x) * 2 + 0];
-        byte g = subdata[0][(y * td.width + x) * 2 + 1];
+        for(uint32_t x = 0; x < td.width; x++)
+        {
+          byte r = subdata[0][(y * td.width + x) * 2 + 0];
+          byte g = subdata[0][(y * td.width + x) * 2 + 1];
 
-        rg0[(y * td.width + x) * 3 + 0] = r;
-        rg0[(y * td.width + x) * 3 + 1] = g;
-        rg0[(y * td.width + x) * 3 + 2] = 0;
+          rg0[(y * td.width + x) * 3 + 0] = r;
+          rg0[(y * td.width + x) * 3 + 1] = g;
+          rg0[(y * td.width + x) * 3 + 2] = 0;
 
-        // if we're greyscaling the image, then keep the greyscale here.
-        if(sd.channelExtract >= 0)
-          rg0[(y * td.width + x) * 3 + 2] = r;
+          // if we're greyscaling the image, then keep the greyscale here.
+          if(sd.channelExtract >= 0)
+            rg0[(y * td.width + x) * 3 + 2] = r;
+        }
       }
-    }
+    });
 
     delete[] subdata[0];
 
@@ -1169,7 +1372,8 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     rowPitch = td.width * 3;
   }
 
-  FILE *f = FileIO::fopen(path, "wb");
+  // DDS files are mapped so that subresources can be written in parallel, which needs read access
+  FILE *f = FileIO::fopen(path, sd.destType == FileType::DDS ? "w+b" : "wb");
 
   if(!f)
   {
@@ -1180,7 +1384,7 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   {
     if(sd.destType == FileType::DDS)
     {
-      dds_data ddsData;
+      dds_data ddsData = {};
 
       ResourceFormat saveFmt = td.format;
       // use typeCast to inform typeless saving, otherwise it will get lost
@@ -1191,15 +1395,15 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       ddsData.height = td.height;
       ddsData.depth = td.depth;
       ddsData.format = saveFmt;
-      ddsData.mips = numMips;
-      ddsData.slices = numSlices / td.depth;
+      ddsData.mips = data.numMips;
+      ddsData.slices = data.numSlices / td.depth;
       ddsData.subdata = &subdata[0];
-      ddsData.cubemap = td.cubemap && numSlices == 6;
+      ddsData.cubemap = td.cubemap && data.numSlices == 6;
 
-      if(singleSlice)
+      if(data.singleSlice)
         ddsData.depth = ddsData.slices = 1;
 
-      success = write_dds_to_file(f, ddsData);
+      success = write_dds_to_file(f, ddsData, jobs);
     }
     else if(sd.destType == FileType::BMP)
     {
@@ -1212,12 +1416,13 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     }
     else if(sd.destType == FileType::PNG)
     {
-      int ret = stbi_write_png_to_func(fileWriteFunc, (void *)f, td.width, td.height, numComps,
-                                       subdata[0], rowPitch);
-      success = (ret != 0);
+      png_data pngData = {td.width, td.height, (uint32_t)numComps, subdata[0], rowPitch};
+
+      StreamWriter writer(f, Ownership::Nothing);
+      success = write_png_to_stream(&writer, pngData, jobs);
 
       if(!success)
-        RDCERR("stbi_write_png_to_func failed: %d", ret);
+        RDCERR("write_png_to_stream failed");
     }
     else if(sd.destType == FileType::TGA)
     {
@@ -1253,8 +1458,19 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     }
     else if(sd.destType == FileType::HDR || sd.destType == FileType::EXR)
     {
+      ResourceFormat saveFmt = td.format;
+      if(saveFmt.compType == CompType::Typeless)
+        saveFmt.compType = sd.typeCast;
+      if(saveFmt.compType == CompType::Typeless)
+        saveFmt.compType = saveFmt.compByteWidth == 4 ? CompType::Float : CompType::UNorm;
+
+      // EXR is written as half floats unless the source has full 32-bit precision. We convert to
+      // half ourselves here, in parallel, rather than leaving it to tinyexr
+      const bool exrFloat = (saveFmt.compByteWidth == 4);
+      const size_t exrCompSize = exrFloat ? sizeof(float) : sizeof(uint16_t);
+
       float *fldata = NULL;
-      float *abgr[4] = {NULL, NULL, NULL, NULL};
+      byte *abgr[4] = {NULL, NULL, NULL, NULL};
 
       if(sd.destType == FileType::HDR)
       {
@@ -1262,79 +1478,83 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       }
       else
       {
-        abgr[0] = new float[td.width * td.height];
-        abgr[1] = new float[td.width * td.height];
-        abgr[2] = new float[td.width * td.height];
-        abgr[3] = new float[td.width * td.height];
+        abgr[0] = new byte[td.width * td.height * exrCompSize];
+        abgr[1] = new byte[td.width * td.height * exrCompSize];
+        abgr[2] = new byte[td.width * td.height * exrCompSize];
+        abgr[3] = new byte[td.width * td.height * exrCompSize];
       }
 
-      byte *srcData = subdata[0];
-
-      ResourceFormat saveFmt = td.format;
-      if(saveFmt.compType == CompType::Typeless)
-        saveFmt.compType = sd.typeCast;
-      if(saveFmt.compType == CompType::Typeless)
-        saveFmt.compType = saveFmt.compByteWidth == 4 ? CompType::Float : CompType::UNorm;
-
       uint32_t pixStride = saveFmt.ElementSize();
 
       // 24-bit depth still has a stride of 4 bytes.
       if(saveFmt.compType == CompType::Depth && pixStride == 3)
         pixStride = 4;
 
-      for(uint32_t y = 0; y < td.height; y++)
-      {
-        for(uint32_t x = 0; x < td.width; x++)
-        {
-          FloatVector pixel = DecodeFormattedComponents(saveFmt, srcData);
-          srcData += pixStride;
+      // decode a row at a time. For HDR we can decode straight into the RGBA output
+      RDCCOMPILE_ASSERT(sizeof(FloatVector) == sizeof(float) * 4, "FloatVector is mis-sized");
 
-          // HDR can't represent negative values
-          if(sd.destType == FileType::HDR)
-          {
-            pixel.x = RDCMAX(pixel.x, 0.0f);
-            pixel.y = RDCMAX(pixel.y, 0.0f);
-            pixel.z = RDCMAX(pixel.z, 0.0f);
-            pixel.w = RDCMAX(pixel.w, 0.0f);
-          }
+      Threading::ParallelFor(jobs, td.height, minRows, [&](size_t begin, size_t end) {
+        rdcarray<FloatVector> rowData;
+        if(!fldata)
+          rowData.resize(td.width);
 
-          if(sd.channelExtract == 0)
-          {
-            pixel.y = pixel.z = pixel.x;
-            pixel.w = 1.0f;
-          }
-          else if(sd.channelExtract == 1)
-          {
-            pixel.x = pixel.z = pixel.y;
-            pixel.w = 1.0f;
-          }
-          else if(sd.channelExtract == 2)
-          {
-            pixel.x = pixel.y = pixel.z;
-            pixel.w = 1.0f;
-          }
-          else if(sd.channelExtract == 3)
-          {
-            pixel.x = pixel.y = pixel.z = pixel.w;
-            pixel.w = 1.0f;
-          }
+        for(size_t y = begin; y < end; y++)
+        {
+          FloatVector *row = fldata ? (FloatVector *)fldata + y * td.width : rowData.data();
 
-          if(fldata)
-          {
-            fldata[(y * td.width + x) * 4 + 0] = pixel.x;
-            fldata[(y * td.width + x) * 4 + 1] = pixel.y;
-            fldata[(y * td.width + x) * 4 + 2] = pixel.z;
-            fldata[(y * td.width + x) * 4 + 3] = pixel.w;
-          }
-          else
+          DecodeFormattedComponentsSpan(saveFmt, subdata[0] + y * pixStride * td.width, pixStride,
+                                        td.width, row);
+
+          for(uint32_t x = 0; x < td.width; x++)
           {
-            abgr[0][(y * td.width + x)] = pixel.w;
-            abgr[1][(y * td.width + x)] = pixel.z;
-            abgr[2][(y * td.width + x)] = pixel.y;
-            abgr[3][(y * td.width + x)] = pixel.x;
+            FloatVector &pixel = row[x];
+
+            // HDR can't represent negative values
+            if(sd.destType == FileType::HDR)
+            {
+              pixel.x = RDCMAX(pixel.x, 0.0f);
+              pixel.y = RDCMAX(pixel.y, 0.0f);
+              pixel.z = RDCMAX(pixel.z, 0.0f);
+              pixel.w = RDCMAX(pixel.w, 0.0f);
+            }
+
+            if(sd.channelExtract == 0)
+            {
+              pixel.y = pixel.z = pixel.x;
+              pixel.w = 1.0f;
+            }
+            else if(sd.channelExtract == 1)
+            {
+              pixel.x = pixel.z = pixel.y;
+              pixel.w = 1.0f;
+            }
+            else if(sd.channelExtract == 2)
+            {
+              pixel.x = pixel.y = pixel.z;
+              pixel.w = 1.0f;
+            }
+            else if(sd.channelExtract == 3)
+            {
+              pixel.x = pixel.y = pixel.z = pixel.w;
+              pixel.w = 1.0f;
+            }
+
+            if(!fldata)
+            {
+              size_t idx = y * td.width + x;
+              float comps[4] = {pixel.w, pixel.z, pixel.y, pixel.x};
+
+              for(int c = 0; c < 4; c++)
+              {
+                if(exrFloat)
+                  ((float *)abgr[c])[idx] = comps[c];
+                else
+                  ((uint16_t *)abgr[c])[idx] = ConvertToHalf(comps[c]);
+              }
+            }
           }
         }
-      }
+      });
 
       if(sd.destType == FileType::HDR)
       {
@@ -1354,18 +1574,10 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
         EXRImage exrImage;
         InitEXRImage(&exrImage);
 
-        int pixTypes[4] = {TINYEXR_PIXELTYPE_FLOAT, TINYEXR_PIXELTYPE_FLOAT,
-                           TINYEXR_PIXELTYPE_FLOAT, TINYEXR_PIXELTYPE_FLOAT};
-        int reqTypes[4] = {TINYEXR_PIXELTYPE_HALF, TINYEXR_PIXELTYPE_HALF, TINYEXR_PIXELTYPE_HALF,
-                           TINYEXR_PIXELTYPE_HALF};
+        const int pixType = exrFloat ? TINYEXR_PIXELTYPE_FLOAT : TINYEXR_PIXELTYPE_HALF;
 
-        if(saveFmt.compByteWidth == 4)
-        {
-          for(size_t channel = 0; channel < 4; channel++)
-          {
-            reqTypes[channel] = TINYEXR_PIXELTYPE_FLOAT;
-          }
-        }
+        int pixTypes[4] = {pixType, pixType, pixType, pixType};
+        int reqTypes[4] = {pixType, pixType, pixType, pixType};
 
         // must be in this order as many viewers don't pay attention to channels and just assume
         // they are in this order
@@ -1410,12 +1622,227 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     FileIO::fclose(f);
   }
 
-  for(size_t i = 0; i < subdata.size(); i++)
-    delete[] subdata[i];
-
   return success;
 }
 
+bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path)
+{
+  CHECK_REPLAY_THREAD();
+  RENDERDOC_PROFILEFUNCTION();
+
+  TextureSaveData data;
+  if(!FetchTextureSave(saveData, data))
+    return false;
+
+  Threading::JobQueue jobs;
+  return WriteTextureSave(data, path, &jobs);
+}
+
+// expand a save that may select all mips or all slices into one save per subresource
+static void ExpandTextureSave(const TextureSave &saveData, const TextureDescription &td,
+                              rdcarray<TextureSave> &out)
+{
+  // multisampled textures have no mips
+  uint32_t numMips = td.msSamp > 1 ? 1 : td.mips;
+
+  uint32_t firstMip = 0;
+  if(saveData.mip >= 0)
+  {
+    firstMip = RDCMIN((uint32_t)saveData.mip, numMips - 1);
+    numMips = 1;
+  }
+
+  for(uint32_t mip = firstMip; mip < firstMip + numMips; mip++)
+  {
+    uint32_t numSlices = td.arraysize * RDCMAX(1U, td.depth >> mip);
+
+    uint32_t firstSlice = 0;
+    if(saveData.slice.sliceIndex >= 0)
+    {
+      firstSlice = RDCMIN((uint32_t)saveData.slice.sliceIndex, numSlices - 1);
+      numSlices = 1;
+    }
+
+    for(uint32_t slice = firstSlice; slice < firstSlice + numSlices; slice++)
+    {
+      TextureSave sd = saveData;
+      sd.mip = (int32_t)mip;
+      sd.slice.sliceIndex = (int32_t)slice;
+      sd.slice.slicesAsGrid = false;
+      sd.slice.cubeCruciform = false;
+      sd.sample.mapToArray = false;
+      out.push_back(sd);
+    }
+  }
+}
+
+static void ReplaceAll(rdcstr &str, const char *token, const rdcstr &value)
+{
+  const size_t tokenLen = strlen(token);
+
+  int32_t offs = str.find(token);
+  while(offs >= 0)
+  {
+    str.replace(offs, tokenLen, value);
+    offs = str.find(token, offs + (int32_t)value.size());
+  }
+}
+
+static rdcstr ExpandExportPattern(const rdcstr &pattern, const rdcstr &name, ResourceId id,
+                                  const TextureSave &sd)
+{
+  rdcstr ret = pattern;
+
+  // names can contain anything, keep only characters that are safe in a filename everywhere
+  rdcstr safeName = name;
+  for(char &c : safeName)
+  {
+    if(!isalnum((unsigned char)c) && c != '-' && c != '_' && c != '.')
+      c = '_';
+  }
+
+  // leading dots could make the name '.' or '..' and escape the export directory, or make a
+  // hidden file
+  for(size_t i = 0; i < safeName.size() && safeName[i] == '.'; i++)
+    safeName[i] = '_';
+
+  rdcstr idStr = ToStr(id);
+  idStr.erase(0, idStr.find("::") + 2);
+
+  ReplaceAll(ret, "{name}", safeName);
+  ReplaceAll(ret, "{id}", idStr);
+  ReplaceAll(ret, "{mip}", sd.mip >= 0 ? ToStr(sd.mip) : rdcstr("all"));
+  ReplaceAll(ret, "{slice}", sd.slice.sliceIndex >= 0 ? ToStr(sd.slice.sliceIndex) : rdcstr("all"));
+  ReplaceAll(ret, "{ext}", strlower(ToStr(sd.destType)));
+
+  return ret;
+}
+
+bool ReplayController::SaveTextures(const rdcarray<rdcpair<TextureSave, rdcstr>> &saves)
+{
+  CHECK_REPLAY_THREAD();
+
+  bool success = true;
+  int32_t failed = 0;
+
+  // fetching from the device has to happen here on the replay thread, but once a texture is
+  // fetched it's converted and written on a worker while we fetch the next one. We bound how many
+  // are in flight so that memory use doesn't grow with the number of textures.
+  Threading::JobQueue jobs;
+  rdcarray<Threading::JobHandle> inflight;
+  const size_t maxInflight = RDCMAX(2U, Threading::GetNumberOfCores());
+
+  for(const rdcpair<TextureSave, rdcstr> &save : saves)
+  {
+    TextureSaveData *data = new TextureSaveData;
+    if(!FetchTextureSave(save.first, *data))
+    {
+      delete data;
+      success = false;
+      continue;
+    }
+
+    if(inflight.size() >= maxInflight)
+    {
+      jobs.Wait(inflight[0]);
+      inflight.erase(0);
+    }
+
+    rdcstr path = save.second;
+
+    inflight.push_back(jobs.Submit([data, path, &jobs, &failed]() {
+      if(!WriteTextureSave(*data, path.c_str(), &jobs))
+        Atomic::Inc32(&failed);
+      delete data;
+    }));
+  }
+
+  jobs.WaitAll();
+
+  return success && failed == 0;
+}
+
+bool ReplayController::SaveTextureSubresources(const TextureSave &saveData, const char *path)
+{
+  CHECK_REPLAY_THREAD();
+  RENDERDOC_PROFILEFUNCTION();
+
+  ResourceId liveid = m_pDevice->GetLiveID(saveData.resourceId);
+
+  if(liveid == ResourceId())
+  {
+    RDCERR("Couldn't get Live ID for %s getting texture data", ToStr(saveData.resourceId).c_str());
+    return false;
+  }
+
+  rdcarray<TextureSave> subresources;
+  ExpandTextureSave(saveData, m_pDevice->GetTexture(liveid), subresources);
+
+  // insert the subresource before the extension, if there is one
+  rdcstr filename = get_basename(path);
+  rdcstr ext = filename.substr(strip_extension(filename).size());
+  rdcstr base = rdcstr(path).substr(0, strlen(path) - ext.size());
+
+  rdcarray<rdcpair<TextureSave, rdcstr>> saves;
+  for(const TextureSave &sd : subresources)
+    saves.push_back({sd, StringFormat::Fmt("%s_mip%d_slice%d%s", base.c_str(), sd.mip,
+                                           sd.slice.sliceIndex, ext.c_str())});
+
+  return SaveTextures(saves);
+}
+
+bool ReplayController::ExportResources(const rdcarray<TextureSave> &textures,
+                                       const char *pathPattern)
+{
+  CHECK_REPLAY_THREAD();
+  RENDERDOC_PROFILEFUNCTION();
+
+  bool success = true;
+
+  std::map<ResourceId, rdcstr> names;
+  for(const ResourceDescription &desc : m_Resources)
+    names[desc.resourceId] = desc.name;
+
+  rdcarray<rdcpair<TextureSave, rdcstr>> saves;
+
+  for(const TextureSave &saveData : textures)
+  {
+    ResourceId liveid = m_pDevice->GetLiveID(saveData.resourceId);
+
+    if(liveid == ResourceId())
+    {
+      RDCERR("Couldn't get Live ID for %s exporting resources", ToStr(saveData.resourceId).c_str());
+      success = false;
+      continue;
+    }
+
+    rdcstr name;
+    auto it = names.find(saveData.resourceId);
+    if(it != names.end())
+      name = it->second;
+
+    // DDS can hold every mip and slice in one file, other formats get one file per subresource
+    rdcarray<TextureSave> subresources;
+    if(saveData.destType == FileType::DDS)
+      subresources.push_back(saveData);
+    else
+      ExpandTextureSave(saveData, m_pDevice->GetTexture(liveid), subresources);
+
+    for(const TextureSave &sd : subresources)
+      saves.push_back({sd, ExpandExportPattern(pathPattern, name, saveData.resourceId, sd)});
+  }
+
+  // the pattern can put files in directories that don't exist yet
+  std::set<rdcstr> dirs;
+  for(const rdcpair<TextureSave, rdcstr> &save : saves)
+  {
+    if(dirs.insert(get_dirname(save.second)).second)
+      FileIO::CreateParentDirectory(save.second);
+  }
+
+  return SaveTextures(saves) && success;
+}
+
 rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, uint32_t x, uint32_t y,
                                                            const Subresource &sub, CompType typeCast)
 {
@@ -1572,8 +1999,11 @@ rdcpair<PixelValue, PixelValue> ReplayController::GetMinMax(ResourceId textureId
   PixelValue minval = {{0.0f, 0.0f, 0.0f, 0.0f}};
   PixelValue maxval = {{1.0f, 1.0f, 1.0f, 1.0f}};
 
-  m_pDevice->GetMinMax(m_pDevice->GetLiveID(textureId), sub, typeCast, &minval.floatValue[0],
-                       &maxval.floatValue[0]);
+  ResourceId liveid = m_pDevice->GetLiveID(textureId);
+
+  if(Replay_CPUTextureStatistics() ||
+     !m_pDevice->GetMinMax(liveid, sub, typeCast, &minval.floatValue[0], &maxval.floatValue[0]))
+    CPUGetMinMax(m_pDevice, liveid, sub, typeCast, &minval.floatValue[0], &maxval.floatValue[0]);
 
   return make_rdcpair(minval, maxval);
 }
@@ -1586,12 +2016,77 @@ rdcarray<uint32_t> ReplayController::GetHistogram(ResourceId textureId, const Su
 
   rdcarray<uint32_t> hist;
 
-  m_pDevice->GetHistogram(m_pDevice->GetLiveID(textureId), sub, typeCast, minval, maxval, channels,
-                          hist);
+  ResourceId liveid = m_pDevice->GetLiveID(textureId);
+
+  if(Replay_CPUTextureStatistics() ||
+     !m_pDevice->GetHistogram(liveid, sub, typeCast, minval, maxval, channels, hist))
+    CPUGetHistogram(m_pDevice, liveid, sub, typeCast, minval, maxval, channels, hist);
 
   return hist;
 }
 
+TextureComparison ReplayController::CompareTextures(uint32_t eventA, ResourceId texA,
+                                                    const Subresource &subA, uint32_t eventB,
+                                                    ResourceId texB, const Subresource &subB,
+                                                    CompType typeCast, float threshold,
+                                                    bool diffImage)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  TextureComparison ret;
+
+  ResourceId liveA = m_pDevice->GetLiveID(texA);
+  ResourceId liveB = m_pDevice->GetLiveID(texB);
+
+  if(liveA == ResourceId() || liveB == ResourceId())
+  {
+    RDCERR("Couldn't get Live ID for %s or %s comparing textures", ToStr(texA).c_str(),
+           ToStr(texB).c_str());
+    return ret;
+  }
+
+  const uint32_t prevEventID = m_EventID;
+
+  bytebuf dataA, dataB;
+  ResourceFormat fmtA, fmtB;
+  uint32_t widthA = 0, heightA = 0, depthA = 0;
+  uint32_t widthB = 0, heightB = 0, depthB = 0;
+
+  SetFrameEvent(eventA, false);
+
+  bool fetched = FetchTextureStatisticsData(m_pDevice, liveA, subA, typeCast, dataA, fmtA, widthA,
+                                            heightA, depthA);
+
+  if(fetched)
+    SetFrameEvent(eventB, false);
+
+  fetched = fetched && FetchTextureStatisticsData(m_pDevice, liveB, subB, typeCast, dataB, fmtB,
+                                                  widthB, heightB, depthB);
+
+  SetFrameEvent(prevEventID, false);
+
+  if(!fetched)
+  {
+    RDCERR("Couldn't fetch texture data for %s and %s", ToStr(texA).c_str(), ToStr(texB).c_str());
+    return ret;
+  }
+
+  if(widthA != widthB || heightA != heightB || depthA != depthB)
+  {
+    RDCERR("Can't compare %ux%ux%u texture to %ux%ux%u texture", widthA, heightA, depthA, widthB,
+           heightB, depthB);
+    return ret;
+  }
+
+  Threading::JobQueue jobs;
+  CompareTextureData(fmtA, dataA.data(), dataA.size(), fmtB, dataB.data(), dataB.size(), widthA,
+                     heightA, depthA, threshold, diffImage, ret, &jobs);
+
+  return ret;
+}
+
 ShaderDebugTrace *ReplayController::DebugVertex(uint32_t vertid, uint32_t instid, uint32_t idx,
                                                 uint32_t view)
 {
@@ -1620,6 +2115,65 @@ ShaderDebugTrace *ReplayController::DebugPixel(uint32_t x, uint32_t y, uint32_t
   return ret;
 }
 
+rdcarray<PixelDebugSummary> ReplayController::DebugPixels(uint32_t x, uint32_t y, uint32_t width,
+                                                          uint32_t height, uint32_t sample,
+                                                          uint32_t primitive)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  rdcarray<PixelDebugSummary> ret;
+
+  // clamp the rectangle to the bound target, if there is one. Pixel shaders writing only to UAVs
+  // or storage images don't have a target to clamp to.
+  BoundResource target;
+  for(const BoundResource &o : m_PipeState.GetOutputTargets())
+  {
+    if(o.resourceId != ResourceId())
+    {
+      target = o;
+      break;
+    }
+  }
+  if(target.resourceId == ResourceId())
+    target = m_PipeState.GetDepthTarget();
+
+  uint32_t maxX = ~0U, maxY = ~0U;
+  TextureDescription targetDesc;
+  if(target.resourceId != ResourceId())
+  {
+    targetDesc = m_pDevice->GetTexture(m_pDevice->GetLiveID(target.resourceId));
+    const uint32_t mip = (uint32_t)RDCMAX(0, target.firstMip);
+    maxX = RDCMAX(1U, targetDesc.width >> mip);
+    maxY = RDCMAX(1U, targetDesc.height >> mip);
+  }
+
+  if(x >= maxX || y >= maxY)
+    return ret;
+
+  width = RDCMIN(width, maxX - x);
+  height = RDCMIN(height, maxY - y);
+
+  if(width == 0 || height == 0)
+    return ret;
+
+  if(uint64_t(width) * height > MaxSummarisedDebugPixels)
+  {
+    RDCERR("Can't debug %ux%u pixels, at most %u pixels can be debugged in one request", width,
+           height, MaxSummarisedDebugPixels);
+    return ret;
+  }
+
+  // the driver fetches the inputs for the whole rectangle in one replay of the draw, and pixels
+  // that nothing covered come back without being debugged.
+  ret = m_pDevice->DebugPixels(m_EventID, x, y, width, height, sample, primitive);
+
+  SetFrameEvent(m_EventID, true);
+
+  return ret;
+}
+
 ShaderDebugTrace *ReplayController::DebugThread(const uint32_t groupid[3], const uint32_t threadid[3])
 {
   CHECK_REPLAY_THREAD();
@@ -1641,6 +2195,106 @@ rdcarray<ShaderDebugState> ReplayController::ContinueDebug(ShaderDebugger *debug
 
   rdcarray<ShaderDebugState> ret = m_pDevice->ContinueDebug(debugger);
 
+  RecordDebugStates(debugger, ret);
+
+  return ret;
+}
+
+rdcarray<ShaderDebugState> ReplayController::ContinueDebugToCondition(
+    ShaderDebugger *debugger, const ShaderDebugStopCondition &condition)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  rdcarray<ShaderDebugState> ret = m_pDevice->ContinueDebugToCondition(debugger, condition);
+
+  RecordDebugStates(debugger, ret);
+
+  return ret;
+}
+
+static void ApplyDebugState(rdcarray<ShaderVariable> &variables, const ShaderDebugState &state)
+{
+  rdcarray<ShaderVariable> newVariables;
+
+  for(const ShaderVariableChange &c : state.changes)
+  {
+    // if the after name is empty, this is a variable going out of scope/being deleted
+    if(c.after.name.empty())
+    {
+      for(size_t i = 0; i < variables.size(); i++)
+      {
+        if(c.before.name == variables[i].name)
+        {
+          variables.erase(i);
+          break;
+        }
+      }
+    }
+    else
+    {
+      ShaderVariable *v = NULL;
+      for(size_t i = 0; i < variables.size(); i++)
+      {
+        if(c.after.name == variables[i].name)
+        {
+          v = &variables[i];
+          break;
+        }
+      }
+
+      if(v)
+        *v = c.after;
+      else
+        newVariables.push_back(c.after);
+    }
+  }
+
+  variables.insert(0, newVariables);
+}
+
+void ReplayController::RecordDebugStates(ShaderDebugger *debugger,
+                                         const rdcarray<ShaderDebugState> &states)
+{
+  if(!debugger || states.empty())
+    return;
+
+  DebugStateHistory &history = m_DebugStates[debugger];
+
+  history.states.reserve(history.states.size() + states.size());
+
+  for(const ShaderDebugState &state : states)
+  {
+    ApplyDebugState(history.variables, state);
+
+    if(history.states.size() % DebugKeyframeInterval == 0)
+      history.keyframes.push_back(history.variables);
+
+    history.states.push_back(state);
+  }
+}
+
+rdcarray<ShaderVariable> ReplayController::GetDebugVariablesAt(ShaderDebugger *debugger,
+                                                               uint32_t stateIndex)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  auto it = m_DebugStates.find(debugger);
+  if(it == m_DebugStates.end() || stateIndex >= it->second.states.size())
+    return {};
+
+  const DebugStateHistory &history = it->second;
+
+  uint32_t key = stateIndex / DebugKeyframeInterval;
+
+  rdcarray<ShaderVariable> ret = history.keyframes[key];
+
+  for(uint32_t i = key * DebugKeyframeInterval + 1; i <= stateIndex; i++)
+    ApplyDebugState(ret, history.states[i]);
+
   return ret;
 }
 
@@ -1650,6 +2304,7 @@ void ReplayController::FreeTrace(ShaderDebugTrace *trace)
 
   if(trace)
   {
+    m_DebugStates.erase(trace->debugger);
     m_pDevice->FreeDebugger(trace->debugger);
     delete trace;
   }
@@ -1973,6 +2628,9 @@ void ReplayController::ReplaceResource(ResourceId from, ResourceId to)
 
   m_pDevice->ReplaceResource(from, to);
 
+  m_Disassembly.clear();
+  m_DisassemblyBytes = 0;
+
   SetFrameEvent(m_EventID, true);
 
   for(size_t i = 0; i < m_Outputs.size(); i++)
@@ -1986,6 +2644,9 @@ void ReplayController::RemoveReplacement(ResourceId id)
 
   m_pDevice->RemoveReplacement(id);
 
+  m_Disassembly.clear();
+  m_DisassemblyBytes = 0;
+
   SetFrameEvent(m_EventID, true);
 
   for(size_t i = 0; i < m_Outputs.size(); i++)
@@ -2092,3 +2753,27 @@ void ReplayController::FetchPipelineState(uint32_t eventId)
   m_PipeState.SetStates(m_APIProps, m_D3D11PipelineState, m_D3D12PipelineState, m_GLPipelineState,
                         m_VulkanPipelineState);
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Export patterns don't escape the export directory", "[export]")
+{
+  TextureSave sd;
+  sd.mip = 0;
+  sd.slice.sliceIndex = 0;
+  sd.destType = FileType::PNG;
+
+  const rdcstr pattern = "out/{name}/{mip}.{ext}";
+
+  CHECK(ExpandExportPattern(pattern, "albedo", ResourceId(), sd) == "out/albedo/0.png");
+  CHECK(ExpandExportPattern(pattern, "..", ResourceId(), sd) == "out/__/0.png");
+  CHECK(ExpandExportPattern(pattern, ".", ResourceId(), sd) == "out/_/0.png");
+  CHECK(ExpandExportPattern(pattern, "../x", ResourceId(), sd) == "out/___x/0.png");
+  CHECK(ExpandExportPattern(pattern, "..\\..\\x", ResourceId(), sd) == "out/___.._x/0.png");
+  CHECK(ExpandExportPattern(pattern, ".hidden", ResourceId(), sd) == "out/_hidden/0.png");
+  CHECK(ExpandExportPattern(pattern, "tex.v2", ResourceId(), sd) == "out/tex.v2/0.png");
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
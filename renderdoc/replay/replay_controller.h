@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include "api/replay/renderdoc_replay.h"
 #include "common/common.h"
@@ -34,6 +35,7 @@
 #define CHECK_REPLAY_THREAD() RDCASSERT(Threading::GetCurrentID() == m_ThreadID);
 
 struct ReplayController;
+struct TextureSaveData;
 
 struct ReplayOutput : public IReplayOutput
 {
@@ -145,6 +147,10 @@ public:
 
   rdcarray<rdcstr> GetDisassemblyTargets(bool withPipeline);
   rdcstr DisassembleShader(ResourceId pipeline, const ShaderReflection *refl, const char *target);
+  uint32_t GetDisassemblyLineCount(ResourceId pipeline, const ShaderReflection *refl,
+                                   const char *target);
+  rdcstr DisassembleShaderLines(ResourceId pipeline, const ShaderReflection *refl,
+                                const char *target, uint32_t firstLine, uint32_t numLines);
 
   rdcpair<ResourceId, rdcstr> BuildCustomShader(const char *entry, ShaderEncoding sourceEncoding,
                                                 bytebuf source,
@@ -183,12 +189,20 @@ public:
                                             CompType typeCast);
   rdcarray<uint32_t> GetHistogram(ResourceId textureId, const Subresource &sub, CompType typeCast,
                                   float minval, float maxval, bool channels[4]);
+  TextureComparison CompareTextures(uint32_t eventA, ResourceId texA, const Subresource &subA,
+                                    uint32_t eventB, ResourceId texB, const Subresource &subB,
+                                    CompType typeCast, float threshold, bool diffImage);
   rdcarray<PixelModification> PixelHistory(ResourceId target, uint32_t x, uint32_t y,
                                            const Subresource &sub, CompType typeCast);
   ShaderDebugTrace *DebugVertex(uint32_t vertid, uint32_t instid, uint32_t idx, uint32_t view);
   ShaderDebugTrace *DebugPixel(uint32_t x, uint32_t y, uint32_t sample, uint32_t primitive);
+  rdcarray<PixelDebugSummary> DebugPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                          uint32_t sample, uint32_t primitive);
   ShaderDebugTrace *DebugThread(const uint32_t groupid[3], const uint32_t threadid[3]);
   rdcarray<ShaderDebugState> ContinueDebug(ShaderDebugger *debugger);
+  rdcarray<ShaderDebugState> ContinueDebugToCondition(ShaderDebugger *debugger,
+                                                      const ShaderDebugStopCondition &condition);
+  rdcarray<ShaderVariable> GetDebugVariablesAt(ShaderDebugger *debugger, uint32_t stateIndex);
   void FreeTrace(ShaderDebugTrace *trace);
 
   MeshFormat GetPostVSData(uint32_t instID, uint32_t viewID, MeshDataStage stage);
@@ -197,8 +211,12 @@ public:
 
   bytebuf GetBufferData(ResourceId buff, uint64_t offset, uint64_t len);
   bytebuf GetTextureData(ResourceId buff, const Subresource &sub);
+  bytebuf GetTextureRegionData(ResourceId tex, const Subresource &sub, uint32_t x, uint32_t y,
+                               uint32_t z, uint32_t width, uint32_t height, uint32_t depth);
 
   bool SaveTexture(const TextureSave &saveData, const char *path);
+  bool SaveTextureSubresources(const TextureSave &saveData, const char *path);
+  bool ExportResources(const rdcarray<TextureSave> &textures, const char *pathPattern);
 
   rdcarray<ShaderVariable> GetCBufferVariableContents(ResourceId pipeline, ResourceId shader,
                                                       const char *entryPoint, uint32_t cbufslot,
@@ -223,6 +241,9 @@ private:
   void FetchPipelineState(uint32_t eventId);
 
   DrawcallDescription *GetDrawcallByEID(uint32_t eventId);
+
+  bool FetchTextureSave(const TextureSave &saveData, TextureSaveData &out);
+  bool SaveTextures(const rdcarray<rdcpair<TextureSave, rdcstr>> &saves);
   bool ContainsMarker(const rdcarray<DrawcallDescription> &draws);
   bool PassEquivalent(const DrawcallDescription &a, const DrawcallDescription &b);
 
@@ -235,6 +256,63 @@ private:
   APIProperties m_APIProps;
   rdcarray<rdcstr> m_GCNTargets;
 
+  struct DisassemblyKey
+  {
+    ResourceId pipeline;
+    ResourceId shader;
+    rdcstr entryPoint;
+    rdcstr target;
+
+    bool operator<(const DisassemblyKey &o) const
+    {
+      if(pipeline != o.pipeline)
+        return pipeline < o.pipeline;
+      if(shader != o.shader)
+        return shader < o.shader;
+      if(entryPoint != o.entryPoint)
+        return entryPoint < o.entryPoint;
+      return target < o.target;
+    }
+  };
+
+  struct CachedDisassembly
+  {
+    rdcstr text;
+    // offset in text where each line starts
+    rdcarray<size_t> lineOffsets;
+    // value of m_DisassemblyUse when this was last fetched, for LRU eviction
+    uint64_t lastUse = 0;
+
+    uint64_t GetSize() const { return text.size() + lineOffsets.size() * sizeof(size_t); }
+  };
+
+  // disassembly can be expensive to generate, especially for non-native targets, so it's only
+  // done once. Cleared whenever resources are replaced since the disassembly may change, and
+  // limited to MaxCachedDisassemblyBytes by evicting the least recently used entries.
+  std::map<DisassemblyKey, CachedDisassembly> m_Disassembly;
+  uint64_t m_DisassemblyBytes = 0;
+  uint64_t m_DisassemblyUse = 0;
+  static const uint64_t MaxCachedDisassemblyBytes = 64 * 1024 * 1024;
+
+  const CachedDisassembly &GetCachedDisassembly(ResourceId pipeline, const ShaderReflection *refl,
+                                                const char *target);
+
+  // every state returned so far for a shader debugger, with a snapshot of the variables after
+  // every DebugKeyframeInterval'th state. Keyframes are taken as the states are returned, so the
+  // variables at any state need at most DebugKeyframeInterval states' changes to be applied.
+  struct DebugStateHistory
+  {
+    rdcarray<ShaderDebugState> states;
+    rdcarray<rdcarray<ShaderVariable>> keyframes;
+    // the variables after the last state returned
+    rdcarray<ShaderVariable> variables;
+  };
+
+  std::map<ShaderDebugger *, DebugStateHistory> m_DebugStates;
+  static const uint32_t DebugKeyframeInterval = 256;
+
+  void RecordDebugStates(ShaderDebugger *debugger, const rdcarray<ShaderDebugState> &states);
+
   int32_t m_ReplayLoopCancel = 0;
   int32_t m_ReplayLoopFinished = 0;
 
@@ -41,6 +41,19 @@ rdcstr DoStringise(const RemapTexture &el)
   END_ENUM_STRINGISE();
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, TextureRegion &el)
+{
+  SERIALISE_MEMBER(x);
+  SERIALISE_MEMBER(y);
+  SERIALISE_MEMBER(z);
+  SERIALISE_MEMBER(width);
+  SERIALISE_MEMBER(height);
+  SERIALISE_MEMBER(depth);
+}
+
+INSTANTIATE_SERIALISE_TYPE(TextureRegion);
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, GetTextureDataParams &el)
 {
@@ -51,6 +64,7 @@ void DoSerialise(SerialiserType &ser, GetTextureDataParams &el)
   SERIALISE_MEMBER(remap);
   SERIALISE_MEMBER(blackPoint);
   SERIALISE_MEMBER(whitePoint);
+  SERIALISE_MEMBER(region);
 }
 
 INSTANTIATE_SERIALISE_TYPE(GetTextureDataParams);
@@ -1127,6 +1141,383 @@ const Vec4f colorRamp[22] = {
     Vec4f(1.000000f, 0.878431f, 1.000000f, 1.0f), Vec4f(1.000000f, 1.000000f, 1.000000f, 1.0f),
 };
 
+static const rdcstr &ChangedVariableName(const ShaderVariableChange &c)
+{
+  return c.before.name.empty() ? c.after.name : c.before.name;
+}
+
+static bool IsNoOpChange(const ShaderVariableChange &c)
+{
+  return c.before.name.empty() && c.after.name.empty();
+}
+
+// changeIndex maps each variable name to its entry in merged.changes, and lives as long as merged
+static void MergeDebugState(ShaderDebugState &merged, std::map<rdcstr, size_t> &changeIndex,
+                            const ShaderDebugState &state)
+{
+  for(const ShaderVariableChange &c : state.changes)
+  {
+    const rdcstr &name = ChangedVariableName(c);
+
+    auto it = changeIndex.find(name);
+
+    if(it == changeIndex.end())
+    {
+      changeIndex[name] = merged.changes.size();
+      merged.changes.push_back(c);
+      continue;
+    }
+
+    ShaderVariableChange &m = merged.changes[it->second];
+    m.after = c.after;
+
+    // a variable that was created and destroyed entirely within the merged steps has no net change.
+    // The entry is left in place so the other indices stay valid, and removed when the merged state
+    // is returned.
+    if(IsNoOpChange(m))
+      changeIndex.erase(it);
+  }
+
+  merged.nextInstruction = state.nextInstruction;
+  merged.stepIndex = state.stepIndex;
+  merged.flags = state.flags;
+  merged.sourceVars = state.sourceVars;
+  merged.callstack = state.callstack;
+}
+
+static bool MatchesStopCondition(const ShaderDebugState &state,
+                                 const ShaderDebugStopCondition &condition)
+{
+  if(condition.instructions.contains(state.nextInstruction))
+    return true;
+
+  if(state.flags & condition.events)
+    return true;
+
+  for(const ShaderVariableChange &c : state.changes)
+    if(condition.watchVariables.contains(ChangedVariableName(c)))
+      return true;
+
+  return false;
+}
+
+rdcarray<ShaderDebugState> ContinueDebugUntil(IRemoteDriver *driver, ShaderDebugger *debugger,
+                                              const ShaderDebugStopCondition &condition)
+{
+  rdcarray<ShaderDebugState> ret;
+
+  ShaderDebugState merged;
+  std::map<rdcstr, size_t> changeIndex;
+  bool any = false;
+  uint32_t steps = 0;
+
+  while(ret.empty())
+  {
+    rdcarray<ShaderDebugState> states = driver->ContinueDebug(debugger);
+
+    // if debugging finished, return whatever we had merged so far as the final state
+    if(states.empty())
+    {
+      if(any)
+      {
+        merged.changes.removeIf(IsNoOpChange);
+        ret.push_back(merged);
+      }
+      break;
+    }
+
+    for(size_t i = 0; i < states.size(); i++)
+    {
+      MergeDebugState(merged, changeIndex, states[i]);
+      any = true;
+      steps++;
+
+      if(MatchesStopCondition(states[i], condition) ||
+         (condition.maxSteps > 0 && steps >= condition.maxSteps))
+      {
+        // the debugger has already calculated past the stop point, so return those states as-is
+        merged.changes.removeIf(IsNoOpChange);
+        ret.push_back(merged);
+        ret.append(states.data() + i + 1, states.size() - i - 1);
+        break;
+      }
+    }
+  }
+
+  return ret;
+}
+
+static bool ContainsNaN(const ShaderVariable &var)
+{
+  for(const ShaderVariable &m : var.members)
+    if(ContainsNaN(m))
+      return true;
+
+  const uint32_t count = uint32_t(var.rows) * var.columns;
+
+  for(uint32_t i = 0; i < count && i < 16; i++)
+  {
+    if(var.type == VarType::Float && RDCISNAN(var.value.fv[i]))
+      return true;
+    else if(var.type == VarType::Double && RDCISNAN(var.value.dv[i]))
+      return true;
+    else if(var.type == VarType::Half && RDCISNAN(ConvertFromHalf(var.value.u16v[i])))
+      return true;
+  }
+
+  return false;
+}
+
+static void SummariseOutputs(PixelDebugSummary &summary,
+                             const rdcarray<SourceVariableMapping> &sourceVars,
+                             const std::map<rdcstr, ShaderVariable> &values)
+{
+  for(const SourceVariableMapping &mapping : sourceVars)
+  {
+    if(mapping.signatureIndex < 0)
+      continue;
+
+    for(const DebugVariableReference &ref : mapping.variables)
+    {
+      if(ref.type != DebugVariableType::Variable)
+        continue;
+
+      // references can be to a struct member or array element, in which case return the whole
+      // variable that contains it
+      auto it = values.find(ref.name);
+      for(size_t i = 0; it == values.end() && i < ref.name.size(); i++)
+        if(ref.name[i] == '.' || ref.name[i] == '[')
+          it = values.find(ref.name.substr(0, i));
+
+      if(it == values.end())
+        continue;
+
+      bool found = false;
+      for(const ShaderVariable &o : summary.outputs)
+        found |= (o.name == it->first);
+
+      if(!found)
+        summary.outputs.push_back(it->second);
+    }
+  }
+}
+
+rdcarray<PixelDebugSummary> PrepareDebugPixelSummaries(uint32_t x, uint32_t y, uint32_t width,
+                                                       uint32_t height)
+{
+  rdcarray<PixelDebugSummary> ret;
+
+  // don't let the rectangle wrap around past the largest co-ordinate
+  width = RDCMIN(width, ~0U - x);
+  height = RDCMIN(height, ~0U - y);
+
+  if(uint64_t(width) * height > MaxSummarisedDebugPixels)
+  {
+    RDCERR("Can't debug %ux%u pixels, at most %u pixels can be debugged in one request", width,
+           height, MaxSummarisedDebugPixels);
+    return ret;
+  }
+
+  ret.resize(width * height);
+
+  for(uint32_t row = 0; row < height; row++)
+  {
+    for(uint32_t col = 0; col < width; col++)
+    {
+      PixelDebugSummary &summary = ret[row * width + col];
+      summary.x = x + col;
+      summary.y = y + row;
+    }
+  }
+
+  return ret;
+}
+
+void SummariseDebugTrace(IRemoteDriver *driver, ShaderDebugTrace *trace, PixelDebugSummary &summary)
+{
+  if(!trace->debugger)
+  {
+    delete trace;
+    return;
+  }
+
+  summary.debugged = true;
+
+  // the final value of every mutable variable, by name
+  std::map<rdcstr, ShaderVariable> values;
+  rdcarray<SourceVariableMapping> sourceVars;
+  uint32_t lastInstruction = 0;
+
+  for(;;)
+  {
+    rdcarray<ShaderDebugState> states = driver->ContinueDebug(trace->debugger);
+
+    if(states.empty())
+      break;
+
+    for(const ShaderDebugState &state : states)
+    {
+      // the initial state has the initial values, which aren't from any instruction
+      const uint32_t instruction = state.stepIndex == 0 ? state.nextInstruction : lastInstruction;
+
+      for(const ShaderVariableChange &c : state.changes)
+      {
+        if(c.after.name.empty())
+        {
+          values.erase(c.before.name);
+          continue;
+        }
+
+        values[c.after.name] = c.after;
+
+        if(summary.firstNaNStep == PixelDebugSummary::NoResult && ContainsNaN(c.after))
+        {
+          summary.firstNaNStep = state.stepIndex;
+          summary.firstNaNInstruction = instruction;
+          summary.firstNaNVariable = c.after.name;
+        }
+      }
+
+      summary.numSteps = state.stepIndex;
+      lastInstruction = state.nextInstruction;
+
+      if(!state.sourceVars.empty())
+        sourceVars = state.sourceVars;
+    }
+  }
+
+  SummariseOutputs(summary, trace->sourceVars, values);
+  SummariseOutputs(summary, sourceVars, values);
+
+  driver->FreeDebugger(trace->debugger);
+  delete trace;
+}
+
+TextureRegion ClampTextureRegion(const TextureRegion &region, uint32_t width, uint32_t height,
+                                 uint32_t depth, uint32_t blockSize)
+{
+  TextureRegion ret;
+
+  if(region.IsWhole())
+  {
+    ret.width = width;
+    ret.height = height;
+    ret.depth = depth;
+    return ret;
+  }
+
+  ret.x = RDCMIN(region.x, width - 1);
+  ret.y = RDCMIN(region.y, height - 1);
+  ret.z = RDCMIN(region.z, depth - 1);
+  ret.width = RDCMAX(1U, RDCMIN(region.width, width - ret.x));
+  ret.height = RDCMAX(1U, RDCMIN(region.height, height - ret.y));
+  ret.depth = RDCMAX(1U, RDCMIN(region.depth, depth - ret.z));
+
+  if(blockSize > 1)
+  {
+    // round the start down and the end up to block boundaries, though a partial block at the edge
+    // of the subresource only extends to its width or height
+    const uint32_t right = RDCMIN(AlignUp(ret.x + ret.width, blockSize), width);
+    const uint32_t bottom = RDCMIN(AlignUp(ret.y + ret.height, blockSize), height);
+
+    ret.x -= ret.x % blockSize;
+    ret.y -= ret.y % blockSize;
+    ret.width = right - ret.x;
+    ret.height = bottom - ret.y;
+  }
+
+  return ret;
+}
+
+void CropTextureData(const TextureDescription &tex, const Subresource &sub,
+                     const GetTextureDataParams &params, bytebuf &data)
+{
+  if(params.region.IsWhole() || data.empty())
+    return;
+
+  const ResourceFormat &fmt = tex.format;
+
+  // work out the size of each texel, or each block, in the data that was returned
+  uint32_t blockSize = 1;
+  size_t elemSize = fmt.ElementSize();
+
+  if(params.remap == RemapTexture::RGBA8)
+  {
+    elemSize = 4;
+  }
+  else if(params.remap == RemapTexture::RGBA16)
+  {
+    elemSize = 8;
+  }
+  else if(params.remap == RemapTexture::RGBA32)
+  {
+    elemSize = 16;
+  }
+  else if(fmt.type == ResourceFormatType::BC1 || fmt.type == ResourceFormatType::BC2 ||
+          fmt.type == ResourceFormatType::BC3 || fmt.type == ResourceFormatType::BC4 ||
+          fmt.type == ResourceFormatType::BC5 || fmt.type == ResourceFormatType::BC6 ||
+          fmt.type == ResourceFormatType::BC7 || fmt.type == ResourceFormatType::ETC2 ||
+          fmt.type == ResourceFormatType::EAC)
+  {
+    blockSize = 4;
+  }
+  else if(fmt.type == ResourceFormatType::ASTC || fmt.type == ResourceFormatType::PVRTC)
+  {
+    RDCERR("Can't crop %s texture data to a region", fmt.Name().c_str());
+    data.clear();
+    return;
+  }
+  else if(fmt.type == ResourceFormatType::D16S8)
+  {
+    // depth-stencil formats are returned padded
+    elemSize = 4;
+  }
+  else if(fmt.type == ResourceFormatType::D32S8)
+  {
+    elemSize = 8;
+  }
+
+  const uint32_t width = RDCMAX(1U, tex.width >> sub.mip);
+  const uint32_t height = RDCMAX(1U, tex.height >> sub.mip);
+  const uint32_t depth = tex.depth > 1 ? RDCMAX(1U, tex.depth >> sub.mip) : 1;
+
+  const TextureRegion region = ClampTextureRegion(params.region, width, height, depth, blockSize);
+
+  // everything from here on is in units of blocks, which are single texels for most formats
+  const size_t srcRowPitch = size_t(AlignUp(width, blockSize) / blockSize) * elemSize;
+  const size_t srcSlicePitch = srcRowPitch * (AlignUp(height, blockSize) / blockSize);
+  const size_t dstRowPitch = size_t(AlignUp(region.width, blockSize) / blockSize) * elemSize;
+  const uint32_t dstRows = AlignUp(region.height, blockSize) / blockSize;
+
+  if(data.size() < srcSlicePitch * depth)
+  {
+    RDCERR("Texture data is too small to crop: %zu for %ux%ux%u", data.size(), width, height,
+           depth);
+    data.clear();
+    return;
+  }
+
+  bytebuf cropped;
+  cropped.resize(dstRowPitch * dstRows * region.depth);
+
+  byte *dst = cropped.data();
+
+  for(uint32_t z = region.z; z < region.z + region.depth; z++)
+  {
+    const byte *src = data.data() + z * srcSlicePitch + (region.y / blockSize) * srcRowPitch +
+                      (region.x / blockSize) * elemSize;
+
+    for(uint32_t row = 0; row < dstRows; row++)
+    {
+      memcpy(dst, src, dstRowPitch);
+      dst += dstRowPitch;
+      src += srcRowPitch;
+    }
+  }
+
+  data.swap(cropped);
+}
+
 bytebuf GetDiscardPattern(DiscardType type, const ResourceFormat &fmt, uint32_t rowPitch, bool invert)
 {
   static const rdcliteral patterns[] = {
@@ -1580,3 +1971,167 @@ bytebuf GetDiscardPattern(DiscardType type, const ResourceFormat &fmt, uint32_t
 
   return ret;
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Crop texture data to a region", "[texregion]")
+{
+  TextureDescription tex;
+  tex.format.type = ResourceFormatType::Regular;
+  tex.format.compType = CompType::UNorm;
+  tex.format.compByteWidth = 1;
+  tex.format.compCount = 4;
+  tex.width = 16;
+  tex.height = 8;
+  tex.depth = 1;
+  tex.mips = 2;
+
+  // fills data with each texel's co-ordinates, to check which texels were kept
+  auto fill = [](bytebuf &data, uint32_t width, uint32_t height, uint32_t depth) {
+    data.resize(width * height * depth * 4);
+    for(uint32_t z = 0; z < depth; z++)
+    {
+      for(uint32_t y = 0; y < height; y++)
+      {
+        for(uint32_t x = 0; x < width; x++)
+        {
+          byte *texel = &data[((z * height + y) * width + x) * 4];
+          texel[0] = byte(x);
+          texel[1] = byte(y);
+          texel[2] = byte(z);
+          texel[3] = 0xff;
+        }
+      }
+    }
+  };
+
+  auto check = [](const bytebuf &data, uint32_t x, uint32_t y, uint32_t z, uint32_t width,
+                  uint32_t height, uint32_t depth) {
+    REQUIRE(data.size() == width * height * depth * 4);
+    for(uint32_t i = 0; i < width * height * depth; i++)
+    {
+      CHECK(data[i * 4 + 0] == x + i % width);
+      CHECK(data[i * 4 + 1] == y + (i / width) % height);
+      CHECK(data[i * 4 + 2] == z + i / (width * height));
+    }
+  };
+
+  GetTextureDataParams params;
+  bytebuf data;
+
+  SECTION("Whole subresource")
+  {
+    fill(data, 16, 8, 1);
+    bytebuf orig = data;
+    CropTextureData(tex, Subresource(), params, data);
+    CHECK(data == orig);
+  };
+
+  SECTION("Region within the subresource")
+  {
+    fill(data, 16, 8, 1);
+    params.region.x = 3;
+    params.region.y = 2;
+    params.region.width = 5;
+    params.region.height = 4;
+    CropTextureData(tex, Subresource(), params, data);
+    check(data, 3, 2, 0, 5, 4, 1);
+  };
+
+  SECTION("Region clamped to a mip")
+  {
+    fill(data, 8, 4, 1);
+    params.region.x = 6;
+    params.region.y = 1;
+    params.region.width = 100;
+    params.region.height = 100;
+    CropTextureData(tex, Subresource(1, 0, 0), params, data);
+    check(data, 6, 1, 0, 2, 3, 1);
+  };
+
+  SECTION("Slices of a 3D texture")
+  {
+    tex.depth = 4;
+    fill(data, 16, 8, 4);
+    params.region.x = 1;
+    params.region.y = 1;
+    params.region.z = 2;
+    params.region.width = 2;
+    params.region.height = 2;
+    params.region.depth = 2;
+    CropTextureData(tex, Subresource(), params, data);
+    check(data, 1, 1, 2, 2, 2, 2);
+  };
+
+  SECTION("Remapped data")
+  {
+    params.remap = RemapTexture::RGBA32;
+
+    // each float texel is 4 copies of the byte layout above
+    bytebuf bytes;
+    fill(bytes, 16, 8, 1);
+    data.resize(bytes.size() * 4);
+    for(size_t i = 0; i < bytes.size(); i++)
+      memcpy(&data[i * 4], &bytes[i], 1);
+
+    params.region.x = 4;
+    params.region.y = 3;
+    params.region.width = 2;
+    params.region.height = 1;
+    CropTextureData(tex, Subresource(), params, data);
+
+    REQUIRE(data.size() == 2 * 16);
+    CHECK(data[0] == 4);
+    CHECK(data[4] == 3);
+    CHECK(data[16] == 5);
+    CHECK(data[20] == 3);
+  };
+
+  SECTION("Block-compressed regions are expanded to whole blocks")
+  {
+    tex.format.type = ResourceFormatType::BC1;
+
+    TextureRegion region;
+    region.x = 5;
+    region.y = 2;
+    region.width = 1;
+    region.height = 5;
+
+    TextureRegion clamped = ClampTextureRegion(region, 16, 8, 1, 4);
+    CHECK(clamped.x == 4);
+    CHECK(clamped.y == 0);
+    CHECK(clamped.width == 4);
+    CHECK(clamped.height == 8);
+
+    // partial blocks at the edges only extend to the texture's size
+    clamped = ClampTextureRegion(region, 6, 6, 1, 4);
+    CHECK(clamped.x == 4);
+    CHECK(clamped.width == 2);
+    CHECK(clamped.height == 6);
+
+    // 4x2 blocks of 8 bytes, each block filled with its index
+    data.resize(4 * 2 * 8);
+    for(size_t i = 0; i < data.size(); i++)
+      data[i] = byte(i / 8);
+
+    params.region = region;
+    CropTextureData(tex, Subresource(), params, data);
+
+    REQUIRE(data.size() == 2 * 8);
+    CHECK(data[0] == 1);
+    CHECK(data[8] == 5);
+  };
+
+  SECTION("Not enough data")
+  {
+    fill(data, 16, 7, 1);
+    params.region.width = 1;
+    params.region.height = 1;
+    CropTextureData(tex, Subresource(), params, data);
+    CHECK(data.empty());
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
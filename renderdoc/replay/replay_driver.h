@@ -81,6 +81,21 @@ enum class RemapTexture : uint32_t
 
 DECLARE_REFLECTION_ENUM(RemapTexture);
 
+// a box within one subresource of a texture, in texels. A width of 0 means the whole subresource.
+struct TextureRegion
+{
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t z = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t depth = 0;
+
+  bool IsWhole() const { return width == 0; }
+};
+
+DECLARE_REFLECTION_STRUCT(TextureRegion);
+
 struct GetTextureDataParams
 {
   // this data is going to be saved to disk, so prepare it as needed. E.g. on GL flip Y order to
@@ -97,6 +112,9 @@ struct GetTextureDataParams
   RemapTexture remap = RemapTexture::NoRemap;
   float blackPoint = 0.0f;
   float whitePoint = 1.0f;
+  // only return this region of the subresource, tightly packed. For 3D textures z and depth select
+  // the slices. Regions of block-compressed data are expanded to whole blocks.
+  TextureRegion region;
 };
 
 DECLARE_REFLECTION_STRUCT(GetTextureDataParams);
@@ -203,9 +221,14 @@ public:
                                         uint32_t idx, uint32_t view) = 0;
   virtual ShaderDebugTrace *DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
                                        uint32_t primitive) = 0;
+  virtual rdcarray<PixelDebugSummary> DebugPixels(uint32_t eventId, uint32_t x, uint32_t y,
+                                                  uint32_t width, uint32_t height, uint32_t sample,
+                                                  uint32_t primitive) = 0;
   virtual ShaderDebugTrace *DebugThread(uint32_t eventId, const uint32_t groupid[3],
                                         const uint32_t threadid[3]) = 0;
   virtual rdcarray<ShaderDebugState> ContinueDebug(ShaderDebugger *debugger) = 0;
+  virtual rdcarray<ShaderDebugState> ContinueDebugToCondition(
+      ShaderDebugger *debugger, const ShaderDebugStopCondition &condition) = 0;
   virtual void FreeDebugger(ShaderDebugger *debugger) = 0;
 
   virtual ResourceId RenderOverlay(ResourceId texid, FloatVector clearCol, DebugOverlay overlay,
@@ -358,6 +381,46 @@ enum class DiscardType : int
 static constexpr uint32_t DiscardPatternWidth = 64;
 static constexpr uint32_t DiscardPatternHeight = 8;
 
+// the most pixels that DebugPixels will debug in one request
+static constexpr uint32_t MaxSummarisedDebugPixels = 64 * 64;
+
+// runs ContinueDebug on the driver until a state matches the condition, merging the changes of all
+// skipped states into the returned stop state.
+rdcarray<ShaderDebugState> ContinueDebugUntil(IRemoteDriver *driver, ShaderDebugger *debugger,
+                                              const ShaderDebugStopCondition &condition);
+
+// drivers fetch the pixel shader inputs for a whole rectangle of pixels in one replay of the event,
+// then build a trace for each pixel that was hit and hand ownership of it to this callback.
+typedef std::function<void(uint32_t x, uint32_t y, ShaderDebugTrace *trace)> PixelDebugCallback;
+
+// how many fragments to make room for when fetching the inputs of a rectangle of pixels. A single
+// pixel keeps up to 100 levels of overdraw, larger rectangles keep 8 per pixel on average.
+inline uint32_t PixelDebugHitCapacity(uint32_t width, uint32_t height)
+{
+  return width * height <= 1 ? 100 : width * height * 8;
+}
+
+// creates the row-major list of summaries for DebugPixels, with each pixel's co-ordinates filled
+// in. Rectangles larger than MaxSummarisedDebugPixels are rejected and return an empty list.
+rdcarray<PixelDebugSummary> PrepareDebugPixelSummaries(uint32_t x, uint32_t y, uint32_t width,
+                                                       uint32_t height);
+
+// runs a pixel's trace to completion on the replay side and fills in its summary. The trace and its
+// debugger are freed.
+void SummariseDebugTrace(IRemoteDriver *driver, ShaderDebugTrace *trace,
+                         PixelDebugSummary &summary);
+
+// clamps a region to a subresource of the given dimensions. A whole region is expanded to the full
+// subresource, and for block-compressed data (blockSize > 1) the region is expanded to whole
+// blocks.
+TextureRegion ClampTextureRegion(const TextureRegion &region, uint32_t width, uint32_t height,
+                                 uint32_t depth, uint32_t blockSize);
+
+// for drivers that can't crop to params.region while reading back, crops the data returned from
+// GetTextureData for the whole subresource down to the region.
+void CropTextureData(const TextureDescription &tex, const Subresource &sub,
+                     const GetTextureDataParams &params, bytebuf &data);
+
 // returns a pattern to fill the texture with
 bytebuf GetDiscardPattern(DiscardType type, const ResourceFormat &fmt, uint32_t rowPitch = 1,
                           bool invert = false);
@@ -0,0 +1,1075 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "texture_stats.h"
+#include <float.h>
+#include <math.h>
+#include "common/block_decode.h"
+#include "common/job_queue.h"
+#include "data/glsl/glsl_globals.h"
+#include "maths/formatpacking.h"
+#include "replay_driver.h"
+
+#if ENABLED(RDOC_SSE2)
+#include <emmintrin.h>
+#endif
+
+// how many texels each job decodes at once, to keep the decoded floats in cache
+static const size_t TexelChunkSize = 4096;
+
+static size_t TexelStride(const ResourceFormat &fmt)
+{
+  // depth-stencil formats are returned padded from GetTextureData
+  if(fmt.type == ResourceFormatType::D16S8)
+    return 4;
+  else if(fmt.type == ResourceFormatType::D32S8)
+    return 8;
+
+  return fmt.ElementSize();
+}
+
+static bool IsBlockFormat(const ResourceFormat &fmt)
+{
+  return fmt.type == ResourceFormatType::BC1 || fmt.type == ResourceFormatType::BC2 ||
+         fmt.type == ResourceFormatType::BC3 || fmt.type == ResourceFormatType::BC4 ||
+         fmt.type == ResourceFormatType::BC5 || fmt.type == ResourceFormatType::BC6 ||
+         fmt.type == ResourceFormatType::BC7 || fmt.type == ResourceFormatType::ETC2 ||
+         fmt.type == ResourceFormatType::EAC || fmt.type == ResourceFormatType::ASTC;
+}
+
+// the size of one depth slice of data
+static size_t SliceSize(const ResourceFormat &fmt, uint32_t width, uint32_t height)
+{
+  if(IsBlockFormat(fmt))
+    return size_t(AlignUp4(width) / 4) * size_t(AlignUp4(height) / 4) * fmt.ElementSize();
+
+  return size_t(width) * height * TexelStride(fmt);
+}
+
+static bool CanDecodeTexels(const ResourceFormat &fmt)
+{
+  if(IsBlockFormat(fmt))
+    return IsBlockDecodeSupported(fmt);
+
+  bool success = true;
+  DecodeFormattedComponents(fmt, NULL, &success);
+  return success;
+}
+
+static ResourceFormat RGBA32Float()
+{
+  ResourceFormat ret;
+  ret.type = ResourceFormatType::Regular;
+  ret.compType = CompType::Float;
+  ret.compByteWidth = 4;
+  ret.compCount = 4;
+  return ret;
+}
+
+// calls func(texels, count) with every texel in the data decoded to floats, in chunks spread over
+// jobs. Each call to func is for one job's chunk, and chunks can be processed concurrently.
+template <typename Func>
+static bool ForEachTexelChunk(const ResourceFormat &fmt, const byte *data, size_t dataSize,
+                              uint32_t width, uint32_t height, uint32_t depth,
+                              Threading::JobQueue *jobs, Func func)
+{
+  if(dataSize < SliceSize(fmt, width, height) * depth)
+  {
+    RDCERR("Not enough data for %ux%ux%u %s texture", width, height, depth, fmt.Name().c_str());
+    return false;
+  }
+
+  if(!CanDecodeTexels(fmt))
+    return false;
+
+  if(IsBlockFormat(fmt))
+  {
+    const ResourceFormat rgba32 = RGBA32Float();
+
+    // each row of blocks is decoded on its own as a subresource at most 4 texels high
+    const size_t blocksWide = AlignUp4(width) / 4;
+    const size_t blocksHigh = AlignUp4(height) / 4;
+    const size_t blockRowSize = blocksWide * fmt.ElementSize();
+
+    const size_t minRows = RDCMAX((size_t)1U, TexelChunkSize / (blocksWide * 16));
+
+    Threading::ParallelFor(jobs, blocksHigh * depth, minRows, [&](size_t begin, size_t end) {
+      rdcarray<FloatVector> texels;
+      texels.resize(width * 4);
+
+      for(size_t blockRow = begin; blockRow < end; blockRow++)
+      {
+        const uint32_t rows = RDCMIN(4U, height - uint32_t(blockRow % blocksHigh) * 4);
+
+        DecodeBlockCompressed(fmt, data + blockRow * blockRowSize, blockRowSize, width, rows, 1,
+                              rgba32, (byte *)texels.data(), NULL);
+
+        func(texels.data(), size_t(width) * rows);
+      }
+    });
+
+    return true;
+  }
+
+  const size_t stride = TexelStride(fmt);
+  const size_t count = size_t(width) * height * depth;
+
+  Threading::ParallelFor(jobs, count, TexelChunkSize, [&](size_t begin, size_t end) {
+    rdcarray<FloatVector> texels;
+    texels.resize(RDCMIN(TexelChunkSize, end - begin));
+
+    for(size_t i = begin; i < end; i += TexelChunkSize)
+    {
+      const size_t num = RDCMIN(TexelChunkSize, end - i);
+      DecodeFormattedComponentsSpan(fmt, data + i * stride, stride, num, texels.data());
+      func(texels.data(), num);
+    }
+  });
+
+  return true;
+}
+
+bool CalcTextureMinMax(const ResourceFormat &fmt, const byte *data, size_t dataSize, uint32_t width,
+                       uint32_t height, uint32_t depth, float minval[4], float maxval[4],
+                       Threading::JobQueue *jobs)
+{
+  FloatVector totalMin(FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
+  FloatVector totalMax(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+  Threading::CriticalSection lock;
+
+  auto reduce = [&](const FloatVector *texels, size_t count) {
+#if ENABLED(RDOC_SSE2)
+    // NaNs are ignored, as on the GPU. With a NaN in the first operand these return the second
+    __m128 mn = _mm_set1_ps(FLT_MAX);
+    __m128 mx = _mm_set1_ps(-FLT_MAX);
+
+    for(size_t i = 0; i < count; i++)
+    {
+      __m128 v = _mm_loadu_ps(&texels[i].x);
+      mn = _mm_min_ps(v, mn);
+      mx = _mm_max_ps(v, mx);
+    }
+
+    FloatVector localMin, localMax;
+    _mm_storeu_ps(&localMin.x, mn);
+    _mm_storeu_ps(&localMax.x, mx);
+#else
+    FloatVector localMin(FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
+    FloatVector localMax(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    for(size_t i = 0; i < count; i++)
+    {
+      const float *v = &texels[i].x;
+      float *lmin = &localMin.x;
+      float *lmax = &localMax.x;
+
+      // comparisons are false for NaNs, so they are ignored as on the GPU
+      for(int c = 0; c < 4; c++)
+      {
+        if(v[c] < lmin[c])
+          lmin[c] = v[c];
+        if(v[c] > lmax[c])
+          lmax[c] = v[c];
+      }
+    }
+#endif
+
+    SCOPED_LOCK(lock);
+    for(int c = 0; c < 4; c++)
+    {
+      if((&localMin.x)[c] < (&totalMin.x)[c])
+        (&totalMin.x)[c] = (&localMin.x)[c];
+      if((&localMax.x)[c] > (&totalMax.x)[c])
+        (&totalMax.x)[c] = (&localMax.x)[c];
+    }
+  };
+
+  if(!ForEachTexelChunk(fmt, data, dataSize, width, height, depth, jobs, reduce))
+    return false;
+
+  memcpy(minval, &totalMin, sizeof(float) * 4);
+  memcpy(maxval, &totalMax, sizeof(float) * 4);
+
+  return true;
+}
+
+bool CalcTextureHistogram(const ResourceFormat &fmt, const byte *data, size_t dataSize,
+                          uint32_t width, uint32_t height, uint32_t depth, float minval,
+                          float maxval, const bool channels[4], rdcarray<uint32_t> &histogram,
+                          Threading::JobQueue *jobs)
+{
+  if(minval >= maxval)
+    return false;
+
+  rdcarray<uint32_t> total;
+  total.resize(HGRAM_NUM_BUCKETS);
+  Threading::CriticalSection lock;
+
+  const float range = maxval - minval;
+
+  auto reduce = [&](const FloatVector *texels, size_t count) {
+    uint32_t local[HGRAM_NUM_BUCKETS] = {};
+
+    // values are bucketed as floor((v - min) / (max - min) * N) exactly as on the GPU, and
+    // anything outside [0, N) including NaNs isn't counted.
+#if ENABLED(RDOC_SSE2)
+    const __m128 vmin = _mm_set1_ps(minval);
+    const __m128 vrange = _mm_set1_ps(range);
+    const __m128 vbuckets = _mm_set1_ps(float(HGRAM_NUM_BUCKETS));
+    const __m128 zero = _mm_setzero_ps();
+
+    const int channelMask = (channels[0] ? 1 : 0) | (channels[1] ? 2 : 0) |
+                            (channels[2] ? 4 : 0) | (channels[3] ? 8 : 0);
+
+    alignas(16) int32_t idx[4];
+
+    for(size_t i = 0; i < count; i++)
+    {
+      __m128 v = _mm_loadu_ps(&texels[i].x);
+      __m128 n = _mm_mul_ps(_mm_div_ps(_mm_sub_ps(v, vmin), vrange), vbuckets);
+
+      const int valid =
+          _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(n, zero), _mm_cmplt_ps(n, vbuckets))) &
+          channelMask;
+
+      if(valid == 0)
+        continue;
+
+      _mm_store_si128((__m128i *)idx, _mm_cvttps_epi32(n));
+
+      for(int c = 0; c < 4; c++)
+        if(valid & (1 << c))
+          local[idx[c]]++;
+    }
+#else
+    for(size_t i = 0; i < count; i++)
+    {
+      const float *v = &texels[i].x;
+
+      for(int c = 0; c < 4; c++)
+      {
+        if(!channels[c])
+          continue;
+
+        float n = (v[c] - minval) / range * float(HGRAM_NUM_BUCKETS);
+
+        if(n >= 0.0f && n < float(HGRAM_NUM_BUCKETS))
+          local[uint32_t(n)]++;
+      }
+    }
+#endif
+
+    SCOPED_LOCK(lock);
+    for(uint32_t b = 0; b < HGRAM_NUM_BUCKETS; b++)
+      total[b] += local[b];
+  };
+
+  if(!ForEachTexelChunk(fmt, data, dataSize, width, height, depth, jobs, reduce))
+    return false;
+
+  histogram.swap(total);
+
+  return true;
+}
+
+// SSIM is calculated over square windows of this many texels, each within one slice
+static const uint32_t SSIMWindowSize = 8;
+
+// the standard SSIM stabilising constants (0.01 * L)^2 and (0.03 * L)^2, for a dynamic range L of 1
+static const float SSIMC1 = 0.0001f;
+static const float SSIMC2 = 0.0009f;
+
+// decodes rows [y, y + rows) of slice z to floats. For block formats y must be a multiple of 4
+static void DecodeTexelRows(const ResourceFormat &fmt, const byte *data, uint32_t width,
+                            uint32_t height, uint32_t z, uint32_t y, uint32_t rows,
+                            FloatVector *out)
+{
+  data += SliceSize(fmt, width, height) * z;
+
+  if(IsBlockFormat(fmt))
+  {
+    const size_t blockRowSize = size_t(AlignUp4(width) / 4) * fmt.ElementSize();
+
+    DecodeBlockCompressed(fmt, data + blockRowSize * (y / 4), blockRowSize * (AlignUp4(rows) / 4),
+                          width, rows, 1, RGBA32Float(), (byte *)out, NULL);
+  }
+  else
+  {
+    const size_t stride = TexelStride(fmt);
+
+    DecodeFormattedComponentsSpan(fmt, data + size_t(y) * width * stride, stride,
+                                  size_t(width) * rows, out);
+  }
+}
+
+// per-channel totals of the comparison metrics, accumulated per SSIM window
+struct ComparisonTotals
+{
+  double absError[4] = {};
+  double sqError[4] = {};
+  double ssim[4] = {};
+  float maxAbsError[4] = {};
+  float maxRelError[4] = {};
+  uint64_t differingTexels = 0;
+  uint64_t windows = 0;
+
+  void Add(const ComparisonTotals &o)
+  {
+    for(int c = 0; c < 4; c++)
+    {
+      absError[c] += o.absError[c];
+      sqError[c] += o.sqError[c];
+      ssim[c] += o.ssim[c];
+      if(o.maxAbsError[c] > maxAbsError[c])
+        maxAbsError[c] = o.maxAbsError[c];
+      if(o.maxRelError[c] > maxRelError[c])
+        maxRelError[c] = o.maxRelError[c];
+    }
+
+    differingTexels += o.differingTexels;
+    windows += o.windows;
+  }
+};
+
+// compares up to SSIMWindowSize rows of tightly packed texels, writing the absolute differences to
+// diff if it's not NULL.
+static void CompareTexelRows(const FloatVector *a, const FloatVector *b, uint32_t width,
+                             uint32_t rows, float threshold, FloatVector *diff,
+                             ComparisonTotals &totals)
+{
+#if ENABLED(RDOC_SSE2)
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 vthreshold = _mm_set1_ps(threshold);
+  const __m128 c1 = _mm_set1_ps(SSIMC1);
+  const __m128 c2 = _mm_set1_ps(SSIMC2);
+  const __m128 two = _mm_set1_ps(2.0f);
+
+  // NaNs are ignored in the maximums, since with a NaN in the first operand these return the second
+  __m128 maxAbs = _mm_loadu_ps(totals.maxAbsError);
+  __m128 maxRel = _mm_loadu_ps(totals.maxRelError);
+
+  for(uint32_t wx = 0; wx < width; wx += SSIMWindowSize)
+  {
+    const uint32_t windowWidth = RDCMIN(SSIMWindowSize, width - wx);
+
+    __m128 absSum = _mm_setzero_ps(), sqSum = _mm_setzero_ps();
+    __m128 sa = _mm_setzero_ps(), sb = _mm_setzero_ps();
+    __m128 saa = _mm_setzero_ps(), sbb = _mm_setzero_ps(), sab = _mm_setzero_ps();
+
+    for(uint32_t y = 0; y < rows; y++)
+    {
+      for(size_t i = y * width + wx, end = i + windowWidth; i < end; i++)
+      {
+        __m128 va = _mm_loadu_ps(&a[i].x);
+        __m128 vb = _mm_loadu_ps(&b[i].x);
+        __m128 d = _mm_sub_ps(va, vb);
+        __m128 ad = _mm_andnot_ps(signMask, d);
+
+        absSum = _mm_add_ps(absSum, ad);
+        sqSum = _mm_add_ps(sqSum, _mm_mul_ps(d, d));
+
+        // where both values are 0 this is NaN, so they're ignored
+        __m128 larger = _mm_max_ps(_mm_andnot_ps(signMask, va), _mm_andnot_ps(signMask, vb));
+        maxAbs = _mm_max_ps(ad, maxAbs);
+        maxRel = _mm_max_ps(_mm_div_ps(ad, larger), maxRel);
+
+        // not-less-or-equal, so that NaNs count as differing
+        if(_mm_movemask_ps(_mm_cmpnle_ps(ad, vthreshold)))
+          totals.differingTexels++;
+
+        if(diff)
+          _mm_storeu_ps(&diff[i].x, ad);
+
+        sa = _mm_add_ps(sa, va);
+        sb = _mm_add_ps(sb, vb);
+        saa = _mm_add_ps(saa, _mm_mul_ps(va, va));
+        sbb = _mm_add_ps(sbb, _mm_mul_ps(vb, vb));
+        sab = _mm_add_ps(sab, _mm_mul_ps(va, vb));
+      }
+    }
+
+    const __m128 n = _mm_set1_ps(1.0f / float(windowWidth * rows));
+    const __m128 meanA = _mm_mul_ps(sa, n);
+    const __m128 meanB = _mm_mul_ps(sb, n);
+    const __m128 meanAB = _mm_mul_ps(meanA, meanB);
+    const __m128 varA = _mm_sub_ps(_mm_mul_ps(saa, n), _mm_mul_ps(meanA, meanA));
+    const __m128 varB = _mm_sub_ps(_mm_mul_ps(sbb, n), _mm_mul_ps(meanB, meanB));
+    const __m128 cov = _mm_sub_ps(_mm_mul_ps(sab, n), meanAB);
+
+    const __m128 numerator = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(two, meanAB), c1),
+                                        _mm_add_ps(_mm_mul_ps(two, cov), c2));
+    const __m128 denominator =
+        _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(meanA, meanA), _mm_mul_ps(meanB, meanB)), c1),
+                   _mm_add_ps(_mm_add_ps(varA, varB), c2));
+
+    float windowAbs[4], windowSq[4], windowSSIM[4];
+    _mm_storeu_ps(windowAbs, absSum);
+    _mm_storeu_ps(windowSq, sqSum);
+    _mm_storeu_ps(windowSSIM, _mm_div_ps(numerator, denominator));
+
+    for(int c = 0; c < 4; c++)
+    {
+      totals.absError[c] += windowAbs[c];
+      totals.sqError[c] += windowSq[c];
+      totals.ssim[c] += windowSSIM[c];
+    }
+
+    totals.windows++;
+  }
+
+  _mm_storeu_ps(totals.maxAbsError, maxAbs);
+  _mm_storeu_ps(totals.maxRelError, maxRel);
+#else
+  for(uint32_t wx = 0; wx < width; wx += SSIMWindowSize)
+  {
+    const uint32_t windowWidth = RDCMIN(SSIMWindowSize, width - wx);
+
+    float absSum[4] = {}, sqSum[4] = {};
+    float sa[4] = {}, sb[4] = {}, saa[4] = {}, sbb[4] = {}, sab[4] = {};
+
+    for(uint32_t y = 0; y < rows; y++)
+    {
+      for(size_t i = y * width + wx, end = i + windowWidth; i < end; i++)
+      {
+        const float *va = &a[i].x;
+        const float *vb = &b[i].x;
+        bool differs = false;
+
+        for(int c = 0; c < 4; c++)
+        {
+          const float d = va[c] - vb[c];
+          const float ad = fabsf(d);
+
+          absSum[c] += ad;
+          sqSum[c] += d * d;
+
+          // comparisons are false for NaNs, so they are ignored in the maximums. Where both values
+          // are 0 the relative error is NaN, so they're ignored too
+          const float rel = ad / RDCMAX(fabsf(va[c]), fabsf(vb[c]));
+          if(ad > totals.maxAbsError[c])
+            totals.maxAbsError[c] = ad;
+          if(rel > totals.maxRelError[c])
+            totals.maxRelError[c] = rel;
+
+          // NaNs count as differing
+          if(!(ad <= threshold))
+            differs = true;
+
+          if(diff)
+            (&diff[i].x)[c] = ad;
+
+          sa[c] += va[c];
+          sb[c] += vb[c];
+          saa[c] += va[c] * va[c];
+          sbb[c] += vb[c] * vb[c];
+          sab[c] += va[c] * vb[c];
+        }
+
+        if(differs)
+          totals.differingTexels++;
+      }
+    }
+
+    const float n = 1.0f / float(windowWidth * rows);
+
+    for(int c = 0; c < 4; c++)
+    {
+      const float meanA = sa[c] * n;
+      const float meanB = sb[c] * n;
+      const float varA = saa[c] * n - meanA * meanA;
+      const float varB = sbb[c] * n - meanB * meanB;
+      const float cov = sab[c] * n - meanA * meanB;
+
+      totals.absError[c] += absSum[c];
+      totals.sqError[c] += sqSum[c];
+      totals.ssim[c] += ((2.0f * meanA * meanB + SSIMC1) * (2.0f * cov + SSIMC2)) /
+                        ((meanA * meanA + meanB * meanB + SSIMC1) * (varA + varB + SSIMC2));
+    }
+
+    totals.windows++;
+  }
+#endif
+}
+
+bool CompareTextureData(const ResourceFormat &fmtA, const byte *dataA, size_t dataSizeA,
+                        const ResourceFormat &fmtB, const byte *dataB, size_t dataSizeB,
+                        uint32_t width, uint32_t height, uint32_t depth, float threshold,
+                        bool diffImage, TextureComparison &result, Threading::JobQueue *jobs)
+{
+  result = TextureComparison();
+
+  if(width == 0 || height == 0 || depth == 0)
+    return false;
+
+  if(!CanDecodeTexels(fmtA) || !CanDecodeTexels(fmtB))
+    return false;
+
+  if(dataSizeA < SliceSize(fmtA, width, height) * depth ||
+     dataSizeB < SliceSize(fmtB, width, height) * depth)
+  {
+    RDCERR("Not enough data to compare %ux%ux%u textures", width, height, depth);
+    return false;
+  }
+
+  FloatVector *diff = NULL;
+  if(diffImage)
+  {
+    result.diffImage.resize(size_t(width) * height * depth * sizeof(FloatVector));
+    diff = (FloatVector *)result.diffImage.data();
+  }
+
+  // each job compares bands of rows one window high, so that windows aren't split between jobs
+  const size_t bandsHigh = (height + SSIMWindowSize - 1) / SSIMWindowSize;
+  const size_t minBands = RDCMAX((size_t)1U, TexelChunkSize / (size_t(width) * SSIMWindowSize));
+
+  ComparisonTotals totals;
+  Threading::CriticalSection lock;
+
+  Threading::ParallelFor(jobs, bandsHigh * depth, minBands, [&](size_t begin, size_t end) {
+    rdcarray<FloatVector> texelsA, texelsB;
+    texelsA.resize(width * SSIMWindowSize);
+    texelsB.resize(width * SSIMWindowSize);
+
+    ComparisonTotals local;
+
+    for(size_t band = begin; band < end; band++)
+    {
+      const uint32_t z = uint32_t(band / bandsHigh);
+      const uint32_t y = uint32_t(band % bandsHigh) * SSIMWindowSize;
+      const uint32_t rows = RDCMIN(SSIMWindowSize, height - y);
+
+      DecodeTexelRows(fmtA, dataA, width, height, z, y, rows, texelsA.data());
+      DecodeTexelRows(fmtB, dataB, width, height, z, y, rows, texelsB.data());
+
+      CompareTexelRows(texelsA.data(), texelsB.data(), width, rows, threshold,
+                       diff ? diff + (size_t(z) * height + y) * width : NULL, local);
+    }
+
+    SCOPED_LOCK(lock);
+    totals.Add(local);
+  });
+
+  const double count = double(width) * height * depth;
+
+  result.valid = true;
+  result.width = width;
+  result.height = height;
+  result.depth = depth;
+  result.differingTexels = totals.differingTexels;
+
+  for(int c = 0; c < 4; c++)
+  {
+    const double mse = totals.sqError[c] / count;
+
+    (&result.maxAbsError.x)[c] = totals.maxAbsError[c];
+    (&result.maxRelError.x)[c] = totals.maxRelError[c];
+    (&result.meanAbsError.x)[c] = float(totals.absError[c] / count);
+    (&result.meanSquaredError.x)[c] = float(mse);
+    (&result.psnr.x)[c] = mse == 0.0 ? INFINITY : float(10.0 * log10(1.0 / mse));
+    (&result.ssim.x)[c] = float(totals.ssim[c] / double(totals.windows));
+  }
+
+  return true;
+}
+
+bool FetchTextureStatisticsData(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                                CompType typeCast, bytebuf &data, ResourceFormat &fmt,
+                                uint32_t &width, uint32_t &height, uint32_t &depth)
+{
+  TextureDescription tex = driver->GetTexture(texid);
+
+  if(tex.resourceId == ResourceId() || sub.mip >= tex.mips)
+    return false;
+
+  fmt = tex.format;
+
+  // apply the cast if the data can be decoded that way
+  if(typeCast != CompType::Typeless)
+  {
+    ResourceFormat cast = fmt;
+    cast.compType = typeCast;
+
+    if(CanDecodeTexels(cast))
+      fmt = cast;
+  }
+
+  GetTextureDataParams params;
+  params.standardLayout = true;
+
+  driver->GetTextureData(texid, sub, params, data);
+
+  if(data.empty())
+    return false;
+
+  width = RDCMAX(1U, tex.width >> sub.mip);
+  height = RDCMAX(1U, tex.height >> sub.mip);
+  depth = RDCMAX(1U, tex.depth >> sub.mip);
+
+  return true;
+}
+
+// fetches the data for sub, and finds where the selected slice starts. 3D textures return the
+// whole mip, but the statistics are only for that slice
+static bool FetchStatisticsSlice(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                                 CompType typeCast, bytebuf &data, ResourceFormat &fmt,
+                                 size_t &offset, uint32_t &width, uint32_t &height)
+{
+  uint32_t depth = 1;
+
+  if(!FetchTextureStatisticsData(driver, texid, sub, typeCast, data, fmt, width, height, depth))
+    return false;
+
+  offset = SliceSize(fmt, width, height) * RDCMIN(sub.slice, depth - 1);
+
+  return offset < data.size();
+}
+
+bool CPUGetMinMax(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                  CompType typeCast, float *minval, float *maxval)
+{
+  bytebuf data;
+  ResourceFormat fmt;
+  size_t offset = 0;
+  uint32_t width = 0, height = 0;
+
+  if(!FetchStatisticsSlice(driver, texid, sub, typeCast, data, fmt, offset, width, height))
+    return false;
+
+  Threading::JobQueue jobs;
+  return CalcTextureMinMax(fmt, data.data() + offset, data.size() - offset, width, height, 1,
+                           minval, maxval, &jobs);
+}
+
+bool CPUGetHistogram(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                     CompType typeCast, float minval, float maxval, const bool channels[4],
+                     rdcarray<uint32_t> &histogram)
+{
+  bytebuf data;
+  ResourceFormat fmt;
+  size_t offset = 0;
+  uint32_t width = 0, height = 0;
+
+  if(!FetchStatisticsSlice(driver, texid, sub, typeCast, data, fmt, offset, width, height))
+    return false;
+
+  Threading::JobQueue jobs;
+  return CalcTextureHistogram(fmt, data.data() + offset, data.size() - offset, width, height, 1,
+                              minval, maxval, channels, histogram, &jobs);
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+static void RandomTexels(rdcarray<byte> &bytes, uint32_t seed)
+{
+  for(byte &b : bytes)
+  {
+    seed = seed * 1103515245U + 12345U;
+    b = byte(seed >> 16);
+  }
+}
+
+// straightforward per-texel implementation of what the statistics should be
+static void ReferenceStatistics(const rdcarray<FloatVector> &texels, float hmin, float hmax,
+                                const bool channels[4], FloatVector &minval, FloatVector &maxval,
+                                rdcarray<uint32_t> &histogram)
+{
+  minval = FloatVector(FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
+  maxval = FloatVector(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+  histogram.clear();
+  histogram.resize(HGRAM_NUM_BUCKETS);
+
+  for(const FloatVector &t : texels)
+  {
+    const float *v = &t.x;
+    for(int c = 0; c < 4; c++)
+    {
+      if(v[c] != v[c])
+        continue;
+
+      if(v[c] < (&minval.x)[c])
+        (&minval.x)[c] = v[c];
+      if(v[c] > (&maxval.x)[c])
+        (&maxval.x)[c] = v[c];
+
+      float n = (v[c] - hmin) / (hmax - hmin) * float(HGRAM_NUM_BUCKETS);
+      if(channels[c] && n >= 0.0f && n < float(HGRAM_NUM_BUCKETS))
+        histogram[uint32_t(n)]++;
+    }
+  }
+}
+
+TEST_CASE("CPU texture statistics match per-texel reference", "[texturestats]")
+{
+  const uint32_t width = 37, height = 19, depth = 3;
+
+  rdcarray<ResourceFormat> formats;
+
+  {
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::Regular;
+    fmt.compCount = 4;
+    fmt.compByteWidth = 1;
+    fmt.compType = CompType::UNorm;
+    formats.push_back(fmt);
+    fmt.compType = CompType::UNormSRGB;
+    formats.push_back(fmt);
+    fmt.compType = CompType::SNorm;
+    formats.push_back(fmt);
+
+    // includes NaNs and infinities
+    fmt.compByteWidth = 2;
+    fmt.compCount = 3;
+    fmt.compType = CompType::Float;
+    formats.push_back(fmt);
+
+    fmt.compByteWidth = 4;
+    fmt.compCount = 1;
+    fmt.compType = CompType::UInt;
+    formats.push_back(fmt);
+
+    fmt.type = ResourceFormatType::R10G10B10A2;
+    fmt.compCount = 4;
+    fmt.compType = CompType::UNorm;
+    formats.push_back(fmt);
+
+    fmt.type = ResourceFormatType::BC1;
+    fmt.compType = CompType::UNorm;
+    formats.push_back(fmt);
+
+    fmt.type = ResourceFormatType::BC5;
+    fmt.compCount = 2;
+    fmt.compType = CompType::SNorm;
+    formats.push_back(fmt);
+  }
+
+  const bool allChannels[4] = {true, true, true, true};
+  const bool someChannels[4] = {false, true, false, true};
+
+  Threading::JobQueue jobs;
+
+  for(const ResourceFormat &fmt : formats)
+  {
+    INFO("Format " << fmt.Name().c_str());
+
+    const bool block = IsBlockFormat(fmt);
+
+    rdcarray<byte> data;
+    data.resize(SliceSize(fmt, width, height) * depth);
+    RandomTexels(data, 0x5eed + (uint32_t)fmt.type);
+
+    rdcarray<FloatVector> texels;
+    texels.resize(width * height * depth);
+
+    if(block)
+    {
+      ResourceFormat rgba32;
+      rgba32.type = ResourceFormatType::Regular;
+      rgba32.compType = CompType::Float;
+      rgba32.compByteWidth = 4;
+      rgba32.compCount = 4;
+      REQUIRE(DecodeBlockCompressed(fmt, data.data(), data.size(), width, height, depth, rgba32,
+                                    (byte *)texels.data(), NULL));
+    }
+    else
+    {
+      for(size_t i = 0; i < texels.size(); i++)
+        texels[i] = DecodeFormattedComponents(fmt, data.data() + i * fmt.ElementSize());
+    }
+
+    // a range which cuts off some values at both ends
+    const float hmin = fmt.compType == CompType::UInt ? 1.0e9f : 0.1f;
+    const float hmax = fmt.compType == CompType::UInt ? 3.0e9f : 0.9f;
+
+    for(const bool *channels : {allChannels, someChannels})
+    {
+      FloatVector refMin, refMax;
+      rdcarray<uint32_t> refHistogram;
+      ReferenceStatistics(texels, hmin, hmax, channels, refMin, refMax, refHistogram);
+
+      for(Threading::JobQueue *queue : {(Threading::JobQueue *)NULL, &jobs})
+      {
+        FloatVector minval, maxval;
+        REQUIRE(CalcTextureMinMax(fmt, data.data(), data.size(), width, height, depth, &minval.x,
+                                  &maxval.x, queue));
+
+        for(int c = 0; c < 4; c++)
+        {
+          CHECK((&minval.x)[c] == (&refMin.x)[c]);
+          CHECK((&maxval.x)[c] == (&refMax.x)[c]);
+        }
+
+        rdcarray<uint32_t> histogram;
+        REQUIRE(CalcTextureHistogram(fmt, data.data(), data.size(), width, height, depth, hmin,
+                                     hmax, channels, histogram, queue));
+
+        CHECK(histogram == refHistogram);
+      }
+    }
+  }
+
+  SECTION("Invalid parameters")
+  {
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::Regular;
+    fmt.compCount = 4;
+    fmt.compByteWidth = 1;
+    fmt.compType = CompType::UNorm;
+
+    rdcarray<byte> data;
+    data.resize(width * height * 4);
+
+    float minval[4], maxval[4];
+    rdcarray<uint32_t> histogram;
+
+    CHECK_FALSE(CalcTextureMinMax(fmt, data.data(), data.size() - 1, width, height, 1, minval,
+                                  maxval, NULL));
+    CHECK_FALSE(CalcTextureHistogram(fmt, data.data(), data.size(), width, height, 1, 0.5f, 0.5f,
+                                     allChannels, histogram, NULL));
+
+    fmt.type = ResourceFormatType::ASTC;
+    CHECK_FALSE(CalcTextureMinMax(fmt, data.data(), data.size(), 4, 4, 1, minval, maxval, NULL));
+  };
+}
+
+TEST_CASE("CPU texture comparison matches per-texel reference", "[texturestats]")
+{
+  const uint32_t width = 37, height = 19, depth = 3;
+  const size_t count = width * height * depth;
+
+  ResourceFormat rgba8;
+  rgba8.type = ResourceFormatType::Regular;
+  rgba8.compCount = 4;
+  rgba8.compByteWidth = 1;
+  rgba8.compType = CompType::UNorm;
+
+  ResourceFormat rgba16f = rgba8;
+  rgba16f.compByteWidth = 2;
+  rgba16f.compType = CompType::Float;
+
+  const ResourceFormat rgba32f = RGBA32Float();
+
+  rdcarray<byte> dataA;
+  dataA.resize(count * 4);
+  RandomTexels(dataA, 0xd1ff);
+
+  rdcarray<FloatVector> texelsA;
+  texelsA.resize(count);
+  for(size_t i = 0; i < count; i++)
+    texelsA[i] = DecodeFormattedComponents(rgba8, dataA.data() + i * 4);
+
+  Threading::JobQueue jobs;
+
+  SECTION("Identical textures in different formats")
+  {
+    for(Threading::JobQueue *queue : {(Threading::JobQueue *)NULL, &jobs})
+    {
+      TextureComparison result;
+      REQUIRE(CompareTextureData(rgba8, dataA.data(), dataA.size(), rgba32f,
+                                 (const byte *)texelsA.data(), count * sizeof(FloatVector), width,
+                                 height, depth, 0.0f, false, result, queue));
+
+      CHECK(result.valid);
+      CHECK(result.width == width);
+      CHECK(result.height == height);
+      CHECK(result.depth == depth);
+      CHECK(result.differingTexels == 0);
+      CHECK(result.maxAbsError == FloatVector());
+      CHECK(result.meanSquaredError == FloatVector());
+      CHECK(result.psnr.x == INFINITY);
+      CHECK(result.ssim == FloatVector(1.0f, 1.0f, 1.0f, 1.0f));
+      CHECK(result.diffImage.empty());
+    }
+  };
+
+  SECTION("Block compressed texture compared to its decoded texels")
+  {
+    ResourceFormat bc1 = rgba8;
+    bc1.type = ResourceFormatType::BC1;
+
+    rdcarray<byte> blocks;
+    blocks.resize(SliceSize(bc1, width, height) * depth);
+    RandomTexels(blocks, 0xb1c);
+
+    rdcarray<FloatVector> decoded;
+    decoded.resize(count);
+    REQUIRE(DecodeBlockCompressed(bc1, blocks.data(), blocks.size(), width, height, depth,
+                                  rgba32f, (byte *)decoded.data(), NULL));
+
+    TextureComparison result;
+    REQUIRE(CompareTextureData(bc1, blocks.data(), blocks.size(), rgba32f,
+                               (const byte *)decoded.data(), count * sizeof(FloatVector), width,
+                               height, depth, 0.0f, false, result, &jobs));
+
+    CHECK(result.differingTexels == 0);
+    CHECK(result.maxAbsError == FloatVector());
+  };
+
+  SECTION("Different textures")
+  {
+    // perturb some of the texels, including a NaN
+    rdcarray<uint16_t> dataB;
+    dataB.resize(count * 4);
+    for(size_t i = 0; i < count; i++)
+    {
+      FloatVector v = texelsA[i];
+      if(i % 7 == 0)
+        v.x += 0.25f;
+      if(i % 11 == 0)
+        v.y = 0.0f;
+      if(i % 13 == 0)
+        v.z = -v.z;
+      if(i == 100)
+        v.w = NAN;
+      EncodeFormattedComponents(rgba16f, v, (byte *)&dataB[i * 4]);
+    }
+
+    // straightforward reference, with windows of 8x8 texels in each slice
+    uint64_t refDiffering = 0;
+    float refMaxAbs[4] = {}, refMaxRel[4] = {};
+    double refAbs[4] = {}, refSq[4] = {}, refSSIM[4] = {};
+    double windows = 0;
+    rdcarray<FloatVector> refDiff;
+    refDiff.resize(count);
+
+    const float threshold = 0.01f;
+
+    for(uint32_t z = 0; z < depth; z++)
+    {
+      for(uint32_t wy = 0; wy < height; wy += 8)
+      {
+        for(uint32_t wx = 0; wx < width; wx += 8)
+        {
+          double sa[4] = {}, sb[4] = {}, saa[4] = {}, sbb[4] = {}, sab[4] = {};
+          double n = 0;
+
+          for(uint32_t y = wy; y < RDCMIN(height, wy + 8); y++)
+          {
+            for(uint32_t x = wx; x < RDCMIN(width, wx + 8); x++)
+            {
+              const size_t i = (z * height + y) * width + x;
+              const FloatVector b = DecodeFormattedComponents(rgba16f, (byte *)&dataB[i * 4]);
+              bool differs = false;
+              n++;
+
+              for(int c = 0; c < 4; c++)
+              {
+                const float va = (&texelsA[i].x)[c], vb = (&b.x)[c];
+                const float ad = fabsf(va - vb);
+                (&refDiff[i].x)[c] = ad;
+
+                if(ad != ad)
+                {
+                  differs = true;
+                  continue;
+                }
+
+                differs |= ad > threshold;
+                refMaxAbs[c] = RDCMAX(refMaxAbs[c], ad);
+                if(va != 0.0f || vb != 0.0f)
+                  refMaxRel[c] = RDCMAX(refMaxRel[c], ad / RDCMAX(fabsf(va), fabsf(vb)));
+
+                refAbs[c] += ad;
+                refSq[c] += double(ad) * ad;
+                sa[c] += va;
+                sb[c] += vb;
+                saa[c] += double(va) * va;
+                sbb[c] += double(vb) * vb;
+                sab[c] += double(va) * vb;
+              }
+
+              refDiffering += differs ? 1 : 0;
+            }
+          }
+
+          for(int c = 0; c < 4; c++)
+          {
+            double ma = sa[c] / n, mb = sb[c] / n;
+            double varA = saa[c] / n - ma * ma, varB = sbb[c] / n - mb * mb;
+            double cov = sab[c] / n - ma * mb;
+            refSSIM[c] += ((2 * ma * mb + SSIMC1) * (2 * cov + SSIMC2)) /
+                          ((ma * ma + mb * mb + SSIMC1) * (varA + varB + SSIMC2));
+          }
+
+          windows++;
+        }
+      }
+    }
+
+    for(Threading::JobQueue *queue : {(Threading::JobQueue *)NULL, &jobs})
+    {
+      TextureComparison result;
+      REQUIRE(CompareTextureData(rgba8, dataA.data(), dataA.size(), rgba16f,
+                                 (const byte *)dataB.data(), dataB.size() * sizeof(uint16_t),
+                                 width, height, depth, threshold, true, result, queue));
+
+      CHECK(result.differingTexels == refDiffering);
+
+      for(int c = 0; c < 4; c++)
+      {
+        INFO("Channel " << c);
+
+        CHECK((&result.maxAbsError.x)[c] == refMaxAbs[c]);
+        CHECK((&result.maxRelError.x)[c] == refMaxRel[c]);
+
+        // the alpha channel has a NaN in it
+        if(c == 3)
+        {
+          CHECK(RDCISNAN(result.meanAbsError.w));
+          CHECK(RDCISNAN(result.ssim.w));
+          continue;
+        }
+
+        const double mse = refSq[c] / count;
+
+        CHECK((&result.meanAbsError.x)[c] == Approx(refAbs[c] / count));
+        CHECK((&result.meanSquaredError.x)[c] == Approx(mse));
+        CHECK((&result.psnr.x)[c] == Approx(10.0 * log10(1.0 / mse)));
+        CHECK((&result.ssim.x)[c] == Approx(refSSIM[c] / windows).epsilon(0.0001));
+      }
+
+      REQUIRE(result.diffImage.size() == count * sizeof(FloatVector));
+      const FloatVector *diff = (const FloatVector *)result.diffImage.data();
+      for(size_t i = 0; i < count; i++)
+        CHECK(memcmp(&diff[i], &refDiff[i], sizeof(FloatVector)) == 0);
+    }
+  };
+
+  SECTION("Invalid parameters")
+  {
+    TextureComparison result;
+
+    CHECK_FALSE(CompareTextureData(rgba8, dataA.data(), dataA.size() - 1, rgba8, dataA.data(),
+                                   dataA.size(), width, height, depth, 0.0f, false, result, NULL));
+    CHECK_FALSE(result.valid);
+
+    ResourceFormat astc = rgba8;
+    astc.type = ResourceFormatType::ASTC;
+    CHECK_FALSE(CompareTextureData(astc, dataA.data(), dataA.size(), rgba8, dataA.data(),
+                                   dataA.size(), 4, 4, 1, 0.0f, false, result, NULL));
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include "api/replay/control_types.h"
+
+namespace Threading
+{
+class JobQueue;
+};
+
+class IRemoteDriver;
+
+// CPU implementations of texture min/max and histogram calculation, giving the same results as the
+// GPU implementations in each driver. They work on one tightly packed subresource of fmt with the
+// given dimensions, as returned by GetTextureData with standardLayout set. Block-compressed
+// formats are supported if they can be decoded on the CPU.
+//
+// Texels are processed in parallel on jobs if it's not NULL. Returns false if the format can't be
+// decoded or there isn't enough data.
+bool CalcTextureMinMax(const ResourceFormat &fmt, const byte *data, size_t dataSize, uint32_t width,
+                       uint32_t height, uint32_t depth, float minval[4], float maxval[4],
+                       Threading::JobQueue *jobs);
+
+// the histogram has HGRAM_NUM_BUCKETS buckets evenly dividing [minval, maxval). Each enabled
+// channel of each texel is counted separately into the same buckets.
+bool CalcTextureHistogram(const ResourceFormat &fmt, const byte *data, size_t dataSize,
+                          uint32_t width, uint32_t height, uint32_t depth, float minval,
+                          float maxval, const bool channels[4], rdcarray<uint32_t> &histogram,
+                          Threading::JobQueue *jobs);
+
+// compares two textures of the same dimensions, which can be in different formats. Texels are
+// decoded to floats and compared per channel, see TextureComparison for the metrics calculated.
+// A texel counts as differing if any channel's absolute error is above threshold. If diffImage is
+// set, the per-channel absolute error for each texel is returned as RGBA32 float data.
+//
+// Texels are processed in parallel on jobs if it's not NULL. Returns false if either format can't
+// be decoded or there isn't enough data.
+bool CompareTextureData(const ResourceFormat &fmtA, const byte *dataA, size_t dataSizeA,
+                        const ResourceFormat &fmtB, const byte *dataB, size_t dataSizeB,
+                        uint32_t width, uint32_t height, uint32_t depth, float threshold,
+                        bool diffImage, TextureComparison &result, Threading::JobQueue *jobs);
+
+// fetches one subresource with GetTextureData for the functions above. typeCast is applied to the
+// returned format if the data can be decoded that way. 3D textures return the whole mip, with
+// depth set to the number of slices.
+bool FetchTextureStatisticsData(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                                CompType typeCast, bytebuf &data, ResourceFormat &fmt,
+                                uint32_t &width, uint32_t &height, uint32_t &depth);
+
+// drop-in replacements for IRemoteDriver::GetMinMax and GetHistogram which fetch the subresource
+// with GetTextureData and compute the results on the CPU, for when there's no GPU to do it.
+bool CPUGetMinMax(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                  CompType typeCast, float *minval, float *maxval);
+bool CPUGetHistogram(IRemoteDriver *driver, ResourceId texid, const Subresource &sub,
+                     CompType typeCast, float minval, float maxval, const bool channels[4],
+                     rdcarray<uint32_t> &histogram);
@@ -1669,6 +1669,7 @@ public:
                        ChunkAllocator *allocator = NULL);
 
   byte *GetData() const { return m_Data; }
+  uint64_t GetLength() const { return m_Length; }
   Chunk *Duplicate()
   {
     Chunk *ret = new Chunk();
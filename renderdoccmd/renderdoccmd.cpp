@@ -26,6 +26,7 @@
 #include "renderdoccmd.h"
 #include <app/renderdoc_app.h>
 #include <replay/version.h>
+#include <map>
 #include <string>
 
 rdcstr conv(const std::string &s)
@@ -825,6 +826,158 @@ public:
   }
 };
 
+struct ExportCommand : public Command
+{
+private:
+  std::string filename;
+  std::string pattern;
+  std::string format;
+  std::string nameFilter;
+  uint32_t eventId = 0;
+  int32_t mip = -1;
+  int32_t slice = -1;
+
+public:
+  ExportCommand() : Command() {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add<std::string>(
+        "out", 'o',
+        "The pattern for output filenames. {name}, {id}, {mip}, {slice} and {ext} are replaced "
+        "with the texture's name, ID, mip, slice and the file extension.",
+        false, "{name}_{id}_mip{mip}_slice{slice}.{ext}");
+    parser.add<std::string>("format", 'f', "The format of the output files.", false, "png",
+                            cmdline::oneof<std::string>("dds", "png", "jpg", "bmp", "tga", "hdr",
+                                                        "exr"));
+    parser.add<uint32_t>("event", 'e',
+                         "The event to export textures at. Default is 0, the last event.", false,
+                         0);
+    parser.add<int32_t>("mip", 0, "The mip to export, or -1 for all mips.", false, -1);
+    parser.add<int32_t>("slice", 0, "The array or depth slice to export, or -1 for all slices.",
+                        false, -1);
+    parser.add<std::string>("name", 'n', "Only export textures whose name contains this string.",
+                            false);
+  }
+  virtual const char *Description() { return "Export a capture's textures to image files."; }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual bool Parse(cmdline::parser &parser, GlobalEnvironment &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: export command requires a capture filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return false;
+    }
+
+    filename = rest[0];
+
+    rest.erase(rest.begin());
+
+    parser.set_rest(rest);
+
+    pattern = parser.get<std::string>("out");
+    format = parser.get<std::string>("format");
+    eventId = parser.get<uint32_t>("event");
+    mip = parser.get<int32_t>("mip");
+    slice = parser.get<int32_t>("slice");
+
+    if(parser.exist("name"))
+      nameFilter = parser.get<std::string>("name");
+
+    return true;
+  }
+  virtual int Execute(const CaptureOptions &)
+  {
+    FileType type = FileType::PNG;
+
+    if(format == "dds")
+      type = FileType::DDS;
+    else if(format == "jpg")
+      type = FileType::JPG;
+    else if(format == "bmp")
+      type = FileType::BMP;
+    else if(format == "tga")
+      type = FileType::TGA;
+    else if(format == "hdr")
+      type = FileType::HDR;
+    else if(format == "exr")
+      type = FileType::EXR;
+
+    ICaptureFile *file = RENDERDOC_OpenCaptureFile();
+
+    if(file->OpenFile(filename.c_str(), "rdc", NULL) != ReplayStatus::Succeeded)
+    {
+      std::cerr << "Couldn't load '" << filename << "'." << std::endl;
+      file->Shutdown();
+      return 1;
+    }
+
+    IReplayController *renderer = NULL;
+    ReplayStatus status = ReplayStatus::InternalError;
+    rdctie(status, renderer) = file->OpenCapture(ReplayOptions(), NULL);
+
+    file->Shutdown();
+
+    if(status != ReplayStatus::Succeeded)
+    {
+      std::cerr << "Couldn't load and replay '" << filename << "': " << ToStr(status) << std::endl;
+      return 1;
+    }
+
+    if(eventId == 0)
+    {
+      rdcarray<DrawcallDescription> draws = renderer->GetDrawcalls();
+
+      const DrawcallDescription *last = draws.empty() ? NULL : &draws.back();
+      while(last && !last->children.empty())
+        last = &last->children.back();
+
+      if(last)
+        eventId = last->eventId;
+    }
+
+    renderer->SetFrameEvent(eventId, true);
+
+    std::map<ResourceId, rdcstr> names;
+    for(const ResourceDescription &res : renderer->GetResources())
+      names[res.resourceId] = res.name;
+
+    rdcarray<TextureSave> saves;
+
+    for(const TextureDescription &tex : renderer->GetTextures())
+    {
+      if(!nameFilter.empty() && !names[tex.resourceId].contains(conv(nameFilter)))
+        continue;
+
+      TextureSave save;
+      save.resourceId = tex.resourceId;
+      save.destType = type;
+      save.mip = mip;
+      save.slice.sliceIndex = slice;
+      saves.push_back(save);
+    }
+
+    std::cout << "Exporting " << saves.size() << " textures from '" << filename << "' at event "
+              << eventId << "." << std::endl;
+
+    bool success = renderer->ExportResources(saves, pattern.c_str());
+
+    renderer->Shutdown();
+
+    if(!success)
+    {
+      std::cerr << "Some textures couldn't be exported, see the log for details." << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+};
+
 struct TestCommand : public Command
 {
 private:
@@ -1557,6 +1710,7 @@ int renderdoccmd(GlobalEnvironment &env, std::vector<std::string> &argv)
     add_command("capaltbit", new CapAltBitCommand());
     add_command("test", new TestCommand());
     add_command("convert", new ConvertCommand());
+    add_command("export", new ExportCommand());
     add_command("embed", new EmbeddedSectionCommand(false));
     add_command("extract", new EmbeddedSectionCommand(true));
 
@@ -1633,6 +1787,10 @@ int renderdoccmd(GlobalEnvironment &env, std::vector<std::string> &argv)
               "Capturing Option: Include all live resources, not just those used by a frame.");
       cmd.add("opt-capture-all-cmd-lists", 0,
               "Capturing Option: In D3D11, record all command lists from application start.");
+      cmd.add<int>("opt-capture-size-budget", 0,
+                   "Capturing Option: Soft limit in MB on the capture size, dropping the largest "
+                   "resource contents to fit. 0 for no limit.",
+                   false, 0, cmdline::range(0, 1024 * 1024));
     }
 
     cmd.parse_check(argv, true);
@@ -1664,6 +1822,7 @@ int renderdoccmd(GlobalEnvironment &env, std::vector<std::string> &argv)
         opts.captureAllCmdLists = true;
 
       opts.delayForDebugger = (uint32_t)cmd.get<int>("opt-delay-for-debugger");
+      opts.captureSizeBudgetMB = (uint32_t)cmd.get<int>("opt-capture-size-budget");
     }
 
     if(!it->second->HandlesUsageManually() && cmd.exist("help"))